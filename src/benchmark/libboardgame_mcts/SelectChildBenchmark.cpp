@@ -0,0 +1,120 @@
+//-----------------------------------------------------------------------------
+/** @file benchmark/libboardgame_mcts/SelectChildBenchmark.cpp
+    Compares the child selection functions in libboardgame_mcts/SelectChild.h
+    for different numbers of children.
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include "libboardgame_mcts/Node.h"
+#include "libboardgame_mcts/SelectChild.h"
+#include "libboardgame_util/RandomGenerator.h"
+#include "libboardgame_util/Timer.h"
+#include "libboardgame_util/WallTimeSource.h"
+
+using namespace std;
+using libboardgame_mcts::select_child;
+using libboardgame_mcts::select_child_scalar;
+using libboardgame_mcts::select_child_simd;
+using libboardgame_util::RandomGenerator;
+using libboardgame_util::Timer;
+using libboardgame_util::WallTimeSource;
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+typedef libboardgame_mcts::Node<int, float, true> Node;
+
+/** Minimum count of a child as in libpentobi_mcts::SearchParamConst. */
+const float child_min_count = 3;
+
+/** Exploration constant as used by libpentobi_mcts::Search. */
+const float exploration_constant = 0.014f;
+
+const float parent_count = 10000;
+
+/** Prevents the compiler from removing the measured calls. */
+const Node* volatile result;
+
+/** Initialize children with statistics similar to the ones of a node in a
+    search tree: most children keep their prior knowledge initialization and
+    a few children get most of the visits. */
+void init_children(Node* nodes, unsigned nu_children, RandomGenerator& random)
+{
+    for (unsigned i = 0; i < nu_children; ++i)
+    {
+        float count = child_min_count + random.generate_float(0, 5);
+        if (random.generate_float(0, 1) < 0.05f)
+            count += random.generate_float(0, parent_count / 10);
+        nodes[i].init(0, random.generate_float(0.2f, 0.8f), count);
+    }
+}
+
+template<class F>
+double measure(F select, unsigned nu_calls)
+{
+    WallTimeSource time_source;
+    Timer timer(time_source);
+    for (unsigned i = 0; i < nu_calls; ++i)
+        result = select();
+    return timer() / nu_calls * 1e9;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+int main()
+{
+#if defined __AVX__
+    cout << "Using AVX\n";
+#elif defined __SSE2__
+    cout << "Using SSE2\n";
+#else
+    cout << "Using scalar fallback\n";
+#endif
+    RandomGenerator random;
+    random.set_seed(1);
+    float bias_factor = exploration_constant * sqrt(parent_count);
+    float bias_limit = bias_factor / child_min_count;
+    cout << setw(8) << "Children" << setw(12) << "Limit[ns]"
+         << setw(12) << "Scalar[ns]" << setw(12) << "Simd[ns]"
+         << setw(10) << "Speedup" << setw(7) << "Same" << '\n'
+         << fixed;
+    for (unsigned nu_children : { 8, 20, 50, 100, 500, 1000, 5000, 20000 })
+    {
+        unique_ptr<Node[]> nodes(new Node[nu_children]);
+        init_children(nodes.get(), nu_children, random);
+        auto begin = nodes.get();
+        auto end = begin + nu_children;
+        auto nu_calls = max(1000u, 20000000u / nu_children);
+        auto time_limit = measure([&] {
+            return select_child(begin, end, bias_factor, bias_limit); },
+            nu_calls);
+        auto time_scalar = measure([&] {
+            return select_child_scalar(begin, end, bias_factor); }, nu_calls);
+        auto time_simd = measure([&] {
+            return select_child_simd(begin, end, bias_factor, bias_limit); },
+            nu_calls);
+        bool is_same =
+                (select_child_simd(begin, end, bias_factor, bias_limit)
+                 == select_child(begin, end, bias_factor, bias_limit));
+        cout << setw(8) << nu_children
+             << setprecision(1) << setw(12) << time_limit
+             << setw(12) << time_scalar << setw(12) << time_simd
+             << setprecision(2) << setw(10) << time_limit / time_simd
+             << setw(7) << (is_same ? "yes" : "no") << '\n';
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,166 @@
+//-----------------------------------------------------------------------------
+/** @file benchmark/libboardgame_sgf/ReaderBenchmark.cpp
+    Measures reading a collection of SGF game trees of several MB, like the
+    result files of twogtp, with an event-only Reader from a mapped file and
+    from a stream, and with TreeReader.
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include "libboardgame_sgf/TreeReader.h"
+#include "libboardgame_sys/MappedFile.h"
+#include "libboardgame_util/RandomGenerator.h"
+#include "libboardgame_util/Timer.h"
+#include "libboardgame_util/Unused.h"
+#include "libboardgame_util/WallTimeSource.h"
+
+using namespace std;
+using libboardgame_sgf::Reader;
+using libboardgame_sgf::TreeReader;
+using libboardgame_sys::MappedFile;
+using libboardgame_util::RandomGenerator;
+using libboardgame_util::StringView;
+using libboardgame_util::Timer;
+using libboardgame_util::WallTimeSource;
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+const unsigned nu_games = 5000;
+
+const unsigned nu_moves = 80;
+
+const char* filename = "benchmark_libboardgame_sgf.blksgf";
+
+/** Reader that only counts the properties. */
+class CountReader
+    : public Reader
+{
+public:
+    size_t nu_values = 0;
+
+    void on_property(StringView id, const vector<StringView>& values) override
+    {
+        LIBBOARDGAME_UNUSED(id);
+        nu_values += values.size();
+    }
+};
+
+string get_point(RandomGenerator& random)
+{
+    ostringstream s;
+    s << char('a' + random.generate() % 20) << (1 + random.generate() % 20);
+    return s.str();
+}
+
+/** Write games with moves in the format of the Blokus SGF files and some
+    comments, which need to be unescaped in the reader. */
+void write_games(ostream& out)
+{
+    RandomGenerator random;
+    for (unsigned i = 0; i < nu_games; ++i)
+    {
+        out << "(;FF[4]CA[UTF-8]GM[Blokus]AP[twogtp]\n"
+            << "PB[Pentobi]PW[Pentobi]RE[B+" << random.generate() % 30
+            << "]GN[" << i << "]\n";
+        for (unsigned j = 0; j < nu_moves; ++j)
+        {
+            out << ';' << "BYRG"[j % 4] << '[';
+            for (unsigned k = 0; k < 5; ++k)
+                out << (k > 0 ? "," : "") << get_point(random);
+            out << ']';
+            if (j % 10 == 0)
+                out << "C[Value: 0.51\\]\nCount: 1234]";
+            out << '\n';
+        }
+        out << ")\n";
+    }
+}
+
+template<class R>
+double read_mapped(R& reader, size_t& nu_trees)
+{
+    WallTimeSource time_source;
+    Timer timer(time_source);
+    MappedFile file;
+    if (! file.open(filename))
+        throw runtime_error("could not open file");
+    const char* pos = file.get_data();
+    const char* end = pos + file.get_size();
+    nu_trees = 1;
+    while (reader.read(pos, end, false))
+        ++nu_trees;
+    return timer();
+}
+
+template<class R>
+double read_stream(R& reader, size_t& nu_trees)
+{
+    WallTimeSource time_source;
+    Timer timer(time_source);
+    ifstream in(filename);
+    nu_trees = 1;
+    while (reader.read(in, false))
+        ++nu_trees;
+    return timer();
+}
+
+void print(const char* name, double time, size_t nu_trees, size_t size)
+{
+    cout << setw(22) << left << name << right << fixed << setprecision(1)
+         << setw(8) << time * 1000 << " ms " << setw(8)
+         << size / time * 1e-6 << " MB/s (" << nu_trees << " trees)\n";
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+int main()
+{
+    try
+    {
+        {
+            ofstream out(filename);
+            write_games(out);
+        }
+        size_t size;
+        {
+            MappedFile file;
+            file.open(filename);
+            size = file.get_size();
+        }
+        cout << "File size: " << size / 1000 << " kB\n";
+        size_t nu_trees;
+        CountReader count_reader;
+        auto time = read_mapped(count_reader, nu_trees);
+        print("Reader, mapped file", time, nu_trees, size);
+        time = read_stream(count_reader, nu_trees);
+        print("Reader, stream", time, nu_trees, size);
+        TreeReader tree_reader;
+        time = read_mapped(tree_reader, nu_trees);
+        print("TreeReader, mapped file", time, nu_trees, size);
+        time = read_stream(tree_reader, nu_trees);
+        print("TreeReader, stream", time, nu_trees, size);
+        remove(filename);
+        return 0;
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << '\n';
+        remove(filename);
+        return 1;
+    }
+}
+
+//-----------------------------------------------------------------------------
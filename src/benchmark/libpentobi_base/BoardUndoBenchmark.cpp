@@ -0,0 +1,133 @@
+//-----------------------------------------------------------------------------
+/** @file benchmark/libpentobi_base/BoardUndoBenchmark.cpp
+    Compares taking back the moves of a simulation with
+    Board::restore_snapshot(), as done in libpentobi_mcts::State, and with
+    Board::undo() for different game variants and numbers of moves.
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "libpentobi_base/Board.h"
+#include "libpentobi_base/MoveMarker.h"
+#include "libboardgame_util/RandomGenerator.h"
+#include "libboardgame_util/Timer.h"
+#include "libboardgame_util/WallTimeSource.h"
+
+using namespace std;
+using libboardgame_util::RandomGenerator;
+using libboardgame_util::Timer;
+using libboardgame_util::WallTimeSource;
+using libpentobi_base::Board;
+using libpentobi_base::ColorMove;
+using libpentobi_base::MoveList;
+using libpentobi_base::MoveMarker;
+using libpentobi_base::Variant;
+using libpentobi_base::to_string_id;
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+/** Number of moves played before the snapshot is taken. */
+const unsigned nu_opening_moves = 8;
+
+/** Number of times each sequence is played and taken back. */
+const unsigned nu_repetitions = 20000;
+
+volatile unsigned result;
+
+/** Play random legal moves, such that the same sequence can be replayed
+    in each repetition. */
+vector<ColorMove> get_sequence(Board& bd, unsigned nu_moves,
+                               RandomGenerator& random)
+{
+    MoveMarker marker;
+    MoveList moves;
+    vector<ColorMove> sequence;
+    unsigned nu_passes = 0;
+    while (sequence.size() < nu_moves && nu_passes < bd.get_nu_colors())
+    {
+        auto c = bd.get_to_play();
+        bd.gen_moves(c, marker, moves);
+        marker.clear(moves);
+        if (moves.empty())
+        {
+            bd.set_to_play(bd.get_next(c));
+            ++nu_passes;
+            continue;
+        }
+        nu_passes = 0;
+        auto mv = moves[random.generate() % moves.size()];
+        bd.play(c, mv);
+        sequence.push_back(ColorMove(c, mv));
+    }
+    return sequence;
+}
+
+template<class F>
+double measure(F f)
+{
+    WallTimeSource time_source;
+    Timer timer(time_source);
+    for (unsigned i = 0; i < nu_repetitions; ++i)
+        f();
+    return timer() / nu_repetitions * 1e9;
+}
+
+void run(Variant variant, RandomGenerator& random)
+{
+    auto bd = make_unique<Board>(variant);
+    get_sequence(*bd, nu_opening_moves, random);
+    for (unsigned nu_moves : { 1, 4, 16, 64 })
+    {
+        bd->take_snapshot();
+        auto sequence = get_sequence(*bd, nu_moves, random);
+        bd->restore_snapshot();
+        auto time_undo = measure([&] {
+            for (auto& mv : sequence)
+                bd->play_undoable(mv.color, mv.move);
+            result = bd->get_nu_moves();
+            while (bd->get_nu_undoable() > 0)
+                bd->undo();
+        });
+        auto time_snapshot = measure([&] {
+            for (auto& mv : sequence)
+                bd->play(mv);
+            result = bd->get_nu_moves();
+            bd->restore_snapshot();
+        });
+        cout << setw(12) << to_string_id(variant)
+             << setw(7) << sequence.size()
+             << setw(14) << time_snapshot << setw(12) << time_undo
+             << setw(10) << time_snapshot / time_undo << '\n';
+    }
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+int main()
+{
+    RandomGenerator random;
+    random.set_seed(1);
+    cout << setw(12) << "Variant" << setw(7) << "Moves"
+         << setw(14) << "Snapshot[ns]" << setw(12) << "Undo[ns]"
+         << setw(10) << "Speedup" << '\n'
+         << fixed << setprecision(1);
+    for (auto variant : { Variant::duo, Variant::classic, Variant::trigon,
+                          Variant::nexos, Variant::callisto,
+                          Variant::gembloq })
+        run(variant, random);
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,293 @@
+//-----------------------------------------------------------------------------
+/** @file libboardgame_mcts/CompactNode.h
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifndef LIBBOARDGAME_MCTS_COMPACT_NODE_H
+#define LIBBOARDGAME_MCTS_COMPACT_NODE_H
+
+#include <cstring>
+#include <type_traits>
+#include "Node.h"
+
+namespace libboardgame_mcts {
+
+using namespace std;
+
+//-----------------------------------------------------------------------------
+
+/** %Node in a MCTS tree with reduced-precision statistics.
+    Has the same interface as Node but needs less memory (16 instead of 20
+    bytes with float and 16-bit moves), so more nodes fit into the memory
+    of the tree. The memory saving has the following costs:
+    - The value is quantized to 16 bits in [value_min, value_max] (a
+      resolution of about 5e-5). Values outside the interval are clamped.
+      Because the mean value of a node with a high count changes by less
+      than the resolution during an update, the quantization uses
+      stochastic rounding, so the value stays unbiased on average, but has
+      an additional noise of up to one quantization step.
+    - The visit count and the value count share the same field. The visit
+      count therefore includes the prior knowledge count and RAVE
+      updates, so thresholds based on the visit count (node expansion,
+      pruning) are reached earlier. The search must not call
+      inc_visit_count() for nodes on which it calls add_value().
+    @see SearchParamConstDefault::compact_node */
+template<typename M, typename F, bool MT>
+class CompactNode
+{
+public:
+    typedef M Move;
+
+    typedef F Float;
+
+    static const bool is_compact = true;
+
+    static constexpr Float value_min = -1;
+
+    static constexpr Float value_max = 2;
+
+    CompactNode() = default;
+
+    CompactNode(const CompactNode&) = delete;
+
+    CompactNode& operator=(const CompactNode&) = delete;
+
+    /** See Node::init() */
+    void init(const Move& mv, Float value, Float count);
+
+    /** See Node::init_root() */
+    void init_root();
+
+    const Move& get_move() const;
+
+    /** Same as get_value_count(). */
+    Float get_visit_count() const;
+
+    Float get_value_count() const;
+
+    Float get_value() const;
+
+    bool has_children() const;
+
+    unsigned short get_nu_children() const;
+
+    void copy_data_from(const CompactNode& node);
+
+    void link_children(NodeIdx first_child, unsigned short nu_children);
+
+    void link_children_st(NodeIdx first_child, unsigned short nu_children);
+
+    void unlink_children();
+
+    void unlink_children_st();
+
+    void add_value(Float v, Float weight = 1);
+
+    void add_value_remove_loss(Float v);
+
+    /** Increment the shared count.
+        Only used for the root node, for which add_value() is not called. */
+    void inc_visit_count();
+
+    NodeIdx get_first_child() const;
+
+private:
+    static constexpr Float scale = 65535 / (value_max - value_min);
+
+    Atomic<Float, MT> m_count;
+
+    Atomic<uint16_t, MT> m_value;
+
+    Atomic<unsigned short, MT> m_nu_children;
+
+    Move m_move;
+
+    NodeIdx m_first_child;
+
+    static uint16_t quantize(Float value, Float count);
+};
+
+template<typename M, typename F, bool MT>
+constexpr F CompactNode<M, F, MT>::value_min;
+
+template<typename M, typename F, bool MT>
+constexpr F CompactNode<M, F, MT>::value_max;
+
+template<typename M, typename F, bool MT>
+void CompactNode<M, F, MT>::add_value(Float v, Float weight)
+{
+    // Intentionally uses no synchronization and does not care about
+    // lost updates in multi-threaded mode
+    Float count = m_count.load(memory_order_relaxed);
+    Float value = get_value();
+    count += weight;
+    value += weight * (v - value) / count;
+    m_value.store(quantize(value, count), memory_order_relaxed);
+    m_count.store(count, memory_order_relaxed);
+}
+
+template<typename M, typename F, bool MT>
+void CompactNode<M, F, MT>::add_value_remove_loss(Float v)
+{
+    // Intentionally uses no synchronization and does not care about
+    // lost updates in multi-threaded mode
+    Float count = m_count.load(memory_order_relaxed);
+    if (count == 0)
+        return; // Adding the virtual loss was lost
+    Float value = get_value();
+    value += v / count;
+    m_value.store(quantize(value, count), memory_order_relaxed);
+}
+
+template<typename M, typename F, bool MT>
+void CompactNode<M, F, MT>::copy_data_from(const CompactNode& node)
+{
+    m_move = node.m_move;
+    m_count.store(node.m_count.load(memory_order_relaxed),
+                  memory_order_relaxed);
+    m_value.store(node.m_value.load(memory_order_relaxed),
+                  memory_order_relaxed);
+}
+
+template<typename M, typename F, bool MT>
+inline NodeIdx CompactNode<M, F, MT>::get_first_child() const
+{
+    LIBBOARDGAME_ASSERT(has_children());
+    return m_first_child;
+}
+
+template<typename M, typename F, bool MT>
+inline auto CompactNode<M, F, MT>::get_move() const -> const Move&
+{
+    return m_move;
+}
+
+template<typename M, typename F, bool MT>
+inline unsigned short CompactNode<M, F, MT>::get_nu_children() const
+{
+    return m_nu_children.load(memory_order_acquire);
+}
+
+template<typename M, typename F, bool MT>
+inline auto CompactNode<M, F, MT>::get_value() const -> Float
+{
+    return value_min + m_value.load(memory_order_relaxed) / scale;
+}
+
+template<typename M, typename F, bool MT>
+inline auto CompactNode<M, F, MT>::get_value_count() const -> Float
+{
+    return m_count.load(memory_order_relaxed);
+}
+
+template<typename M, typename F, bool MT>
+inline auto CompactNode<M, F, MT>::get_visit_count() const -> Float
+{
+    return m_count.load(memory_order_relaxed);
+}
+
+template<typename M, typename F, bool MT>
+inline bool CompactNode<M, F, MT>::has_children() const
+{
+    return get_nu_children() > 0;
+}
+
+template<typename M, typename F, bool MT>
+inline void CompactNode<M, F, MT>::inc_visit_count()
+{
+    Float count = m_count.load(memory_order_relaxed);
+    ++count;
+    m_count.store(count, memory_order_relaxed);
+}
+
+template<typename M, typename F, bool MT>
+void CompactNode<M, F, MT>::init(const Move& mv, Float value, Float count)
+{
+    // See comment in Node::init()
+    m_move = mv;
+    m_count.store(count, memory_order_relaxed);
+    m_value.store(quantize(value, count), memory_order_relaxed);
+    m_nu_children.store(0, memory_order_relaxed);
+}
+
+template<typename M, typename F, bool MT>
+void CompactNode<M, F, MT>::init_root()
+{
+#if LIBBOARDGAME_DEBUG
+    m_move = Move::null();
+#endif
+    m_count.store(0, memory_order_relaxed);
+    m_nu_children.store(0, memory_order_relaxed);
+}
+
+template<typename M, typename F, bool MT>
+inline void CompactNode<M, F, MT>::link_children(NodeIdx first_child,
+                                                 unsigned short nu_children)
+{
+    LIBBOARDGAME_ASSERT(nu_children < Move::range);
+    LIBBOARDGAME_ASSERT(first_child != 0);
+    m_first_child = first_child;
+    m_nu_children.store(nu_children, memory_order_release);
+}
+
+template<typename M, typename F, bool MT>
+inline void CompactNode<M, F, MT>::link_children_st(
+        NodeIdx first_child, unsigned short nu_children)
+{
+    LIBBOARDGAME_ASSERT(nu_children < Move::range);
+    LIBBOARDGAME_ASSERT(first_child != 0);
+    m_first_child = first_child;
+    m_nu_children.store(nu_children, memory_order_relaxed);
+}
+
+/** Convert a value into the 16-bit representation.
+    The fractional part is rounded up with a probability equal to its size.
+    The random number is derived from the bits of the count, which changes
+    with each update of a node, so no random generator is needed. */
+template<typename M, typename F, bool MT>
+uint16_t CompactNode<M, F, MT>::quantize(Float value, Float count)
+{
+    Float x = (value - value_min) * scale;
+    if (! (x > 0))
+        return 0;
+    if (x >= 65535)
+        return 65535;
+    auto result = static_cast<uint16_t>(x);
+    uint64_t bits = 0;
+    memcpy(&bits, &count, sizeof(count));
+    bits *= 0x9e3779b97f4a7c15;
+    auto random = static_cast<Float>(bits >> 40) * (Float(1) / (1 << 24));
+    if (x - result > random)
+        ++result;
+    return result;
+}
+
+template<typename M, typename F, bool MT>
+inline void CompactNode<M, F, MT>::unlink_children()
+{
+    m_nu_children.store(0, memory_order_release);
+}
+
+template<typename M, typename F, bool MT>
+inline void CompactNode<M, F, MT>::unlink_children_st()
+{
+    m_nu_children.store(0, memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+
+/** The node type of a search with move type M and compile-time parameters
+    R.
+    See SearchParamConstDefault::compact_node. */
+template<typename M, class R>
+using SearchNode = typename conditional<
+    R::compact_node,
+    CompactNode<M, typename R::Float, R::multithread>,
+    Node<M, typename R::Float, R::multithread>>::type;
+
+//-----------------------------------------------------------------------------
+
+} // namespace libboardgame_mcts
+
+#endif // LIBBOARDGAME_MCTS_COMPACT_NODE_H
@@ -32,6 +32,9 @@ public:
 
     typedef F Float;
 
+    /** See CompactNode */
+    static const bool is_compact = false;
+
     Node() = default;
 
     Node(const Node&) = delete;
@@ -70,6 +73,13 @@ public:
         of view of the player at the parent node. */
     Float get_value() const;
 
+    /** Get the address of the value, which is followed by the value count.
+        Allows to load both with a single (e.g. SIMD) instruction. The load
+        is not atomic but with relaxed memory order on all relevant
+        platforms, the values are not read differently by get_value() and
+        get_value_count() anyway. */
+    const Float* get_value_ptr() const;
+
     bool has_children() const;
 
     unsigned short get_nu_children() const;
@@ -202,6 +212,13 @@ inline auto Node<M, F, MT>::get_value() const -> Float
     return m_value.load(memory_order_relaxed);
 }
 
+template<typename M, typename F, bool MT>
+inline auto Node<M, F, MT>::get_value_ptr() const -> const Float*
+{
+    static_assert(sizeof(Atomic<Float, MT>) == sizeof(Float), "");
+    return reinterpret_cast<const Float*>(&m_value);
+}
+
 template<typename M, typename F, bool MT>
 inline auto Node<M, F, MT>::get_visit_count() const -> Float
 {
@@ -8,41 +8,43 @@
 #define LIBBOARDGAME_MCTS_SEARCH_BASE_H
 
 #include <array>
-#include <condition_variable>
 #include <functional>
 #include <mutex>
-#include <thread>
 #include "Atomic.h"
+#include "CompactNode.h"
 #include "LastGoodReply.h"
 #include "PlayerMove.h"
+#include "SelectChild.h"
 #include "Tree.h"
 #include "TreeUtil.h"
 #include "libboardgame_util/Abort.h"
 #include "libboardgame_util/ArrayList.h"
-#include "libboardgame_util/Barrier.h"
 #include "libboardgame_util/IntervalChecker.h"
 #include "libboardgame_util/Log.h"
 #include "libboardgame_util/MathUtil.h"
 #include "libboardgame_util/Statistics.h"
 #include "libboardgame_util/StringUtil.h"
+#include "libboardgame_util/ThreadPool.h"
 #include "libboardgame_util/TimeIntervalChecker.h"
 #include "libboardgame_util/Timer.h"
 #include "libboardgame_util/Unused.h"
+#include "libboardgame_sys/CpuAffinity.h"
 
 namespace libboardgame_mcts {
 
 using namespace std;
 using libboardgame_mcts::tree_util::find_node;
+using libboardgame_sys::ScopedThreadAffinity;
 using libboardgame_util::get_abort;
 using libboardgame_util::time_to_string;
 using libboardgame_util::to_string;
 using libboardgame_util::ArrayList;
-using libboardgame_util::Barrier;
 using libboardgame_util::IntervalChecker;
 using libboardgame_util::RandomGenerator;
 using libboardgame_util::StatisticsBase;
 using libboardgame_util::StatisticsDirtyLockFree;
 using libboardgame_util::StatisticsExt;
+using libboardgame_util::ThreadPool;
 using libboardgame_util::Timer;
 using libboardgame_util::TimeIntervalChecker;
 using libboardgame_util::TimeSource;
@@ -104,6 +106,29 @@ struct SearchParamConstDefault
         See implementation of check_cannot_change(). */
     static const bool use_unlikely_change = true;
 
+    /** Compute the UCT values of the children with SIMD instructions.
+        If enabled, select_child_simd() computes the bias terms of all
+        children in batches instead of skipping the bias term computation for
+        children whose value is too low to be selected (see select_child()).
+        This is faster if nodes have many children and is only used for
+        nodes with at least 32 children. The selected child is the same,
+        apart from rounding effects in the skip condition of the scalar
+        version. */
+    static const bool simd_select_child = false;
+
+    /** Use CompactNode instead of Node for the nodes of the tree.
+        CompactNode stores the value with 16 bits and shares the count
+        between value count and visit count, which reduces the node size
+        from 20 to 16 bytes (with float), so about 25% more nodes fit into
+        the same memory. The accuracy of the node values is reduced (see
+        CompactNode), and because the visit count includes the prior
+        knowledge and RAVE counts, the search expands and keeps nodes
+        earlier, which makes the search slower and uses some of the saved
+        memory, and the count-based selection of the best move is affected
+        by the prior knowledge. select_child_simd() is not used with compact
+        nodes. */
+    static const bool compact_node = false;
+
     /** The minimum count used in prior knowledge initialization of
         the children of an expanded node.
         The value must be greater 0 (it may be a positive epsilon) because
@@ -154,7 +179,13 @@ struct SearchParamConstDefault
     @tparam S The game-dependent state of a simulation. The state provides
     functions for move generation, evaluation of terminal positions, etc. The
     state should be thread-safe to support multiple states if multi-threading
-    is used.
+    is used. If transpositions are used (see set_use_transpositions()), the
+    state needs to provide a function get_hash() that returns a 64-bit hash of
+    the current position. The state provides a function with_param(f) that
+    calls f with an object of a compile-time parameter type, which the search
+    passes to the functions of the state that play or generate moves. This
+    allows the state to specialize the simulation for a game variant with a
+    single dispatch per search.
     @tparam M The move type. The type must be convertible to an integer by
     providing M::to_int() and M::range.
     @tparam R Optional compile-time parameters, see SearchParamConstDefault */
@@ -172,7 +203,7 @@ public:
 
     typedef typename SearchParamConst::Float Float;
 
-    typedef libboardgame_mcts::Node<M, Float, multithread> Node;
+    typedef SearchNode<M, SearchParamConst> Node;
 
     typedef libboardgame_mcts::Tree<Node> Tree;
 
@@ -188,9 +219,16 @@ public:
     static_assert(! SearchParamConst::use_lgr || lgr_hash_table_size > 0, "");
 
 
+    /** Maximum number of threads.
+        Thread 0 runs in the thread that calls search(), the others need a
+        worker of the ThreadPool. */
+    static const unsigned max_threads = ThreadPool::max_workers + 1;
+
+
     /** Constructor.
-        @param nu_threads
-        @param memory The memory to be used for (all) the search trees. */
+        @param nu_threads The number of threads. Reduced to max_threads if
+        larger.
+        @param memory The memory to be used for the search tree. */
     SearchBase(unsigned nu_threads, size_t memory);
 
     virtual ~SearchBase();
@@ -258,6 +296,42 @@ public:
 
     bool get_reuse_tree() const;
 
+    /** Share the children of nodes of transposed positions.
+        If enabled, the search tree becomes a directed acyclic graph. Nodes
+        whose positions can be reached by different move sequences link to the
+        same children, such that the children statistics are shared and
+        identical positions are not expanded several times. The search will
+        use the first children that were expanded for a position, so the
+        prior knowledge initialization of the children should not depend on
+        the move sequence. Changing this parameter clears the search tree.
+        If the tree becomes full in this mode, all threads are stopped for
+        pruning the tree. */
+    void set_use_transpositions(bool enable);
+
+    bool get_use_transpositions() const;
+
+    /** Use huge pages for the node storage of the search tree if possible.
+        Changing this parameter reallocates the tree memory and clears the
+        search tree. The pages actually obtained are reported by
+        get_info_ext(). */
+    void set_use_huge_pages(bool enable);
+
+    bool get_use_huge_pages() const;
+
+    /** Bind the search threads to CPUs.
+        The thread with index i is bound to cpus[i % cpus.size()] at the start
+        of each search. Thread 0 is the thread that calls search(), the other
+        threads are bound while a worker of the ThreadPool runs them. The
+        previous affinity of the threads is restored when the search or the
+        task ends, so other searches and other users of the pool are not
+        affected.
+        Because each thread initializes its own part of the tree storage,
+        binding also keeps the nodes of a thread on the NUMA node of its CPU.
+        An empty vector (default) does not bind the threads. */
+    void set_cpus(const vector<unsigned>& cpus);
+
+    const vector<unsigned>& get_cpus() const { return m_cpus; }
+
     /** Maximum parent visit count for applying RAVE. */
     void set_rave_parent_max(Float n);
 
@@ -291,6 +365,8 @@ public:
 
     const Tree& get_tree() const;
 
+    unsigned get_nu_threads() const { return m_nu_threads; }
+
 #if LIBBOARDGAME_DEBUG
     string dump() const;
 #endif
@@ -329,7 +405,10 @@ public:
         of a subtree reused from the previous search. */
     Float get_root_visit_count() const;
 
-    /** Create the threads used in the search.
+    /** Create the states of the threads used in the search.
+        The threads themselves are workers of the global ThreadPool, which
+        are shared with other searches; this function only ensures that the
+        pool has enough workers.
         This cannot be done in the constructor because it uses the virtual
         function create_state(). This function will automatically be called
         before a search if the threads have not been constructed yet, but it
@@ -375,7 +454,7 @@ private:
         unsigned thread_id;
 
         /** Was the search in this thread terminated because the search tree
-            was full? */
+            was full and could not be pruned concurrently? */
         bool is_out_of_mem;
 
         Simulation simulation;
@@ -395,55 +474,6 @@ private:
         ~ThreadState();
     };
 
-    /** Thread in the parallel search.
-        The thread waits for a call to start_search(), then runs
-        SearchBase::search_loop()) with the thread-specific search state.
-        After start_search(), wait_search_finished() needs to called before
-        calling start_search() again or destructing this object. */
-    class Thread
-    {
-    public:
-        typedef function<void(ThreadState&)> SearchFunc;
-
-        ThreadState thread_state;
-
-        explicit Thread(SearchFunc& search_func);
-
-        ~Thread();
-
-        void run();
-
-        void start_search();
-
-        void wait_search_finished();
-
-    private:
-        SearchFunc m_search_func;
-
-        bool m_quit = false;
-
-        bool m_start_search_flag = false;
-
-        bool m_search_finished_flag = false;
-
-        Barrier m_thread_ready{2};
-
-        mutex m_start_search_mutex;
-
-        mutex m_search_finished_mutex;
-
-        condition_variable m_start_search_cond;
-
-        condition_variable m_search_finished_cond;
-
-        unique_lock<mutex> m_search_finished_lock{m_search_finished_mutex,
-                                                  defer_lock};
-
-        thread m_thread;
-
-        void thread_main();
-    };
-
 
     /** @name Members that are used concurrently by all threads during the
         lock-free multi-threaded search */
@@ -470,6 +500,11 @@ private:
 
     bool m_reuse_tree = false;
 
+    bool m_use_transpositions = false;
+
+    /** See set_cpus(). */
+    vector<unsigned> m_cpus;
+
     /** Player to play at the root node of the search. */
     PlayerInt m_player;
 
@@ -505,9 +540,19 @@ private:
 
     Timer m_timer;
 
-    vector<unique_ptr<Thread>> m_threads;
+    /** States of the search threads.
+        The thread with index 0 is the thread that calls search(), the
+        others run as tasks in the global ThreadPool. */
+    vector<unique_ptr<ThreadState>> m_threads;
+
+    /** Tasks of the threads with index greater 0 in the current search. */
+    ThreadPool::TaskGroup m_tasks;
+
+    /** Minimum count of nodes that keep their children in prune(). */
+    Float m_prune_min_count;
 
-    Tree m_tmp_tree;
+    /** Ensures that only one thread prunes the tree at a time. */
+    mutex m_prune_mutex;
 
 #if LIBBOARDGAME_DEBUG
     AssertionHandler m_assertion_handler;
@@ -523,6 +568,9 @@ private:
     LIBBOARDGAME_NOINLINE
     bool check_abort_expensive(ThreadState& thread_state) const;
 
+    bool bind_thread(const ThreadState& thread_state,
+                     ScopedThreadAffinity& affinity) const;
+
     bool check_cannot_change(ThreadState& thread_state, Float remaining) const;
 
     bool estimate_reused_root_val(Tree& tree, const Node& root, Float& value,
@@ -531,15 +579,19 @@ private:
     bool expand_node(ThreadState& thread_state, const Node& node,
                      const Node*& best_child);
 
-    void playout(ThreadState& thread_state);
+    template<class P>
+    void playout(ThreadState& thread_state, P param);
 
-    void play_in_tree(ThreadState& thread_state);
+    template<class P>
+    void play_in_tree(ThreadState& thread_state, P param);
 
-    bool prune(TimeSource& time_source, double time, Float prune_min_count,
-               Float& new_prune_min_count);
+    void prune(ThreadState& thread_state);
 
     void search_loop(ThreadState& thread_state);
 
+    template<class P>
+    void search_loop(ThreadState& thread_state, P param);
+
     const Node* select_child(const Node& node);
 
     void update_lgr(ThreadState& thread_state);
@@ -553,75 +605,6 @@ private:
 template<class S, class M, class R>
 SearchBase<S, M, R>::ThreadState::~ThreadState() = default;
 
-template<class S, class M, class R>
-SearchBase<S, M, R>::Thread::Thread(SearchFunc& search_func)
-    : m_search_func(search_func)
-{ }
-
-template<class S, class M, class R>
-SearchBase<S, M, R>::Thread::~Thread()
-{
-    if (! m_thread.joinable())
-        return;
-    m_quit = true;
-    {
-        lock_guard<mutex> lock(m_start_search_mutex);
-        m_start_search_flag = true;
-    }
-    m_start_search_cond.notify_one();
-    m_thread.join();
-}
-
-template<class S, class M, class R>
-void SearchBase<S, M, R>::Thread::run()
-{
-    m_thread = thread(bind(&Thread::thread_main, this));
-    m_thread_ready.wait();
-}
-
-template<class S, class M, class R>
-void SearchBase<S, M, R>::Thread::start_search()
-{
-    LIBBOARDGAME_ASSERT(m_thread.joinable());
-    m_search_finished_lock.lock();
-    {
-        lock_guard<mutex> lock(m_start_search_mutex);
-        m_start_search_flag = true;
-    }
-    m_start_search_cond.notify_one();
-}
-
-template<class S, class M, class R>
-void SearchBase<S, M, R>::Thread::thread_main()
-{
-    unique_lock<mutex> lock(m_start_search_mutex);
-    m_thread_ready.wait();
-    while (true)
-    {
-        while (! m_start_search_flag)
-            m_start_search_cond.wait(lock);
-        m_start_search_flag = false;
-        if (m_quit)
-            break;
-        m_search_func(thread_state);
-        {
-            lock_guard<mutex> lock(m_search_finished_mutex);
-            m_search_finished_flag = true;
-        }
-        m_search_finished_cond.notify_one();
-    }
-}
-
-template<class S, class M, class R>
-void SearchBase<S, M, R>::Thread::wait_search_finished()
-{
-    LIBBOARDGAME_ASSERT(m_thread.joinable());
-    while (! m_search_finished_flag)
-        m_search_finished_cond.wait(m_search_finished_lock);
-    m_search_finished_flag = false;
-    m_search_finished_lock.unlock();
-}
-
 
 #if LIBBOARDGAME_DEBUG
 template<class S, class M, class R>
@@ -644,10 +627,9 @@ void SearchBase<S, M, R>::AssertionHandler::run()
 
 template<class S, class M, class R>
 SearchBase<S, M, R>::SearchBase(unsigned nu_threads, size_t memory)
-    : m_tree(memory / 2, nu_threads),
-      m_nu_threads(nu_threads),
-      m_exploration_constant(0),
-      m_tmp_tree(memory / 2, m_nu_threads)
+    : m_tree(memory, nu_threads < max_threads ? nu_threads : max_threads),
+      m_nu_threads(nu_threads < max_threads ? nu_threads : max_threads),
+      m_exploration_constant(0)
 #if LIBBOARDGAME_DEBUG
       , m_assertion_handler(*this)
 #endif
@@ -656,6 +638,18 @@ SearchBase<S, M, R>::SearchBase(unsigned nu_threads, size_t memory)
 template<class S, class M, class R>
 SearchBase<S, M, R>::~SearchBase() = default;
 
+/** Bind the current thread to its CPU if set_cpus() was used.
+    The binding lasts until the affinity object is destroyed.
+    @return @c false if binding failed. */
+template<class S, class M, class R>
+bool SearchBase<S, M, R>::bind_thread(const ThreadState& thread_state,
+                                      ScopedThreadAffinity& affinity) const
+{
+    if (m_cpus.empty())
+        return true;
+    return affinity.bind(m_cpus[thread_state.thread_id % m_cpus.size()]);
+}
+
 template<class S, class M, class R>
 bool SearchBase<S, M, R>::check_abort(const ThreadState& thread_state) const
 {
@@ -782,21 +776,17 @@ void SearchBase<S, M, R>::create_threads()
     LIBBOARDGAME_LOG("Creating ", m_nu_threads, " threads");
     m_threads.clear();
     m_threads.reserve(m_nu_threads);
-    auto search_func =
-        static_cast<typename Thread::SearchFunc>(
-                          bind(&SearchBase::search_loop, this, placeholders::_1));
     for (unsigned i = 0; i < m_nu_threads; ++i)
     {
-        auto t = make_unique<Thread>(search_func);
-        auto& thread_state = t->thread_state;
-        thread_state.thread_id = i;
-        thread_state.state = create_state();
-        for (auto& was_played : thread_state.was_played)
+        auto thread_state = make_unique<ThreadState>();
+        thread_state->thread_id = i;
+        thread_state->state = create_state();
+        for (auto& was_played : thread_state->was_played)
             was_played = max_players;
-        if (i > 0)
-            t->run();
-        m_threads.push_back(move(t));
+        m_threads.push_back(move(thread_state));
     }
+    if (m_nu_threads > 1)
+        ThreadPool::get_global().reserve(m_nu_threads - 1);
 }
 
 #if LIBBOARDGAME_DEBUG
@@ -819,6 +809,19 @@ bool SearchBase<S, M, R>::expand_node(ThreadState& thread_state,
                                       const Node*& best_child)
 {
     auto& state = *thread_state.state;
+    uint64_t hash = 0;
+    if (m_use_transpositions)
+    {
+        hash = state.get_hash();
+        NodeIdx first_child;
+        unsigned short nu_children;
+        if (m_tree.lookup_transposition(hash, first_child, nu_children))
+        {
+            m_tree.link_children(node, first_child, nu_children);
+            best_child = select_child(node);
+            return true;
+        }
+    }
     auto thread_id = thread_state.thread_id;
     typename Tree::NodeExpander expander(thread_id, m_tree,
                                          SearchParamConst::child_min_count);
@@ -827,6 +830,8 @@ bool SearchBase<S, M, R>::expand_node(ThreadState& thread_state,
     {
         expander.link_children(m_tree, node);
         best_child = expander.get_best_child();
+        if (m_use_transpositions && node.has_children())
+            m_tree.store_transposition(hash, node);
         return true;
     }
     return false;
@@ -889,18 +894,30 @@ inline bool SearchBase<S, M, R>::get_reuse_tree() const
     return m_reuse_tree;
 }
 
+template<class S, class M, class R>
+inline bool SearchBase<S, M, R>::get_use_huge_pages() const
+{
+    return m_tree.get_huge_pages();
+}
+
+template<class S, class M, class R>
+inline bool SearchBase<S, M, R>::get_use_transpositions() const
+{
+    return m_use_transpositions;
+}
+
 template<class S, class M, class R>
 inline S& SearchBase<S, M, R>::get_state(unsigned thread_id)
 {
     LIBBOARDGAME_ASSERT(thread_id < m_threads.size());
-    return *m_threads[thread_id]->thread_state.state;
+    return *m_threads[thread_id]->state;
 }
 
 template<class S, class M, class R>
 inline const S& SearchBase<S, M, R>::get_state(unsigned thread_id) const
 {
     LIBBOARDGAME_ASSERT(thread_id < m_threads.size());
-    return *m_threads[thread_id]->thread_state.state;
+    return *m_threads[thread_id]->state;
 }
 
 template<class S, class M, class R>
@@ -917,7 +934,8 @@ void SearchBase<S, M, R>::on_start_search(bool is_followup)
 }
 
 template<class S, class M, class R>
-void SearchBase<S, M, R>::playout(ThreadState& thread_state)
+template<class P>
+void SearchBase<S, M, R>::playout(ThreadState& thread_state, P param)
 {
     auto& state = *thread_state.state;
     state.start_playout();
@@ -927,9 +945,9 @@ void SearchBase<S, M, R>::playout(ThreadState& thread_state)
     Move last = nu_moves > 0 ? moves[nu_moves - 1].move : Move::null();
     Move second_last = nu_moves > 1 ? moves[nu_moves - 2].move : Move::null();
     PlayerMove mv;
-    while (state.gen_playout_move(m_lgr, last, second_last, mv))
+    while (state.gen_playout_move(m_lgr, last, second_last, mv, param))
     {
-        state.play_playout(mv.move);
+        state.play_playout(mv.move, param);
         moves.push_back(mv);
         second_last = last;
         last = mv.move;
@@ -937,7 +955,8 @@ void SearchBase<S, M, R>::playout(ThreadState& thread_state)
 }
 
 template<class S, class M, class R>
-void SearchBase<S, M, R>::play_in_tree(ThreadState& thread_state)
+template<class P>
+void SearchBase<S, M, R>::play_in_tree(ThreadState& thread_state, P param)
 {
     auto& state = *thread_state.state;
     auto& simulation = thread_state.simulation;
@@ -948,26 +967,38 @@ void SearchBase<S, M, R>::play_in_tree(ThreadState& thread_state)
     Float expand_threshold = SearchParamConst::expand_threshold;
     while (node->has_children())
     {
-        node = select_child(*node);
+        auto child = select_child(*node);
+        if (! child)
+            // Children were removed by a concurrent prune()
+            break;
+        node = child;
         if (multithread && SearchParamConst::virtual_loss)
             m_tree.add_value(*node, 0);
         simulation.nodes.push_back(node);
         Move mv = node->get_move();
         simulation.moves.push_back(PlayerMove(state.get_player(), mv));
-        state.play_in_tree(mv);
+        state.play_in_tree(mv, param);
         expand_threshold += SearchParamConst::expand_threshold_inc;
     }
     state.finish_in_tree();
     if (node->get_visit_count() > expand_threshold)
     {
         if (! expand_node(thread_state, *node, node))
-            thread_state.is_out_of_mem = true;
+        {
+            // Tree is full. Without transpositions, the tree can be pruned
+            // while the other threads continue and the simulation continues
+            // without expansion. Otherwise, all threads need to be stopped.
+            if (m_use_transpositions)
+                thread_state.is_out_of_mem = true;
+            else
+                prune(thread_state);
+        }
         else if (node)
         {
             simulation.nodes.push_back(node);
             Move mv = node->get_move();
             simulation.moves.push_back(PlayerMove(state.get_player(), mv));
-            state.play_expanded_child(mv);
+            state.play_expanded_child(mv, param);
         }
     }
     thread_state.stat_in_tree_len.add(double(simulation.moves.size()));
@@ -979,7 +1010,7 @@ string SearchBase<S, M, R>::get_info() const
     auto& root = m_tree.get_root();
     if (m_threads.empty())
         return string();
-    auto& thread_state = m_threads[0]->thread_state;
+    auto& thread_state = *m_threads[0];
     ostringstream s;
     s << fixed << setprecision(2) << "Val: " << get_root_val().get_mean()
       << setprecision(0) << ", ValCnt: " << get_root_val().get_count()
@@ -1003,38 +1034,48 @@ string SearchBase<S, M, R>::get_info() const
 template<class S, class M, class R>
 string SearchBase<S, M, R>::get_info_ext() const
 {
-    return string();
+    if (! m_tree.get_huge_pages())
+        return string();
+    ostringstream s;
+    s << "Pages: ";
+    switch (m_tree.get_page_type())
+    {
+    case libboardgame_sys::PageType::huge:
+        s << "huge";
+        break;
+    case libboardgame_sys::PageType::transparent_huge:
+        s << "transparent huge";
+        break;
+    case libboardgame_sys::PageType::normal:
+        s << "normal";
+        break;
+    }
+    s << " (" << m_tree.get_huge_page_memory() / 1000000 << " MB huge)\n";
+    return s.str();
 }
 
 template<class S, class M, class R>
-bool SearchBase<S, M, R>::prune(TimeSource& time_source, double time,
-                                Float prune_min_count,
-                                Float& new_prune_min_count)
+void SearchBase<S, M, R>::prune(ThreadState& thread_state)
 {
+    unique_lock<mutex> lock(m_prune_mutex, try_to_lock);
+    if (! lock.owns_lock())
+        return;
+    Timer timer(*m_time_source);
+    double time = m_timer();
+    size_t nu_nodes;
+    if (! m_tree.prune(m_prune_min_count, nu_nodes))
+        return;
 #if LIBBOARDGAME_DISABLE_LOG
     LIBBOARDGAME_UNUSED(time);
 #endif
-    Timer timer(time_source);
-    m_tmp_tree.clear();
-    m_tree.copy_subtree(m_tmp_tree, m_tmp_tree.get_root(), m_tree.get_root(),
-                        prune_min_count);
-    int percent = int(m_tmp_tree.get_nu_nodes() * 100 / m_tree.get_nu_nodes());
-    LIBBOARDGAME_LOG("Pruning MinCnt: ", prune_min_count, ", AtTm: ", time,
-                     ", Nds: ", m_tmp_tree.get_nu_nodes(), " (", percent,
-                     "%), Tm: ", timer());
-    m_tree.swap(m_tmp_tree);
-    if (percent > 50)
-    {
-        if (prune_min_count >= 0.5 * numeric_limits<Float>::max())
-            return false;
-        new_prune_min_count = prune_min_count * 2;
-        return true;
-    }
-    else
-    {
-        new_prune_min_count = prune_min_count;
-        return true;
-    }
+    auto max_nodes = m_tree.get_max_nodes();
+    LIBBOARDGAME_LOG_THREAD(thread_state, "Pruning MinCnt: ",
+                            m_prune_min_count, ", AtTm: ", time, ", Removed: ",
+                            nu_nodes, " (", int(nu_nodes * 100 / max_nodes),
+                            "%), Tm: ", timer());
+    if (nu_nodes < max_nodes / 2
+            && m_prune_min_count < 0.5 * numeric_limits<Float>::max())
+        m_prune_min_count *= 2;
 }
 
 /** Estimate the value and count of a root node from its children.
@@ -1101,35 +1142,35 @@ bool SearchBase<S, M, R>::search(Move& mv, Float max_count,
         if (m_followup_sequence.empty())
         {
             if (tree_nodes > 1)
-                LIBBOARDGAME_LOG("Reusing all ", tree_nodes, "nodes (count=",
+            {
+                LIBBOARDGAME_LOG("Reusing all ", tree_nodes, " nodes (count=",
                                  m_tree.get_root().get_visit_count(), ")");
+                clear_tree = false;
+            }
         }
         else
         {
             Timer timer(time_source);
-            m_tmp_tree.clear();
             auto node = find_node(m_tree, m_followup_sequence);
-            if (node)
+            if (node && node != &m_tree.get_root())
             {
-                m_tree.extract_subtree(m_tmp_tree, *node);
-                auto& tmp_tree_root = m_tmp_tree.get_root();
+                m_tree.reroot(*node);
                 if (! is_same)
                 {
                     Float value, count;
-                    if (estimate_reused_root_val(m_tmp_tree, tmp_tree_root,
+                    if (estimate_reused_root_val(m_tree, m_tree.get_root(),
                                                  value, count))
                         m_root_val[m_player].add(value, count);
                 }
-                size_t tmp_tree_nodes = m_tmp_tree.get_nu_nodes();
-                if (tree_nodes > 1 && tmp_tree_nodes > 1)
+                size_t reused_nodes = m_tree.get_nu_nodes();
+                if (tree_nodes > 1 && reused_nodes > 1)
                 {
                     double time = timer();
-                    LIBBOARDGAME_LOG("Reusing ", tmp_tree_nodes, " nodes (",
+                    LIBBOARDGAME_LOG("Reusing ", reused_nodes, " nodes (",
                                      std::fixed, setprecision(1),
-                                     100 * double(tmp_tree_nodes)
+                                     100 * double(reused_nodes)
                                      / double(tree_nodes),
                                      "% tm=", setprecision(4), time, ")");
-                    m_tree.swap(m_tmp_tree);
                     clear_tree = false;
                     max_time -= time;
                     if (max_time < 0)
@@ -1147,7 +1188,7 @@ bool SearchBase<S, M, R>::search(Move& mv, Float max_count,
         m_lgr.init(m_nu_players);
     for (auto& i : m_threads)
     {
-        auto& thread_state = i->thread_state;
+        auto& thread_state = *i;
         thread_state.stat_len.clear();
         thread_state.stat_in_tree_len.clear();
         thread_state.state->start_search();
@@ -1156,25 +1197,13 @@ bool SearchBase<S, M, R>::search(Move& mv, Float max_count,
     m_min_simulations = min_simulations;
     m_max_time = max_time;
     m_nu_simulations.store(0);
-    Float prune_min_count = SearchParamConst::prune_count_start;
-
-    // Don't use multi-threading for very short searches (less than 0.5s).
-    auto reused_count = m_tree.get_root().get_visit_count();
-    unsigned nu_threads = m_nu_threads;
-    double expected_time;
-    if (max_count > 0)
-        expected_time =
-                (max_count - reused_count)
-                / SearchParamConst::expected_sim_per_sec;
-    else
-        expected_time = max_time;
-    if (nu_threads > 1 && expected_time < 0.5)
-    {
-        LIBBOARDGAME_LOG("Using single-threading for short search");
-        nu_threads = 1;
-    }
+    m_prune_min_count = SearchParamConst::prune_count_start;
 
-    auto& thread_state_0 = m_threads[0]->thread_state;
+    auto& thread_state_0 = *m_threads[0];
+    // Restores the affinity of the calling thread when search() returns
+    ScopedThreadAffinity affinity_0;
+    if (! bind_thread(thread_state_0, affinity_0))
+        LIBBOARDGAME_LOG("Could not bind thread to CPU");
     auto& root = m_tree.get_root();
     if (! root.has_children())
     {
@@ -1191,26 +1220,38 @@ bool SearchBase<S, M, R>::search(Move& mv, Float max_count,
     else
         while (true)
         {
-            for (unsigned i = 1; i < nu_threads; ++i)
-                m_threads[i]->start_search();
-            search_loop(thread_state_0);
-            for (unsigned i = 1; i < nu_threads; ++i)
-                m_threads[i]->wait_search_finished();
+            if (m_nu_threads > 1)
+            {
+                auto& pool = ThreadPool::get_global();
+                for (unsigned i = 1; i < m_nu_threads; ++i)
+                {
+                    auto& thread_state = *m_threads[i];
+                    pool.submit(m_tasks, [this, &thread_state] {
+                        search_loop(thread_state);
+                    });
+                }
+                search_loop(thread_state_0);
+                pool.wait(m_tasks);
+            }
+            else
+                search_loop(thread_state_0);
             bool is_out_of_mem = false;
-            for (unsigned i = 0; i < nu_threads; ++i)
-                if (m_threads[i]->thread_state.is_out_of_mem)
+            for (unsigned i = 0; i < m_nu_threads; ++i)
+                if (m_threads[i]->is_out_of_mem)
                 {
                     is_out_of_mem = true;
                     break;
                 }
             if (! is_out_of_mem)
                 break;
-            double time = m_timer();
-            prune(time_source, time, prune_min_count, prune_min_count);
+            prune(thread_state_0);
         }
 
     m_last_time = m_timer();
     LIBBOARDGAME_LOG(get_info());
+    auto info_ext = get_info_ext();
+    if (! info_ext.empty())
+        LIBBOARDGAME_LOG(info_ext);
     bool result = select_move(mv);
     m_time_source = nullptr;
     return result;
@@ -1218,6 +1259,22 @@ bool SearchBase<S, M, R>::search(Move& mv, Float max_count,
 
 template<class S, class M, class R>
 void SearchBase<S, M, R>::search_loop(ThreadState& thread_state)
+{
+    // Thread 0 runs in the thread that called search() and was already bound
+    // there. The other threads are bound only while the task runs, because a
+    // pool worker (or the thread waiting for the tasks) runs other tasks
+    // afterwards.
+    ScopedThreadAffinity affinity;
+    if (thread_state.thread_id > 0)
+        bind_thread(thread_state, affinity);
+    thread_state.state->with_param([this, &thread_state](auto param) {
+        this->search_loop(thread_state, param);
+    });
+}
+
+template<class S, class M, class R>
+template<class P>
+void SearchBase<S, M, R>::search_loop(ThreadState& thread_state, P param)
 {
     auto& state = *thread_state.state;
     auto& simulation = thread_state.simulation;
@@ -1243,11 +1300,12 @@ void SearchBase<S, M, R>::search_loop(ThreadState& thread_state)
         if ((check_abort(thread_state) || expensive_abort_checker())
                 && m_nu_simulations >= m_min_simulations)
             break;
+        m_tree.enter(thread_state.thread_id);
         state.start_simulation(m_nu_simulations.fetch_add(1));
-        play_in_tree(thread_state);
+        play_in_tree(thread_state, param);
         if (thread_state.is_out_of_mem)
             break;
-        playout(thread_state);
+        playout(thread_state, param);
         state.evaluate_playout(simulation.eval);
         thread_state.stat_len.add(double(simulation.moves.size()));
         update_values(thread_state);
@@ -1256,6 +1314,7 @@ void SearchBase<S, M, R>::search_loop(ThreadState& thread_state)
         if (SearchParamConst::use_lgr)
             update_lgr(thread_state);
     }
+    m_tree.leave(thread_state.thread_id);
 }
 
 template<class S, class M, class R>
@@ -1265,26 +1324,17 @@ inline auto SearchBase<S, M, R>::select_child(const Node& node) -> const Node*
     Float bias_factor = m_exploration_constant * sqrt(parent_count);
     static_assert(SearchParamConst::child_min_count > 0, "");
     auto bias_limit = bias_factor / SearchParamConst::child_min_count;
-    auto children = m_tree.get_children_nonempty(node);
-    auto i = children.begin();
-    auto value = i->get_value() + bias_factor / i->get_value_count();
-    auto best_value = value;
-    auto best_child = i;
-    auto limit = best_value - bias_limit;
-    while (++i != children.end())
-    {
-        value = i->get_value();
-        if (value <= limit)
-            continue;
-        value += bias_factor / i->get_value_count();
-        if (value > best_value)
-        {
-            best_value = value;
-            best_child = i;
-            limit = best_value - bias_limit;
-        }
-    }
-    return best_child;
+    auto children = m_tree.get_children(node);
+    if (children.empty())
+        return nullptr;
+    // The SIMD version is slower for a small number of children (see
+    // benchmark/libboardgame_mcts)
+    if (SearchParamConst::simd_select_child && ! SearchParamConst::compact_node
+            && children.size() >= 32)
+        return select_child_simd(children.begin(), children.end(),
+                                 bias_factor, bias_limit);
+    return libboardgame_mcts::select_child(children.begin(), children.end(),
+                                           bias_factor, bias_limit);
 }
 
 template<class S, class M, class R>
@@ -1329,6 +1379,12 @@ void SearchBase<S, M, R>::set_callback(
     m_callback = callback;
 }
 
+template<class S, class M, class R>
+void SearchBase<S, M, R>::set_cpus(const vector<unsigned>& cpus)
+{
+    m_cpus = cpus;
+}
+
 template<class S, class M, class R>
 void SearchBase<S, M, R>::set_rave_parent_max(Float n)
 {
@@ -1359,6 +1415,21 @@ void SearchBase<S, M, R>::set_reuse_tree(bool enable)
     m_reuse_tree = enable;
 }
 
+template<class S, class M, class R>
+void SearchBase<S, M, R>::set_use_huge_pages(bool enable)
+{
+    m_tree.set_huge_pages(enable);
+}
+
+template<class S, class M, class R>
+void SearchBase<S, M, R>::set_use_transpositions(bool enable)
+{
+    if (enable == m_use_transpositions)
+        return;
+    m_use_transpositions = enable;
+    m_tree.set_transpositions(enable);
+}
+
 template<class S, class M, class R>
 void SearchBase<S, M, R>::update_lgr(ThreadState& thread_state)
 {
@@ -1431,23 +1502,22 @@ void SearchBase<S, M, R>::update_rave(ThreadState& thread_state)
         Float dist_factor;
         if (SearchParamConst::rave_dist_weighting)
             dist_factor = 1 / static_cast<Float>(nu_moves - i);
-        auto children = m_tree.get_children_nonempty(*node);
-        LIBBOARDGAME_ASSERT(! children.empty());
-        auto it = children.begin();
-        do
+        // The children can be empty if they were removed by a concurrent
+        // prune()
+        for (auto& child : m_tree.get_children(*node))
         {
-            auto mv = it->get_move();
+            auto mv = child.get_move();
             if (was_played[mv.to_int()] != player
-                    || it->get_value_count() > m_rave_child_max)
+                    || child.get_value_count() > m_rave_child_max)
                 continue;
             auto first = first_play[mv.to_int()];
             LIBBOARDGAME_ASSERT(first > i);
             Float weight = m_rave_weight;
             if (SearchParamConst::rave_dist_weighting)
                 weight *= 1 - static_cast<Float>(first - i) * dist_factor;
-            m_tree.add_value(*it, thread_state.simulation.eval[player], weight);
+            m_tree.add_value(child, thread_state.simulation.eval[player],
+                             weight);
         }
-        while (++it != children.end());
         if (i == 0)
             break;
         if (! state.skip_rave(mv.move))
@@ -1486,7 +1556,9 @@ void SearchBase<S, M, R>::update_values(ThreadState& thread_state)
             m_tree.add_value_remove_loss(node, eval[mv.player]);
         else
             m_tree.add_value(node, eval[mv.player]);
-        m_tree.inc_visit_count(node);
+        // The visit count of a compact node is its value count
+        if (! SearchParamConst::compact_node)
+            m_tree.inc_visit_count(node);
     }
     for (PlayerInt i = 0; i < m_nu_players; ++i)
         m_root_val[i].add(eval[i]);
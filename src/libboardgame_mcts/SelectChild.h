@@ -0,0 +1,259 @@
+//-----------------------------------------------------------------------------
+/** @file libboardgame_mcts/SelectChild.h
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifndef LIBBOARDGAME_MCTS_SELECT_CHILD_H
+#define LIBBOARDGAME_MCTS_SELECT_CHILD_H
+
+#include <limits>
+#include <type_traits>
+#include "libboardgame_util/Assert.h"
+
+#if defined __AVX__ || defined __SSE2__
+#include <immintrin.h>
+#endif
+
+namespace libboardgame_mcts {
+
+using namespace std;
+
+//-----------------------------------------------------------------------------
+
+/** Find the child with the highest UCT value skipping children that cannot
+    be selected.
+    Avoids the division in the bias term for children whose value is lower
+    than the best UCT value found so far minus the maximum bias term.
+    @param begin
+    @param end
+    @param bias_factor
+    @param bias_limit The maximum bias term (bias_factor divided by the
+    minimum value count of a child)
+    @pre begin != end */
+template<class N>
+const N* select_child(const N* begin, const N* end,
+                      typename N::Float bias_factor,
+                      typename N::Float bias_limit)
+{
+    LIBBOARDGAME_ASSERT(begin != end);
+    auto i = begin;
+    auto value = i->get_value() + bias_factor / i->get_value_count();
+    auto best_value = value;
+    auto best_child = i;
+    auto limit = best_value - bias_limit;
+    while (++i != end)
+    {
+        value = i->get_value();
+        if (value <= limit)
+            continue;
+        value += bias_factor / i->get_value_count();
+        if (value > best_value)
+        {
+            best_value = value;
+            best_child = i;
+            limit = best_value - bias_limit;
+        }
+    }
+    return best_child;
+}
+
+/** Find the child with the highest UCT value.
+    The UCT value of a child is value + bias_factor / value_count. If several
+    children have the same highest value, the first one is returned. This
+    is the scalar reference implementation of select_child_simd().
+    @pre begin != end
+    @pre All value counts are greater zero */
+template<class N>
+const N* select_child_scalar(const N* begin, const N* end,
+                             typename N::Float bias_factor)
+{
+    LIBBOARDGAME_ASSERT(begin != end);
+    auto best_child = begin;
+    auto best_value =
+            begin->get_value() + bias_factor / begin->get_value_count();
+    for (auto i = begin + 1; i != end; ++i)
+    {
+        auto value = i->get_value() + bias_factor / i->get_value_count();
+        if (value > best_value)
+        {
+            best_value = value;
+            best_child = i;
+        }
+    }
+    return best_child;
+}
+
+#if defined __AVX__ || defined __SSE2__
+
+/** Load the values and value counts of 4 consecutive nodes.
+    The value and value count of each node are loaded with a single 64-bit
+    load and transposed with shuffles, which is much faster than loading each
+    float separately. */
+template<class N>
+inline void load_stats(const N* p, __m128& values, __m128& counts)
+{
+    static_assert(is_same<typename N::Float, float>::value, "");
+    auto load = [](const N& node) {
+        return _mm_castsi128_ps(_mm_loadl_epi64(
+                    reinterpret_cast<const __m128i*>(node.get_value_ptr())));
+    };
+    auto a = _mm_movelh_ps(load(p[0]), load(p[1]));
+    auto b = _mm_movelh_ps(load(p[2]), load(p[3]));
+    values = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    counts = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+/** Vectorized implementation of select_child_scalar() for float.
+    The values and value counts of the children are loaded in batches into
+    vectors (structure-of-arrays), such that the bias terms of a batch can be
+    computed with a single vector division. Each vector lane keeps the first
+    best child of the children it processed, and the lanes are combined at
+    the end, preferring lower indices on ties, so the result is the same as
+    for select_child_scalar(). Uses AVX if the compiler targets it, otherwise
+    SSE2. */
+template<class N>
+const N* select_child_simd_float(const N* begin, const N* end,
+                                 float bias_factor)
+{
+    LIBBOARDGAME_ASSERT(begin != end);
+#ifdef __AVX__
+    const unsigned width = 8;
+    typedef __m256 Vec;
+    auto set1 = [](float f) { return _mm256_set1_ps(f); };
+    auto add = [](Vec a, Vec b) { return _mm256_add_ps(a, b); };
+    auto div = [](Vec a, Vec b) { return _mm256_div_ps(a, b); };
+    auto max = [](Vec a, Vec b) { return _mm256_max_ps(a, b); };
+    auto greater = [](Vec a, Vec b) {
+        return _mm256_cmp_ps(a, b, _CMP_GT_OQ); };
+    auto blend = [](Vec a, Vec b, Vec mask) {
+        return _mm256_blendv_ps(a, b, mask); };
+    auto load = [](const N* p, Vec& values, Vec& counts) {
+        __m128 values_lo, counts_lo, values_hi, counts_hi;
+        load_stats(p, values_lo, counts_lo);
+        load_stats(p + 4, values_hi, counts_hi);
+        values = _mm256_insertf128_ps(_mm256_castps128_ps256(values_lo),
+                                      values_hi, 1);
+        counts = _mm256_insertf128_ps(_mm256_castps128_ps256(counts_lo),
+                                      counts_hi, 1);
+    };
+    auto store = [](float* p, Vec v) { _mm256_store_ps(p, v); };
+    auto idx = _mm256_set_ps(7, 6, 5, 4, 3, 2, 1, 0);
+#else
+    const unsigned width = 4;
+    typedef __m128 Vec;
+    auto set1 = [](float f) { return _mm_set1_ps(f); };
+    auto add = [](Vec a, Vec b) { return _mm_add_ps(a, b); };
+    auto div = [](Vec a, Vec b) { return _mm_div_ps(a, b); };
+    auto max = [](Vec a, Vec b) { return _mm_max_ps(a, b); };
+    auto greater = [](Vec a, Vec b) { return _mm_cmpgt_ps(a, b); };
+    auto blend = [](Vec a, Vec b, Vec mask) {
+        return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b)); };
+    auto load = [](const N* p, Vec& values, Vec& counts) {
+        load_stats(p, values, counts);
+    };
+    auto store = [](float* p, Vec v) { _mm_store_ps(p, v); };
+    auto idx = _mm_set_ps(3, 2, 1, 0);
+#endif
+    // Indices are stored as float, which is exact for the maximum number of
+    // children (unsigned short)
+    auto nu_children = static_cast<unsigned>(end - begin);
+    auto nu_batched = nu_children / width * width;
+    auto bias = set1(bias_factor);
+    auto idx_inc = set1(static_cast<float>(width));
+    auto best_value = set1(-numeric_limits<float>::max());
+    auto best_idx = set1(0);
+    for (unsigned i = 0; i < nu_batched; i += width)
+    {
+        Vec values, counts;
+        load(begin + i, values, counts);
+        auto value = add(values, div(bias, counts));
+        auto is_better = greater(value, best_value);
+        best_value = max(value, best_value);
+        best_idx = blend(best_idx, idx, is_better);
+        idx = add(idx, idx_inc);
+    }
+    const N* best_child = nullptr;
+    float best = 0;
+    if (nu_batched > 0)
+    {
+        alignas(32) float lane_value[width];
+        alignas(32) float lane_idx[width];
+        store(lane_value, best_value);
+        store(lane_idx, best_idx);
+        auto best_i = static_cast<unsigned>(lane_idx[0]);
+        best = lane_value[0];
+        for (unsigned j = 1; j < width; ++j)
+        {
+            auto i = static_cast<unsigned>(lane_idx[j]);
+            if (lane_value[j] > best
+                    || (lane_value[j] == best && i < best_i))
+            {
+                best = lane_value[j];
+                best_i = i;
+            }
+        }
+        best_child = begin + best_i;
+    }
+    for (auto i = begin + nu_batched; i != end; ++i)
+    {
+        auto value = i->get_value() + bias_factor / i->get_value_count();
+        if (! best_child || value > best)
+        {
+            best = value;
+            best_child = i;
+        }
+    }
+    return best_child;
+}
+
+template<class N>
+inline const N* select_child_simd_impl(const N* begin, const N* end,
+                                       typename N::Float bias_factor,
+                                       typename N::Float, true_type)
+{
+    return select_child_simd_float(begin, end, bias_factor);
+}
+
+template<class N>
+inline const N* select_child_simd_impl(const N* begin, const N* end,
+                                       typename N::Float bias_factor,
+                                       typename N::Float bias_limit,
+                                       false_type)
+{
+    return select_child(begin, end, bias_factor, bias_limit);
+}
+
+#endif // defined __AVX__ || defined __SSE2__
+
+/** Find the child with the highest UCT value using SIMD instructions.
+    Returns the same child as select_child_scalar(). Falls back to
+    select_child() if the floating type is not float, the node is a
+    CompactNode or the target does not support SSE2.
+    @param begin
+    @param end
+    @param bias_factor
+    @param bias_limit The maximum bias term, only used by the fallback (see
+    select_child())
+    @pre begin != end */
+template<class N>
+inline const N* select_child_simd(const N* begin, const N* end,
+                                  typename N::Float bias_factor,
+                                  typename N::Float bias_limit)
+{
+#if defined __AVX__ || defined __SSE2__
+    return select_child_simd_impl(
+                begin, end, bias_factor, bias_limit,
+                integral_constant<bool,
+                    is_same<typename N::Float, float>::value
+                    && ! N::is_compact>());
+#else
+    return select_child(begin, end, bias_factor, bias_limit);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace libboardgame_mcts
+
+#endif // LIBBOARDGAME_MCTS_SELECT_CHILD_H
@@ -8,8 +8,19 @@
 #define LIBBOARDGAME_MCTS_TREE_H
 
 #include <algorithm>
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <set>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "Node.h"
+#include "libboardgame_sys/Memory.h"
+#include "libboardgame_util/Range.h"
 
 namespace libboardgame_mcts {
 
@@ -25,7 +36,31 @@ using libboardgame_util::Range;
     The tree uses separate parts of the node storage for different threads,
     so it can be used without locking in multi-threaded search. Not all
     functions are thread-safe, only the ones that are used during a search
-    (e.g. expanding a node is thread-safe, but clear() is not) */
+    (e.g. expanding a node is thread-safe, but clear() is not)<p>
+    The node storage only reserves address space when the tree is created.
+    Memory is committed in chunks when the nodes are used, so the physical
+    memory used by the tree grows with the number of expanded nodes.
+    The chunks of the part of a thread are committed and initialized by the
+    thread itself, so with the first-touch policy of the operating system,
+    they are allocated on the NUMA node of the thread, if the thread is bound
+    to a CPU.<p>
+    If the tree is full, a thread can prune it during the search while the
+    other threads continue searching. Pruning unlinks the children of nodes
+    with a low count and puts the unlinked child blocks on a free list, which
+    is used for node expansions if the part of the node storage of a thread
+    is used up. Because other threads can still be in the middle of a
+    simulation that uses the unlinked nodes, the blocks are reused only after
+    all threads have started a new simulation (epoch-based reclamation, see
+    enter()).<p>
+    Optionally, the tree can be used as a directed acyclic graph, in which
+    nodes of transposed positions share their children. For this purpose,
+    the tree contains a lock-free hash table that maps position hashes to the
+    children of the node that was expanded first. It uses the XOR trick from
+    Hyatt/Mann: A lockless transposition-table implementation for parallel
+    search (2002) to detect entries that were corrupted by concurrent
+    writes. In this mode, the tree can only be pruned while no other thread
+    accesses it because unlinked children could still be reachable from other
+    nodes or the transposition table. */
 template<typename N>
 class Tree
 {
@@ -62,8 +97,11 @@ public:
         NodeExpander(unsigned thread_id, Tree& tree, Float child_min_count);
 
         /** Check if the tree still has the capacity for a given number
-            of children. */
-        bool check_capacity(unsigned short nu_children) const;
+            of children.
+            If the unused part of the thread storage is too small, this
+            reserves a block from the free list. Must be called at most once
+            per node expansion. */
+        bool check_capacity(unsigned short nu_children);
 
         /** Add new child.
             It needs to be checked first with check_capacity() that the tree
@@ -81,41 +119,107 @@ public:
         const Node* get_best_child() const;
 
     private:
+        Tree& m_tree;
+
         ThreadStorage& m_thread_storage;
 
         Float m_best_value = -numeric_limits<Float>::max();
 
-        const Node* m_first_child;
+        Node* m_first_child;
+
+        Node* m_next;
+
+        Node* m_end;
 
         const Node* m_best_child;
 
+        /** Is [m_first_child, m_end) a block from the free list (instead of
+            the unused part of the thread storage)? */
+        bool m_is_free_block;
+
 #if LIBBOARDGAME_DEBUG
         Float m_child_min_count;
 #endif
     };
 
+    /** Constructor.
+        @param memory The maximum memory used for the nodes. Only address
+        space for this size is reserved at construction.
+        @param nu_threads */
     Tree(size_t memory, unsigned nu_threads);
 
     ~Tree();
 
-    /** Remove all nodes but the root node. */
+    /** Remove all nodes but the root node.
+        Also clears the transposition table. */
     void clear();
 
+    /** Enable or disable the transposition table.
+        Enabling the table allocates its memory, which is about 1/16 of the
+        memory used for the nodes. Clears the tree. */
+    void set_transpositions(bool enable);
+
+    bool has_transpositions() const { return m_transpositions != nullptr; }
+
+    /** Allocate the node storage with huge pages if possible.
+        Huge pages reduce TLB misses when accessing large trees. If huge
+        pages are not available, normal pages are used. With huge pages,
+        the memory is not committed in chunks but backed by the operating
+        system on first access. Reallocates the storage and clears the
+        tree.
+        @throws bad_alloc If the new storage cannot be allocated. In this
+        case, the old storage and the tree are kept. */
+    void set_huge_pages(bool enable);
+
+    bool get_huge_pages() const { return m_huge_pages; }
+
+    /** Get the type of pages obtained for the node storage. */
+    libboardgame_sys::PageType get_page_type() const { return m_page_type; }
+
+    /** Get the amount of the node storage currently backed by huge pages.
+        @return The memory in bytes or 0 if it cannot be determined. */
+    size_t get_huge_page_memory() const;
+
+    /** Look up the children of a transposed position.
+        @pre has_transpositions()
+        @param hash The hash of the position
+        @param[out] first_child The first child of the node of the position
+        @param[out] nu_children The number of children
+        @return @c true if the position was found */
+    bool lookup_transposition(uint64_t hash, NodeIdx& first_child,
+                              unsigned short& nu_children) const;
+
+    /** Store the children of a node in the transposition table.
+        @pre has_transpositions()
+        @pre node.has_children() */
+    void store_transposition(uint64_t hash, const Node& node);
+
     const Node& get_root() const;
 
+    /** Get the children of a node.
+        The number of children is read only once, so the result is
+        consistent even if the children are concurrently unlinked by
+        prune(). */
     Children get_children(const Node& node) const;
 
     Children get_children_nonempty(const Node& node) const;
 
     Children get_root_children() const { return get_children(get_root()); }
 
+    /** Get the number of nodes in use.
+        Not thread-safe. */
     size_t get_nu_nodes() const;
 
+    size_t get_max_nodes() const { return m_max_nodes; }
+
     const Node& get_node(NodeIdx i) const;
 
     void link_children(const Node& node, const Node* first_child,
                        unsigned short nu_children);
 
+    void link_children(const Node& node, NodeIdx first_child,
+                       unsigned short nu_children);
+
     void add_value(const Node& node, Float v);
 
     void add_value(const Node& node, Float v, Float weight);
@@ -124,28 +228,58 @@ public:
 
     void inc_visit_count(const Node& node);
 
-    void swap(Tree& tree);
-
-    /** Extract a subtree.
-        Note that you still have to re-initialize the value of the subtree
-        after the extraction because the value of the root node and the values
-        of inner nodes have a different meaning.
-        @pre Target tree is empty (! target.get_root().has_children())
-        @param target The target tree
+    /** Declare that a thread starts a new simulation.
+        Child blocks unlinked by prune() are not reused before all threads
+        have called enter() or leave() after the pruning, because the thread
+        could still access unlinked nodes during its current simulation.
+        Must be called by all threads that access the tree during a search
+        before each simulation. */
+    void enter(unsigned thread_id);
+
+    /** Declare that a thread stops accessing the tree.
+        Must be called at the end of a search by all threads that called
+        enter(). */
+    void leave(unsigned thread_id);
+
+    /** Remove the children of all nodes below a minimum count.
+        Can be called during a multi-threaded search. The unlinked children
+        are put on the free list after all threads have started a new
+        simulation.
+        If has_transpositions(), the children are removed only if they are
+        not reachable from another node, and they are put on the free list
+        immediately. This is not thread-safe.
+        @pre No other thread calls prune() at the same time.
+        @pre If has_transpositions(), no other thread accesses the tree.
+        @param min_count Remove the children of nodes below this count
+        @param[out] nu_nodes The number of removed nodes
+        @return @c false if the nodes removed by the last call were not yet
+        put on the free list. In this case, nothing is removed, only the
+        nodes of the last call are put on the free list if possible. */
+    bool prune(Float min_count, size_t& nu_nodes);
+
+    /** Make a node the new root node and remove all nodes that are not in
+        its subtree.
+        The nodes are not copied, the removed nodes are put on the free list.
+        Note that you still have to re-initialize the value of the new root
+        because the value of the root node and the values of inner nodes have
+        a different meaning. If the transposition table is enabled, entries
+        that refer to removed nodes are cleared.
+        Not thread-safe.
         @param node The root node of the subtree. */
-    void extract_subtree(Tree& target, const Node& node) const;
-
-    /** Copy a subtree.
-        The caller is responsible that the trees have the same number of
-        maximum nodes and that the target tree has room for the subtree.
-        @param target The target tree
-        @param target_node The target node
-        @param node The root node of the subtree.
-        @param min_count Don't copy subtrees of nodes below this count */
-    void copy_subtree(Tree& target, const Node& target_node, const Node& node,
-                      Float min_count) const;
+    void reroot(const Node& node);
 
 private:
+    /** Free blocks ordered by position.
+        Maps the index of the first node to the size. Adjacent blocks are
+        merged, such that large blocks can be reused for nodes with many
+        children. */
+    typedef map<NodeIdx, NodeIdx> FreeBlocksByPos;
+
+    /** Free blocks ordered by size (size and index of the first node). */
+    typedef set<pair<NodeIdx, NodeIdx>> FreeBlocksBySize;
+
+    typedef vector<pair<NodeIdx, unsigned short>> RetiredBlocks;
+
     struct ThreadStorage
     {
         Node* begin;
@@ -153,36 +287,129 @@ private:
         Node* end;
 
         Node* next;
+
+        /** End of the committed part of the storage. */
+        Node* committed;
+
+        /** Value of Tree::m_epoch at the last call of enter() or
+            quiescent_epoch if the thread does not access the tree. */
+        atomic<unsigned> epoch;
     };
 
+    /** Entry of the transposition table.
+        The data contains the index of the first child and the number of
+        children. The key is stored XOR'ed with the data. Entries with zero
+        data are empty (the first child index cannot be zero). */
+    struct TranspositionEntry
+    {
+        atomic<uint64_t> key_xor_data;
+
+        atomic<uint64_t> data;
+    };
+
+    static const unsigned quiescent_epoch = numeric_limits<unsigned>::max();
+
+    /** Minimum number of nodes committed at a time. */
+    static const size_t commit_chunk = (1 << 20) / sizeof(Node);
+
+
+    Node* m_nodes = nullptr;
 
-    unique_ptr<Node[]> m_nodes;
+    /** Size of the memory allocated for m_nodes. */
+    size_t m_memory_size = 0;
+
+    bool m_huge_pages = false;
+
+    libboardgame_sys::PageType m_page_type;
 
     unique_ptr<ThreadStorage[]> m_thread_storage;
 
+    unique_ptr<TranspositionEntry[]> m_transpositions;
+
     unsigned m_nu_threads;
 
     size_t m_max_nodes;
 
     size_t m_nodes_per_thread;
 
+    /** Size of the transposition table minus one (size is a power of 2) */
+    size_t m_transpositions_mask;
+
+    /** Incremented after each prune(). */
+    atomic<unsigned> m_epoch;
+
+    /** Protects the free list and the retired blocks. */
+    mutex m_free_mutex;
+
+    FreeBlocksByPos m_free_by_pos;
+
+    FreeBlocksBySize m_free_by_size;
+
+    /** Number of nodes in the free list. */
+    size_t m_nu_free_nodes;
+
+    /** Child blocks removed by prune() that could still be accessed by
+        other threads. */
+    RetiredBlocks m_retired;
+
+    /** Number of nodes in m_retired. */
+    size_t m_nu_retired_nodes;
+
+    /** Value of m_epoch when the blocks in m_retired were removed. */
+    unsigned m_retired_epoch;
+
+
+    void add_free_block(NodeIdx first_child, unsigned short nu_children);
+
+    void allocate_storage(bool huge_pages);
+
+    void clear_transpositions();
+
+    void clear_transpositions(const unordered_set<NodeIdx>& kept);
+
+    bool commit(ThreadStorage& thread_storage, const Node* end);
+
+    bool commit_chunk_until(ThreadStorage& thread_storage, const Node* end);
+
+    void collect_recurse(const Node& node,
+                         unordered_map<NodeIdx, unsigned short>& blocks) const;
 
     bool contains(const Node& node) const;
 
-    void copy_recurse(Tree& target, const Node& target_node, const Node& node,
-                      Float min_count) const;
+    void free_recurse(const Node& node, const Node& keep,
+                      const unordered_set<NodeIdx>* kept,
+                      unordered_set<NodeIdx>* visited);
 
-    unsigned get_thread_storage(const Node& node) const;
+    bool get_free_block(unsigned short nu_children, Node*& begin,
+                        Node*& end);
+
+    void insert_free_block(NodeIdx first, NodeIdx size);
+
+    void mark_recurse(const Node& node, unordered_set<NodeIdx>& kept) const;
 
     Node& non_const(const Node& node) const;
+
+    void prune_recurse(const Node& node, Float min_count,
+                       RetiredBlocks& retired, size_t& nu_nodes);
+
+    void prune_shared(Float min_count, size_t& nu_nodes);
+
+    bool reclaim();
+
+    void retire_recurse(NodeIdx first_child, unsigned short nu_children,
+                        RetiredBlocks& retired, size_t& nu_nodes);
 };
 
 template<typename N>
 inline Tree<N>::NodeExpander::NodeExpander(unsigned thread_id, Tree& tree,
                                            Float child_min_count)
-    : m_thread_storage(tree.m_thread_storage[thread_id]),
+    : m_tree(tree),
+      m_thread_storage(tree.m_thread_storage[thread_id]),
       m_first_child(m_thread_storage.next),
-      m_best_child(nullptr)
+      m_next(m_first_child),
+      m_end(m_thread_storage.end),
+      m_best_child(nullptr),
+      m_is_free_block(false)
 {
     LIBBOARDGAME_ASSERT(thread_id < tree.m_nu_threads);
 #if LIBBOARDGAME_DEBUG
@@ -199,22 +426,28 @@ inline void Tree<N>::NodeExpander::add_child(const Move& mv, Float value,
     // -numeric_limits<Float>::max() ist init value for m_best_value
     LIBBOARDGAME_ASSERT(value > -numeric_limits<Float>::max());
     LIBBOARDGAME_ASSERT(count >= m_child_min_count);
-    auto& next = m_thread_storage.next;
-    LIBBOARDGAME_ASSERT(next < m_thread_storage.end);
-    next->init(mv, value, count);
+    LIBBOARDGAME_ASSERT(m_next < m_end);
+    m_next->init(mv, value, count);
     if (value > m_best_value)
     {
-        m_best_child = next;
+        m_best_child = m_next;
         m_best_value = value;
     }
-    ++next;
+    ++m_next;
 }
 
 template<typename N>
-inline bool Tree<N>::NodeExpander::check_capacity(
-        unsigned short nu_children) const
+inline bool Tree<N>::NodeExpander::check_capacity(unsigned short nu_children)
 {
-    return m_thread_storage.end - m_thread_storage.next  >= nu_children;
+    if (m_end - m_next >= nu_children
+            && (m_is_free_block
+                || m_tree.commit(m_thread_storage, m_next + nu_children)))
+        return true;
+    if (! m_tree.get_free_block(nu_children, m_first_child, m_end))
+        return false;
+    m_next = m_first_child;
+    m_is_free_block = true;
+    return true;
 }
 
 template<typename N>
@@ -249,8 +482,13 @@ inline auto Tree<N>::get_node(NodeIdx i) const -> const Node&
 template<typename N>
 inline void Tree<N>::NodeExpander::link_children(Tree& tree, const Node& node)
 {
-    auto nu_children =
-            static_cast<unsigned short>(m_thread_storage.next - m_first_child);
+    auto nu_children = static_cast<unsigned short>(m_next - m_first_child);
+    if (m_is_free_block)
+        // Return the unused rest of the block to the free list
+        tree.add_free_block(static_cast<NodeIdx>(m_next - tree.m_nodes),
+                            static_cast<unsigned short>(m_end - m_next));
+    else
+        m_thread_storage.next = m_next;
     tree.link_children(node, m_first_child, nu_children);
 }
 
@@ -269,21 +507,76 @@ Tree<N>::Tree(size_t memory, unsigned nu_threads)
         min(max_nodes, static_cast<size_t>(numeric_limits<NodeIdx>::max()));
     m_nu_threads = nu_threads;
     m_max_nodes = max_nodes;
-    m_nodes = make_unique<Node[]>(max_nodes);
+    m_transpositions_mask = 0;
+    m_epoch.store(0, memory_order_relaxed);
     m_thread_storage = make_unique<ThreadStorage[]>(nu_threads);
     m_nodes_per_thread = max_nodes / nu_threads;
-    for (unsigned i = 0; i < nu_threads; ++i)
+    allocate_storage(m_huge_pages);
+    clear();
+}
+
+template<typename N>
+Tree<N>::~Tree()
+{
+    libboardgame_sys::release_memory(m_nodes, m_memory_size);
+}
+
+template<typename N>
+void Tree<N>::add_free_block(NodeIdx first_child, unsigned short nu_children)
+{
+    if (nu_children == 0)
+        return;
+    lock_guard<mutex> lock(m_free_mutex);
+    insert_free_block(first_child, nu_children);
+}
+
+/** Allocate the node storage.
+    The old storage is released only if the new storage could be allocated.
+    @throws bad_alloc If the storage cannot be allocated. In this case, the
+    old storage is kept. */
+template<typename N>
+void Tree<N>::allocate_storage(bool huge_pages)
+{
+    // Nodes are constructed when committed but never destructed
+    static_assert(is_trivially_destructible<Node>::value, "");
+    auto memory_size = m_max_nodes * sizeof(Node);
+    Node* nodes;
+    libboardgame_sys::PageType page_type;
+    if (huge_pages)
+        nodes = static_cast<Node*>(
+                    libboardgame_sys::allocate_huge_pages(memory_size,
+                                                          page_type));
+    else
+    {
+        nodes = static_cast<Node*>(
+                    libboardgame_sys::reserve_memory(memory_size));
+        page_type = libboardgame_sys::PageType::normal;
+    }
+    if (! nodes)
+        throw bad_alloc();
+    // The root node always needs to be accessible. Memory allocated with
+    // huge pages is already accessible.
+    if (! huge_pages && ! libboardgame_sys::commit_memory(nodes, sizeof(Node)))
+    {
+        libboardgame_sys::release_memory(nodes, memory_size);
+        throw bad_alloc();
+    }
+    new (nodes) Node;
+    libboardgame_sys::release_memory(m_nodes, m_memory_size);
+    m_nodes = nodes;
+    m_memory_size = memory_size;
+    m_huge_pages = huge_pages;
+    m_page_type = page_type;
+    for (unsigned i = 0; i < m_nu_threads; ++i)
     {
         auto& thread_storage = m_thread_storage[i];
-        thread_storage.begin = m_nodes.get() + i * m_nodes_per_thread;
+        thread_storage.begin = m_nodes + i * m_nodes_per_thread;
         thread_storage.end = thread_storage.begin + m_nodes_per_thread;
+        thread_storage.committed = thread_storage.begin;
     }
-    clear();
+    ++m_thread_storage[0].committed;
 }
 
-template<typename N>
-Tree<N>::~Tree() = default;
-
 template<typename N>
 inline void Tree<N>::add_value(const Node& node, Float v)
 {
@@ -299,73 +592,172 @@ inline void Tree<N>::add_value(const Node& node, Float v, Float weight)
 template<typename N>
 void Tree<N>::clear()
 {
-    m_thread_storage[0].next = m_thread_storage[0].begin + 1;
-    for (unsigned i = 1; i < m_nu_threads; ++i)
-        m_thread_storage[i].next = m_thread_storage[i].begin;
+    for (unsigned i = 0; i < m_nu_threads; ++i)
+    {
+        auto& thread_storage = m_thread_storage[i];
+        thread_storage.next = thread_storage.begin;
+        thread_storage.epoch.store(quiescent_epoch, memory_order_relaxed);
+    }
+    ++m_thread_storage[0].next;
+    m_free_by_pos.clear();
+    m_free_by_size.clear();
+    m_nu_free_nodes = 0;
+    m_retired.clear();
+    m_nu_retired_nodes = 0;
     m_nodes[0].init_root();
+    if (m_transpositions)
+        clear_transpositions();
 }
 
 template<typename N>
-bool Tree<N>::contains(const Node& node) const
+void Tree<N>::clear_transpositions()
 {
-    return &node >= m_nodes.get() && &node < m_nodes.get() + m_max_nodes;
+    for (size_t i = 0; i <= m_transpositions_mask; ++i)
+    {
+        auto& entry = m_transpositions[i];
+        entry.key_xor_data.store(0, memory_order_relaxed);
+        entry.data.store(0, memory_order_relaxed);
+    }
 }
 
+/** Clear the transposition table entries that refer to children that are not
+    in a set of kept children. */
 template<typename N>
-void Tree<N>::copy_subtree(Tree& target, const Node& target_node,
-                           const Node& node, Float min_count) const
+void Tree<N>::clear_transpositions(const unordered_set<NodeIdx>& kept)
 {
-    target.non_const(target_node).copy_data_from(node);
-    if (node.has_children())
-        copy_recurse(target, target_node, node, min_count);
-    else
-        target.non_const(target_node).unlink_children_st();
+    for (size_t i = 0; i <= m_transpositions_mask; ++i)
+    {
+        auto& entry = m_transpositions[i];
+        auto data = entry.data.load(memory_order_relaxed);
+        if (data != 0 && kept.count(static_cast<NodeIdx>(data >> 16)) == 0)
+        {
+            entry.key_xor_data.store(0, memory_order_relaxed);
+            entry.data.store(0, memory_order_relaxed);
+        }
+    }
 }
 
+/** Make sure that the storage of a thread is committed up to a given
+    node (exclusive).
+    @return @c false if the memory could not be committed */
 template<typename N>
-void Tree<N>::copy_recurse(Tree& target, const Node& target_node,
-                           const Node& node, Float min_count) const
+inline bool Tree<N>::commit(ThreadStorage& thread_storage, const Node* end)
+{
+    LIBBOARDGAME_ASSERT(end <= thread_storage.end);
+    if (end <= thread_storage.committed)
+        return true;
+    return commit_chunk_until(thread_storage, end);
+}
+
+/** Commit at least one chunk of the storage of a thread.
+    Committing in chunks avoids a system call at each node expansion. */
+template<typename N>
+bool Tree<N>::commit_chunk_until(ThreadStorage& thread_storage,
+                                 const Node* end)
+{
+    auto begin = thread_storage.committed;
+    auto new_committed = begin + max(static_cast<size_t>(end - begin),
+                                     commit_chunk);
+    new_committed = min(new_committed, thread_storage.end);
+    // Memory allocated with huge pages is already accessible
+    if (! m_huge_pages && ! libboardgame_sys::commit_memory(
+                begin, static_cast<size_t>(new_committed - begin)
+                * sizeof(Node)))
+        return false;
+    for (auto i = begin; i != new_committed; ++i)
+        new (i) Node;
+    thread_storage.committed = new_committed;
+    return true;
+}
+
+/** Insert all child blocks reachable from a node into a map from the first
+    child to the number of children. */
+template<typename N>
+void Tree<N>::collect_recurse(
+        const Node& node, unordered_map<NodeIdx, unsigned short>& blocks) const
 {
-    LIBBOARDGAME_ASSERT(target.m_max_nodes == m_max_nodes);
-    LIBBOARDGAME_ASSERT(target.m_nu_threads == m_nu_threads);
-    LIBBOARDGAME_ASSERT(contains(node));
     auto nu_children = node.get_nu_children();
-    auto& first_child = get_node(node.get_first_child());
-    // Create target children in the equivalent thread storage as in source.
-    // This ensures that the thread storage will not overflow (because the
-    // trees have identical nu_threads/max_nodes)
-    ThreadStorage& thread_storage =
-        target.m_thread_storage[get_thread_storage(first_child)];
-    auto target_child = thread_storage.next;
-    auto target_first_child =
-        static_cast<NodeIdx>(target_child - target.m_nodes.get());
-    target.non_const(target_node).link_children_st(target_first_child,
-                                                   nu_children);
-    thread_storage.next += nu_children;
-    // Parenthesis around thread_storage.next are needed because of a bug
-    // with GCC 4 ("parse error in template argument list")
-    LIBBOARDGAME_ASSERT((thread_storage.next) < thread_storage.end);
-    auto end = &first_child + node.get_nu_children();
-    for (auto i = &first_child; i != end; ++i, ++target_child)
+    if (nu_children == 0
+            || ! blocks.emplace(node.get_first_child(), nu_children).second)
+        return;
+    for (auto& i : get_children(node))
+        collect_recurse(i, blocks);
+}
+
+template<typename N>
+bool Tree<N>::contains(const Node& node) const
+{
+    return &node >= m_nodes && &node < m_nodes + m_max_nodes;
+}
+
+template<typename N>
+inline void Tree<N>::enter(unsigned thread_id)
+{
+    // Acquire pairs with the release in prune() and makes the unlinking of
+    // the children visible to the following simulation. Release pairs with
+    // the acquire in reclaim() and makes the accesses of the previous
+    // simulation happen before a reuse of the nodes.
+    m_thread_storage[thread_id].epoch.store(
+                m_epoch.load(memory_order_acquire), memory_order_release);
+}
+
+/** Put all child blocks reachable from a node on the free list, apart from
+    the subtree of a node that is kept.
+    @param node
+    @param keep
+    @param kept The first children of all child blocks in the kept subtree.
+    Used only (non-null) if children can be shared by several nodes.
+    @param visited The first children of the already visited child blocks.
+    Used only (non-null) if children can be shared by several nodes. */
+template<typename N>
+void Tree<N>::free_recurse(const Node& node, const Node& keep,
+                           const unordered_set<NodeIdx>* kept,
+                           unordered_set<NodeIdx>* visited)
+{
+    if (&node == &keep || ! node.has_children())
+        return;
+    auto first_child = node.get_first_child();
+    if (visited)
     {
-        target_child->copy_data_from(*i);
-        if (! i->has_children() || i->get_visit_count() < min_count)
-        {
-            target_child->unlink_children_st();
-            continue;
-        }
-        copy_recurse(target, *target_child, *i, min_count);
+        if (kept->count(first_child) != 0
+                || ! visited->insert(first_child).second)
+            return;
     }
+    for (auto& i : get_children(node))
+        free_recurse(i, keep, kept, visited);
+    add_free_block(first_child, node.get_nu_children());
 }
 
+/** Take the smallest block with at least a given size from the free list.
+    The unused rest of the block must be returned with add_free_block() after
+    the node expansion. */
 template<typename N>
-void Tree<N>::extract_subtree(Tree& target, const Node& node) const
+bool Tree<N>::get_free_block(unsigned short nu_children, Node*& begin,
+                             Node*& end)
 {
-    LIBBOARDGAME_ASSERT(contains(node));
-    LIBBOARDGAME_ASSERT(&target != this);
-    LIBBOARDGAME_ASSERT(target.m_max_nodes == m_max_nodes);
-    LIBBOARDGAME_ASSERT(! target.get_root().has_children());
-    copy_subtree(target, target.m_nodes[0], node, 0);
+    lock_guard<mutex> lock(m_free_mutex);
+    auto key = make_pair(static_cast<NodeIdx>(nu_children), NodeIdx(0));
+    auto pos = m_free_by_size.lower_bound(key);
+    if (pos == m_free_by_size.end())
+    {
+        if (! reclaim())
+            return false;
+        pos = m_free_by_size.lower_bound(key);
+        if (pos == m_free_by_size.end())
+            return false;
+    }
+    begin = m_nodes + pos->second;
+    end = begin + pos->first;
+    m_nu_free_nodes -= pos->first;
+    m_free_by_pos.erase(pos->second);
+    m_free_by_size.erase(pos);
+    return true;
+}
+
+template<typename N>
+size_t Tree<N>::get_huge_page_memory() const
+{
+    return libboardgame_sys::get_huge_page_memory(m_nodes, m_memory_size);
 }
 
 template<typename N>
@@ -373,11 +765,8 @@ size_t Tree<N>::get_nu_nodes() const
 {
     size_t result = 0;
     for (unsigned i = 0; i < m_nu_threads; ++i)
-    {
-        auto& thread_storage = m_thread_storage[i];
-        result += thread_storage.next - thread_storage.begin;
-    }
-    return result;
+        result += m_thread_storage[i].next - m_thread_storage[i].begin;
+    return result - m_nu_free_nodes - m_nu_retired_nodes;
 }
 
 template<typename N>
@@ -386,28 +775,90 @@ inline auto Tree<N>::get_root() const -> const Node&
     return m_nodes[0];
 }
 
-/** Get the thread storage a node belongs to. */
 template<typename N>
-inline unsigned Tree<N>::get_thread_storage(const Node& node) const
+inline void Tree<N>::inc_visit_count(const Node& node)
 {
-    size_t diff = &node - m_nodes.get();
-    return static_cast<unsigned>(diff / m_nodes_per_thread);
+    non_const(node).inc_visit_count();
 }
 
+/** Add a block to the free list and merge it with adjacent free blocks.
+    @pre m_free_mutex is locked */
 template<typename N>
-inline void Tree<N>::inc_visit_count(const Node& node)
+void Tree<N>::insert_free_block(NodeIdx first, NodeIdx size)
 {
-    non_const(node).inc_visit_count();
+    m_nu_free_nodes += size;
+    auto next = m_free_by_pos.lower_bound(first);
+    if (next != m_free_by_pos.end() && next->first == first + size)
+    {
+        m_free_by_size.erase(make_pair(next->second, next->first));
+        size += next->second;
+        next = m_free_by_pos.erase(next);
+    }
+    if (next != m_free_by_pos.begin())
+    {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == first)
+        {
+            m_free_by_size.erase(make_pair(prev->second, prev->first));
+            first = prev->first;
+            size += prev->second;
+            m_free_by_pos.erase(prev);
+        }
+    }
+    m_free_by_pos.emplace(first, size);
+    m_free_by_size.emplace(size, first);
+}
+
+template<typename N>
+inline void Tree<N>::leave(unsigned thread_id)
+{
+    m_thread_storage[thread_id].epoch.store(quiescent_epoch,
+                                            memory_order_release);
 }
 
 template<typename N>
 inline void Tree<N>::link_children(const Node& node, const Node* first_child,
                                    unsigned short nu_children)
 {
-    NodeIdx first_child_idx = static_cast<NodeIdx>(first_child - m_nodes.get());
-    LIBBOARDGAME_ASSERT(first_child_idx > 0);
-    LIBBOARDGAME_ASSERT(first_child_idx < m_max_nodes);
-    non_const(node).link_children(first_child_idx, nu_children);
+    link_children(node, static_cast<NodeIdx>(first_child - m_nodes),
+                  nu_children);
+}
+
+template<typename N>
+inline void Tree<N>::link_children(const Node& node, NodeIdx first_child,
+                                   unsigned short nu_children)
+{
+    LIBBOARDGAME_ASSERT(first_child > 0);
+    LIBBOARDGAME_ASSERT(first_child < m_max_nodes);
+    non_const(node).link_children(first_child, nu_children);
+}
+
+template<typename N>
+inline bool Tree<N>::lookup_transposition(uint64_t hash, NodeIdx& first_child,
+                                          unsigned short& nu_children) const
+{
+    LIBBOARDGAME_ASSERT(has_transpositions());
+    auto& entry = m_transpositions[hash & m_transpositions_mask];
+    // Acquire pairs with the release in store_transposition() and makes the
+    // initialization of the children visible
+    auto data = entry.data.load(memory_order_acquire);
+    if (data == 0
+            || (entry.key_xor_data.load(memory_order_relaxed) ^ data) != hash)
+        return false;
+    first_child = static_cast<NodeIdx>(data >> 16);
+    nu_children = static_cast<unsigned short>(data & 0xffff);
+    return true;
+}
+
+/** Insert the first children of all child blocks in a subtree into a set. */
+template<typename N>
+void Tree<N>::mark_recurse(const Node& node,
+                           unordered_set<NodeIdx>& kept) const
+{
+    if (! node.has_children() || ! kept.insert(node.get_first_child()).second)
+        return;
+    for (auto& i : get_children(node))
+        mark_recurse(i, kept);
 }
 
 /** Convert a const reference to node from user to a non-const reference.
@@ -427,23 +878,209 @@ inline void Tree<N>::add_value_remove_loss(const Node& node, Float v)
 }
 
 template<typename N>
-void Tree<N>::swap(Tree& tree)
+bool Tree<N>::prune(Float min_count, size_t& nu_nodes)
 {
-    // Reminder to update this function when the class gets additional members
-    struct Dummy
+    if (m_transpositions)
     {
-        unsigned m_nu_threads;
-        size_t m_max_nodes;
-        size_t m_nodes_per_thread;
-        unique_ptr<ThreadStorage> m_thread_storage;
-        unique_ptr<Node[]> m_nodes;
-    };
-    static_assert(sizeof(Tree) == sizeof(Dummy), "");
-    std::swap(m_nu_threads, tree.m_nu_threads);
-    std::swap(m_max_nodes, tree.m_max_nodes);
-    std::swap(m_nodes_per_thread, tree.m_nodes_per_thread);
-    m_thread_storage.swap(tree.m_thread_storage);
-    m_nodes.swap(tree.m_nodes);
+        prune_shared(min_count, nu_nodes);
+        return true;
+    }
+    {
+        lock_guard<mutex> lock(m_free_mutex);
+        if (! m_retired.empty())
+        {
+            reclaim();
+            return false;
+        }
+    }
+    auto epoch = m_epoch.load(memory_order_relaxed);
+    RetiredBlocks retired;
+    nu_nodes = 0;
+    for (auto& i : get_root_children())
+        prune_recurse(i, min_count, retired, nu_nodes);
+    {
+        lock_guard<mutex> lock(m_free_mutex);
+        m_retired.swap(retired);
+        m_nu_retired_nodes = nu_nodes;
+        m_retired_epoch = epoch;
+    }
+    // Release pairs with the acquire in enter(), see there
+    m_epoch.fetch_add(1, memory_order_release);
+    return true;
+}
+
+template<typename N>
+void Tree<N>::prune_recurse(const Node& node, Float min_count,
+                            RetiredBlocks& retired, size_t& nu_nodes)
+{
+    // Children can only be added concurrently to nodes without children, so
+    // nu_children cannot change between reading and unlinking
+    auto nu_children = node.get_nu_children();
+    if (nu_children == 0)
+        return;
+    if (node.get_visit_count() >= min_count)
+    {
+        for (auto& i : get_children(node))
+            prune_recurse(i, min_count, retired, nu_nodes);
+        return;
+    }
+    auto first_child = node.get_first_child();
+    non_const(node).unlink_children();
+    retire_recurse(first_child, nu_children, retired, nu_nodes);
+}
+
+/** Prune a tree with shared children.
+    Unlinks the children of nodes below the minimum count and puts all
+    children on the free list that are not reachable anymore afterwards. */
+template<typename N>
+void Tree<N>::prune_shared(Float min_count, size_t& nu_nodes)
+{
+    unordered_map<NodeIdx, unsigned short> blocks;
+    collect_recurse(get_root(), blocks);
+    for (auto& i : blocks)
+    {
+        auto begin = &get_node(i.first);
+        for (auto j = begin; j != begin + i.second; ++j)
+            if (j->get_visit_count() < min_count)
+                non_const(*j).unlink_children_st();
+    }
+    unordered_set<NodeIdx> kept;
+    mark_recurse(get_root(), kept);
+    nu_nodes = 0;
+    for (auto& i : blocks)
+        if (kept.count(i.first) == 0)
+        {
+            add_free_block(i.first, i.second);
+            nu_nodes += i.second;
+        }
+    clear_transpositions(kept);
+}
+
+/** Move the retired blocks to the free list if no thread can access them
+    anymore.
+    @pre m_free_mutex is locked */
+template<typename N>
+bool Tree<N>::reclaim()
+{
+    if (m_retired.empty())
+        return false;
+    for (unsigned i = 0; i < m_nu_threads; ++i)
+    {
+        auto epoch = m_thread_storage[i].epoch.load(memory_order_acquire);
+        if (epoch <= m_retired_epoch)
+            return false;
+    }
+    // Other threads could have linked children to nodes in the retired
+    // blocks after retire_recurse() read their number of children. No thread
+    // can access the retired blocks anymore, so now all children are known.
+    unordered_set<NodeIdx> retired_first_children;
+    for (auto& i : m_retired)
+        retired_first_children.insert(i.first);
+    for (size_t i = 0; i < m_retired.size(); ++i)
+    {
+        auto begin = &get_node(m_retired[i].first);
+        auto end = begin + m_retired[i].second;
+        for (auto j = begin; j != end; ++j)
+        {
+            auto nu_children = j->get_nu_children();
+            if (nu_children > 0
+                    && retired_first_children.insert(
+                        j->get_first_child()).second)
+                m_retired.emplace_back(j->get_first_child(), nu_children);
+        }
+    }
+    for (auto& i : m_retired)
+        insert_free_block(i.first, i.second);
+    m_retired.clear();
+    m_nu_retired_nodes = 0;
+    return true;
+}
+
+template<typename N>
+void Tree<N>::reroot(const Node& node)
+{
+    LIBBOARDGAME_ASSERT(contains(node));
+    LIBBOARDGAME_ASSERT(&node != &get_root());
+    auto nu_children = node.get_nu_children();
+    auto first_child = nu_children > 0 ? node.get_first_child() : 0;
+    if (m_transpositions)
+    {
+        unordered_set<NodeIdx> kept;
+        unordered_set<NodeIdx> visited;
+        mark_recurse(node, kept);
+        free_recurse(get_root(), node, &kept, &visited);
+        clear_transpositions(kept);
+    }
+    else
+        free_recurse(get_root(), node, nullptr, nullptr);
+    auto& root = non_const(get_root());
+    root.copy_data_from(node);
+    if (nu_children > 0)
+        root.link_children_st(first_child, nu_children);
+    else
+        root.unlink_children_st();
+}
+
+/** Add a child block and all child blocks below it to a list of retired
+    blocks. */
+template<typename N>
+void Tree<N>::retire_recurse(NodeIdx first_child, unsigned short nu_children,
+                             RetiredBlocks& retired, size_t& nu_nodes)
+{
+    retired.emplace_back(first_child, nu_children);
+    nu_nodes += nu_children;
+    auto begin = &get_node(first_child);
+    for (auto i = begin; i != begin + nu_children; ++i)
+    {
+        // The nodes below are not reachable anymore but we don't unlink their
+        // children, other threads could still be in this subtree. Children
+        // linked by other threads after this point are added in reclaim().
+        auto nu_grand_children = i->get_nu_children();
+        if (nu_grand_children > 0)
+            retire_recurse(i->get_first_child(), nu_grand_children, retired,
+                           nu_nodes);
+    }
+}
+
+template<typename N>
+void Tree<N>::set_huge_pages(bool enable)
+{
+    if (enable == m_huge_pages)
+        return;
+    allocate_storage(enable);
+    clear();
+}
+
+template<typename N>
+void Tree<N>::set_transpositions(bool enable)
+{
+    if (! enable)
+    {
+        m_transpositions.reset();
+        m_transpositions_mask = 0;
+    }
+    else if (! m_transpositions)
+    {
+        size_t size = 1;
+        while (size < m_max_nodes / 16)
+            size *= 2;
+        m_transpositions = make_unique<TranspositionEntry[]>(size);
+        m_transpositions_mask = size - 1;
+    }
+    clear();
+}
+
+template<typename N>
+inline void Tree<N>::store_transposition(uint64_t hash, const Node& node)
+{
+    LIBBOARDGAME_ASSERT(has_transpositions());
+    LIBBOARDGAME_ASSERT(node.has_children());
+    static_assert(sizeof(NodeIdx) <= 6, "");
+    auto data = (static_cast<uint64_t>(node.get_first_child()) << 16)
+            | node.get_nu_children();
+    auto& entry = m_transpositions[hash & m_transpositions_mask];
+    entry.key_xor_data.store(hash ^ data, memory_order_relaxed);
+    entry.data.store(data, memory_order_release);
 }
 
 //-----------------------------------------------------------------------------
@@ -12,12 +12,15 @@
 
 #include <cctype>
 #include <cstdio>
-#include <fstream>
+#include <istream>
+#include "libboardgame_sys/MappedFile.h"
 #include "libboardgame_util/Assert.h"
 #include "libboardgame_util/Unused.h"
 
 namespace libboardgame_sgf {
 
+using libboardgame_sys::MappedFile;
+
 //-----------------------------------------------------------------------------
 
 namespace {
@@ -29,6 +32,46 @@ bool is_ascii_space(int c)
     return c >= 0 && c < 128 && isspace(c);
 }
 
+/** Copy the text of a game tree from a stream.
+    Reads until the parenthesis that closes the first tree, skipping
+    parentheses in property values. Leading whitespace is skipped. If the
+    input does not start with a tree or the tree is incomplete, the copied
+    text is not a valid tree and the parser reports the error. */
+void read_tree_text(istream& in, string& buffer)
+{
+    buffer.clear();
+    while (is_ascii_space(in.peek()))
+        in.get();
+    int depth = 0;
+    bool is_in_value = false;
+    int c;
+    while ((c = in.get()) != EOF)
+    {
+        buffer += static_cast<char>(c);
+        if (is_in_value)
+        {
+            if (c == '\\')
+            {
+                c = in.get();
+                if (c == EOF)
+                    break;
+                buffer += static_cast<char>(c);
+            }
+            else if (c == ']')
+                is_in_value = false;
+            continue;
+        }
+        if (c == '[')
+            is_in_value = true;
+        else if (c == '(')
+            ++depth;
+        else if (c == ')')
+            --depth;
+        if (depth <= 0)
+            break;
+    }
+}
+
 } // namespace
 
 //-----------------------------------------------------------------------------
@@ -48,7 +91,7 @@ void Reader::consume_char(char expected)
 void Reader::consume_whitespace()
 {
     while (is_ascii_space(peek()))
-        m_in->get();
+        ++m_pos;
 }
 
 void Reader::on_begin_node(bool is_root)
@@ -74,7 +117,7 @@ void Reader::on_end_tree(bool is_root)
     LIBBOARDGAME_UNUSED(is_root);
 }
 
-void Reader::on_property(const string& id, const vector<string>& values)
+void Reader::on_property(StringView id, const vector<StringView>& values)
 {
     // Default implementation does nothing
     LIBBOARDGAME_UNUSED(id);
@@ -83,24 +126,49 @@ void Reader::on_property(const string& id, const vector<string>& values)
 
 char Reader::peek()
 {
-    int c = m_in->peek();
-    if (c == EOF)
+    if (m_pos == m_end)
         throw ReadError("Unexpected end of input");
-    return char(c);
+    return *m_pos;
 }
 
 bool Reader::read(istream& in, bool check_single_tree)
 {
-    m_in = &in;
+    read_tree_text(in, m_tree_buffer);
+    const char* pos = m_tree_buffer.data();
+    read(pos, pos + m_tree_buffer.size(), true);
+    while (true)
+    {
+        int c = in.peek();
+        if (c == EOF)
+            return false;
+        else if (c == '(')
+        {
+            if (check_single_tree)
+                throw ReadError("Input has multiple game trees");
+            else
+                return true;
+        }
+        else if (is_ascii_space(c))
+            in.get();
+        else
+            throw ReadError("Extra characters after end of tree.");
+    }
+}
+
+bool Reader::read(const char*& pos, const char* end, bool check_single_tree)
+{
+    m_pos = pos;
+    m_end = end;
     m_is_in_main_variation = true;
     consume_whitespace();
     read_tree(true);
     while (true)
     {
-        int c = m_in->peek();
-        if (c == EOF)
+        pos = m_pos;
+        if (m_pos == m_end)
             return false;
-        else if (c == '(')
+        char c = *m_pos;
+        if (c == '(')
         {
             if (check_single_tree)
                 throw ReadError("Input has multiple game trees");
@@ -108,7 +176,7 @@ bool Reader::read(istream& in, bool check_single_tree)
                 return true;
         }
         else if (is_ascii_space(c))
-            m_in->get();
+            ++m_pos;
         else
             throw ReadError("Extra characters after end of tree.");
     }
@@ -116,12 +184,13 @@ bool Reader::read(istream& in, bool check_single_tree)
 
 void Reader::read(const string& file)
 {
-    ifstream in(file);
-    if (! in)
+    MappedFile mapped_file;
+    if (! mapped_file.open(file))
         throw ReadError("Could not open '" + file + "'");
     try
     {
-        read(in);
+        const char* pos = mapped_file.get_data();
+        read(pos, pos + mapped_file.get_size());
     }
     catch (const ReadError& e)
     {
@@ -131,17 +200,17 @@ void Reader::read(const string& file)
 
 char Reader::read_char()
 {
-    int c = m_in->get();
-    if (c == EOF)
+    if (m_pos == m_end)
         throw ReadError("Unexpected end of SGF stream");
+    char c = *(m_pos++);
     if (c == '\r')
     {
         // Convert CR+LF or single CR into LF
         if (peek() == '\n')
-            m_in->get();
+            ++m_pos;
         return '\n';
     }
-    return char(c);
+    return c;
 }
 
 void Reader::read_expected(char expected)
@@ -175,50 +244,41 @@ void Reader::read_property()
             read_char();
         while (peek() == '[')
         {
-            consume_char('[');
-            bool escape = false;
-            while (peek() != ']' || escape)
-            {
-                char c = read_char();
-                if (c == '\\' && ! escape)
-                {
-                    escape = true;
-                    continue;
-                }
-                escape = false;
-            }
-            consume_char(']');
+            skip_value();
             consume_whitespace();
         }
+        return;
+    }
+    auto begin = m_pos;
+    bool has_cr = false;
+    char c;
+    while ((c = peek()) != '[')
+    {
+        has_cr = (has_cr || c == '\r');
+        ++m_pos;
     }
-    else
+    StringView id(begin, static_cast<size_t>(m_pos - begin));
+    if (has_cr)
     {
+        m_pos = begin;
         m_id.clear();
         while (peek() != '[')
             m_id += read_char();
-        m_values.clear();
-        while (peek() == '[')
-        {
-            consume_char('[');
-            m_value.clear();
-            bool escape = false;
-            while (peek() != ']' || escape)
-            {
-                char c = read_char();
-                if (c == '\\' && ! escape)
-                {
-                    escape = true;
-                    continue;
-                }
-                escape = false;
-                m_value += c;
-            }
-            consume_char(']');
-            consume_whitespace();
-            m_values.push_back(m_value);
-        }
-        on_property(m_id, m_values);
+        id = m_id;
     }
+    m_values.clear();
+    m_unescaped.clear();
+    m_unescaped_values.clear();
+    while (peek() == '[')
+    {
+        m_values.push_back(read_value());
+        consume_whitespace();
+    }
+    // Views into m_unescaped can only be created after all values were
+    // read because m_unescaped might have been reallocated
+    for (auto& i : m_unescaped_values)
+        m_values[i[0]] = StringView(m_unescaped.data() + i[1], i[2]);
+    on_property(id, m_values);
 }
 
 void Reader::read_tree(bool is_root)
@@ -247,6 +307,59 @@ void Reader::read_tree(bool is_root)
     on_end_tree(was_root);
 }
 
+StringView Reader::read_value()
+{
+    consume_char('[');
+    auto begin = m_pos;
+    char c;
+    while ((c = peek()) != ']')
+    {
+        if (c == '\\' || c == '\r')
+        {
+            // Value needs to be unescaped
+            m_pos = begin;
+            auto start = m_unescaped.size();
+            bool escape = false;
+            while (peek() != ']' || escape)
+            {
+                c = read_char();
+                if (c == '\\' && ! escape)
+                {
+                    escape = true;
+                    continue;
+                }
+                escape = false;
+                m_unescaped += c;
+            }
+            consume_char(']');
+            m_unescaped_values.push_back({{ m_values.size(), start,
+                                           m_unescaped.size() - start }});
+            return StringView();
+        }
+        ++m_pos;
+    }
+    StringView value(begin, static_cast<size_t>(m_pos - begin));
+    consume_char(']');
+    return value;
+}
+
+void Reader::skip_value()
+{
+    consume_char('[');
+    bool escape = false;
+    while (peek() != ']' || escape)
+    {
+        char c = read_char();
+        if (c == '\\' && ! escape)
+        {
+            escape = true;
+            continue;
+        }
+        escape = false;
+    }
+    consume_char(']');
+}
+
 //-----------------------------------------------------------------------------
 
 } // namespace libboardgame_sgf
@@ -7,17 +7,27 @@
 #ifndef LIBBOARDGAME_SGF_READER_H
 #define LIBBOARDGAME_SGF_READER_H
 
+#include <array>
 #include <iosfwd>
 #include <stdexcept>
 #include <string>
 #include <vector>
+#include "libboardgame_util/StringView.h"
 
 namespace libboardgame_sgf {
 
 using namespace std;
+using libboardgame_util::StringView;
 
 //-----------------------------------------------------------------------------
 
+/** Parser for SGF files.
+    The parser works on the input in memory. Files are mapped into memory
+    (see libboardgame_sys::MappedFile), streams are read into a buffer before
+    parsing. The parser reports the tree structure and the properties with
+    virtual functions. Property identifiers and values are passed as views
+    into the input and are only copied if a value contains escape characters
+    or line breaks that need to be converted. */
 class Reader
 {
 public:
@@ -39,7 +49,10 @@ public:
 
     virtual void on_end_node();
 
-    virtual void on_property(const string& id, const vector<string>& values);
+    /** Handle a property.
+        The values are already unescaped and line breaks are converted to
+        LF. The id and the values are only valid during the call. */
+    virtual void on_property(StringView id, const vector<StringView>& values);
 
     /** Read only the main variation.
         Reduces CPU time and memory if only the main variation is needed. */
@@ -52,9 +65,23 @@ public:
         non-whitespace characters follow after the first tree before the end of
         the stream.
         @return true, if there are more trees to read in the stream.
+        The stream is read only up to the end of the tree and the following
+        whitespace, so a further call with the same stream reads the next
+        tree. The text of the tree is copied into a buffer and then parsed
+        like input in memory.
         @throws ReadError */
     bool read(istream& in, bool check_single_tree = true);
 
+    /** Read a game tree from memory.
+        @param[in,out] pos The start of the input. On return, the position
+        after the tree and trailing whitespace.
+        @param end The end of the input.
+        @param check_single_tree See read(istream&, bool)
+        @return true, if there are more trees to read in the input.
+        @throws ReadError */
+    bool read(const char*& pos, const char* end,
+              bool check_single_tree = true);
+
     void read(const string& file);
 
 private:
@@ -62,19 +89,32 @@ private:
 
     bool m_is_in_main_variation;
 
-    istream* m_in;
+    const char* m_pos;
+
+    const char* m_end;
+
+    /** Text of the tree in read(istream&, bool).
+        Reused for efficiency. */
+    string m_tree_buffer;
 
     /** Local variable in read_property().
+        Only used if the id contains line breaks that need to be converted.
         Reused for efficiency. */
     string m_id;
 
     /** Local variable in read_property().
         Reused for efficiency. */
-    string m_value;
+    vector<StringView> m_values;
 
-    /** Local variable in read_property().
+    /** Storage for the values in m_values that could not be referenced in
+        the input because they needed to be unescaped.
+        Reused for efficiency. */
+    string m_unescaped;
+
+    /** Index in m_values, start in m_unescaped and size of each value
+        stored in m_unescaped.
         Reused for efficiency. */
-    vector<string> m_values;
+    vector<array<size_t, 3>> m_unescaped_values;
 
     void consume_char(char expected);
 
@@ -91,6 +131,10 @@ private:
     void read_property();
 
     void read_tree(bool is_root);
+
+    StringView read_value();
+
+    void skip_value();
 };
 
 inline void Reader::set_read_only_main_variation(bool enable)
@@ -0,0 +1,72 @@
+//-----------------------------------------------------------------------------
+/** @file libboardgame_sgf/SgfCollection.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "SgfCollection.h"
+
+#include <fstream>
+#include "libboardgame_util/Log.h"
+
+namespace libboardgame_sgf {
+
+//-----------------------------------------------------------------------------
+
+StringView SgfCollection::get_game(size_t n) const
+{
+    auto& entry = get_entry(n);
+    return StringView(m_file.get_data() + entry.offset,
+                      static_cast<size_t>(entry.size));
+}
+
+void SgfCollection::open(const string& file)
+{
+    m_index.clear();
+    if (! m_file.open(file))
+        throw Reader::ReadError("Could not open '" + file + "'");
+    auto index_file = SgfIndex::get_index_file(file);
+    {
+        ifstream in(index_file);
+        if (in)
+            try
+            {
+                m_index.read(in);
+            }
+            catch (const runtime_error&)
+            {
+                LIBBOARDGAME_LOG("WARNING: Invalid index file '", index_file,
+                                 "'");
+            }
+    }
+    try
+    {
+        if (! m_index.update(m_file.get_data(), m_file.get_size()))
+            return;
+    }
+    catch (const Reader::ReadError& e)
+    {
+        m_file.close();
+        m_index.clear();
+        throw Reader::ReadError("Could not read '" + file + "': " + e.what());
+    }
+    ofstream out(index_file);
+    m_index.write(out);
+    if (! out)
+        LIBBOARDGAME_LOG("WARNING: Could not write '", index_file, "'");
+}
+
+void SgfCollection::read(Reader& reader, size_t n) const
+{
+    auto game = get_game(n);
+    auto pos = game.begin();
+    reader.read(pos, game.end());
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace libboardgame_sgf
@@ -0,0 +1,64 @@
+//-----------------------------------------------------------------------------
+/** @file libboardgame_sgf/SgfCollection.h
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifndef LIBBOARDGAME_SGF_SGF_COLLECTION_H
+#define LIBBOARDGAME_SGF_SGF_COLLECTION_H
+
+#include "Reader.h"
+#include "SgfIndex.h"
+#include "libboardgame_sys/MappedFile.h"
+#include "libboardgame_util/Assert.h"
+
+namespace libboardgame_sgf {
+
+using libboardgame_sys::MappedFile;
+
+//-----------------------------------------------------------------------------
+
+/** SGF file with multiple games and random access to the games.
+    The file is mapped into memory and the games are located with the index
+    file (see SgfIndex). If the index file does not exist or does not
+    contain all games, the missing games are indexed and the index file is
+    updated.
+    Games can be read concurrently from several threads if each thread uses
+    its own Reader, so a collection can be processed in parallel by
+    splitting the range of game numbers into chunks. */
+class SgfCollection
+{
+public:
+    /** Open a file.
+        @throws Reader::ReadError If the file cannot be opened or contains
+        invalid games that need to be indexed. */
+    void open(const string& file);
+
+    size_t get_nu_games() const { return m_index.size(); }
+
+    const SgfIndex::Entry& get_entry(size_t n) const;
+
+    /** Get the text of a game tree in the file. */
+    StringView get_game(size_t n) const;
+
+    /** Read a game tree with a reader.
+        @throws Reader::ReadError */
+    void read(Reader& reader, size_t n) const;
+
+private:
+    MappedFile m_file;
+
+    SgfIndex m_index;
+};
+
+inline const SgfIndex::Entry& SgfCollection::get_entry(size_t n) const
+{
+    LIBBOARDGAME_ASSERT(n < m_index.size());
+    return m_index[n];
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace libboardgame_sgf
+
+#endif // LIBBOARDGAME_SGF_SGF_COLLECTION_H
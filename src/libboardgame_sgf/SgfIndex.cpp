@@ -0,0 +1,216 @@
+//-----------------------------------------------------------------------------
+/** @file libboardgame_sgf/SgfIndex.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "SgfIndex.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include "Reader.h"
+
+namespace libboardgame_sgf {
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+bool is_ascii_space(char c)
+{
+    return c >= 0 && isspace(c);
+}
+
+/** Parse a number followed by a tab or the end of the line. */
+template<typename T>
+bool parse_column(const char*& pos, T& value)
+{
+    if (! isdigit(static_cast<unsigned char>(*pos)))
+        return false;
+    char* end;
+    auto n = strtoull(pos, &end, 10);
+    if (*end != '\t' && *end != '\0' && *end != '\r')
+        return false;
+    value = static_cast<T>(n);
+    if (value != n)
+        return false;
+    pos = (*end == '\t' ? end + 1 : end);
+    return true;
+}
+
+/** Reader that gets the length and the result of a game. */
+class IndexReader
+    : public Reader
+{
+public:
+    unsigned length;
+
+    string result;
+
+    IndexReader();
+
+    void on_begin_tree(bool is_root) override;
+
+    void on_begin_node(bool is_root) override;
+
+    void on_property(StringView id, const vector<StringView>& values)
+    override;
+
+private:
+    bool m_is_root;
+};
+
+IndexReader::IndexReader()
+{
+    set_read_only_main_variation(true);
+}
+
+void IndexReader::on_begin_node(bool is_root)
+{
+    m_is_root = is_root;
+    if (! is_root)
+        ++length;
+}
+
+void IndexReader::on_begin_tree(bool is_root)
+{
+    if (is_root)
+    {
+        length = 0;
+        result.clear();
+    }
+}
+
+void IndexReader::on_property(StringView id,
+                              const vector<StringView>& values)
+{
+    if (m_is_root && id == "RE")
+        result = values[0].to_string();
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+bool SgfIndex::append(const string& file, const vector<Entry>& entries)
+{
+    auto index_file = get_index_file(file);
+    bool exists = ! ifstream(index_file).fail();
+    ofstream out(index_file, ios::app);
+    if (! exists)
+        write_header(out);
+    for (auto& entry : entries)
+        write(out, entry);
+    out.flush();
+    return ! out.fail();
+}
+
+uint64_t SgfIndex::check_entries(const char* data, size_t size)
+{
+    auto data_size = static_cast<uint64_t>(size);
+    uint64_t pos = 0;
+    for (auto& entry : m_entries)
+    {
+        bool is_valid = (entry.offset >= pos && entry.size >= 2
+                         && entry.offset <= data_size
+                         && entry.size <= data_size - entry.offset
+                         && data[entry.offset] == '('
+                         && data[entry.offset + entry.size - 1] == ')');
+        for (auto i = pos; is_valid && i < entry.offset; ++i)
+            is_valid = is_ascii_space(data[i]);
+        if (! is_valid)
+        {
+            m_entries.clear();
+            return 0;
+        }
+        pos = entry.offset + entry.size;
+    }
+    return pos;
+}
+
+string SgfIndex::get_index_file(const string& file)
+{
+    return file + ".idx";
+}
+
+void SgfIndex::read(istream& in)
+{
+    m_entries.clear();
+    string line;
+    while (getline(in, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+        Entry entry;
+        auto pos = line.c_str();
+        if (! parse_column(pos, entry.offset)
+                || ! parse_column(pos, entry.size)
+                || ! parse_column(pos, entry.length))
+        {
+            m_entries.clear();
+            throw runtime_error("invalid SGF index");
+        }
+        entry.result = pos;
+        if (! entry.result.empty() && entry.result.back() == '\r')
+            entry.result.pop_back();
+        m_entries.push_back(move(entry));
+    }
+}
+
+bool SgfIndex::update(const char* data, size_t size)
+{
+    auto old_nu_entries = m_entries.size();
+    auto begin = data + check_entries(data, size);
+    bool was_changed = (m_entries.size() != old_nu_entries);
+    auto end = data + size;
+    IndexReader reader;
+    while (true)
+    {
+        while (begin != end && is_ascii_space(*begin))
+            ++begin;
+        if (begin == end)
+            break;
+        auto pos = begin;
+        reader.read(pos, end, false);
+        // read() also skipped the whitespace after the tree
+        auto tree_end = pos;
+        while (is_ascii_space(*(tree_end - 1)))
+            --tree_end;
+        m_entries.push_back({ static_cast<uint64_t>(begin - data),
+                              static_cast<uint64_t>(tree_end - begin),
+                              reader.length, reader.result });
+        was_changed = true;
+        begin = pos;
+    }
+    return was_changed;
+}
+
+void SgfIndex::write(ostream& out) const
+{
+    write_header(out);
+    for (auto& entry : m_entries)
+        write(out, entry);
+}
+
+void SgfIndex::write(ostream& out, const Entry& entry)
+{
+    out << entry.offset << '\t' << entry.size << '\t' << entry.length
+        << '\t';
+    for (char c : entry.result)
+        out << (c == '\t' || c == '\n' || c == '\r' ? ' ' : c);
+    out << '\n';
+}
+
+void SgfIndex::write_header(ostream& out)
+{
+    out << "# Offset\tSize\tLength\tResult\n";
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace libboardgame_sgf
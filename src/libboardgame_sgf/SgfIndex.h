@@ -0,0 +1,96 @@
+//-----------------------------------------------------------------------------
+/** @file libboardgame_sgf/SgfIndex.h
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifndef LIBBOARDGAME_SGF_SGF_INDEX_H
+#define LIBBOARDGAME_SGF_SGF_INDEX_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace libboardgame_sgf {
+
+using namespace std;
+
+//-----------------------------------------------------------------------------
+
+/** Index of the game trees in a multi-game SGF file.
+    Programs that append many games to a single SGF file (twogtp, the
+    selfplay GTP command) also write an index file with the position of each
+    game in the file (see get_index_file()). With the index, a game can be
+    read without parsing the games before it, see SgfCollection.
+
+    The index file is a text file with one line per game containing the
+    offset and the size of the game in bytes, the length and the result
+    separated by tabs. Lines starting with # are comments. */
+class SgfIndex
+{
+public:
+    struct Entry
+    {
+        /** Position of the start of the game tree in the file in bytes. */
+        uint64_t offset;
+
+        /** Size of the game tree in bytes. */
+        uint64_t size;
+
+        /** Number of nodes in the main variation after the root node.
+            For games without setup nodes, this is the number of moves. */
+        unsigned length;
+
+        /** Value of the RE property of the root node or empty if the game
+            has no result. */
+        string result;
+    };
+
+    /** Get the name of the index file for an SGF file. */
+    static string get_index_file(const string& file);
+
+    /** Append entries to the index file of an SGF file.
+        Creates the index file if it does not exist.
+        @return @c false if the index file could not be written. */
+    static bool append(const string& file, const vector<Entry>& entries);
+
+    void clear() { m_entries.clear(); }
+
+    /** Index the game trees of an SGF file in memory.
+        The current entries are kept if they describe game trees at the start
+        of the data without other content between them, such that only the
+        game trees after them need to be parsed. Otherwise, the index is
+        created from scratch.
+        @return @c true if the entries were changed.
+        @throws Reader::ReadError If a game tree that needs to be parsed is
+        not valid. */
+    bool update(const char* data, size_t size);
+
+    /** Read the entries in the format of the index file.
+        @throws runtime_error If the input is not a valid index. */
+    void read(istream& in);
+
+    void write(ostream& out) const;
+
+    size_t size() const { return m_entries.size(); }
+
+    const Entry& operator[](size_t i) const { return m_entries[i]; }
+
+private:
+    vector<Entry> m_entries;
+
+    static void write(ostream& out, const Entry& entry);
+
+    static void write_header(ostream& out);
+
+    /** Get the position after the last valid entry.
+        Returns 0 and clears the entries if any entry is not valid. */
+    uint64_t check_entries(const char* data, size_t size);
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace libboardgame_sgf
+
+#endif // LIBBOARDGAME_SGF_SGF_INDEX_H
@@ -11,20 +11,63 @@
 #include "SgfNode.h"
 
 #include <algorithm>
+#include <mutex>
+#include <unordered_set>
 #include "SgfError.h"
 #include "libboardgame_util/Assert.h"
+#include "libboardgame_util/Unused.h"
 
 namespace libboardgame_sgf {
 
 //-----------------------------------------------------------------------------
 
+namespace {
+
+typedef libboardgame_util::MemoryPool<sizeof(SgfNode), alignof(SgfNode)>
+NodePool;
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+const string& intern_property_id(const string& id)
+{
+    // Allocated once and never deleted, such that the strings are still
+    // valid during the destruction of global objects
+    static auto ids = new unordered_set<string>;
+    static mutex ids_mutex;
+    lock_guard<mutex> lock(ids_mutex);
+    return *ids->insert(id).first;
+}
+
+//-----------------------------------------------------------------------------
+
 Property::~Property() = default;
 
 //-----------------------------------------------------------------------------
 
 SgfNode::SgfNode() = default;
 
-SgfNode::~SgfNode() = default;
+SgfNode::~SgfNode()
+{
+    // Move the children to a list of nodes to delete, which is linked by
+    // m_sibling. When a node from the list is deleted, its children are
+    // moved to the front of the list first, such that no node is deleted
+    // while it still owns other nodes.
+    auto node = move(m_first_child);
+    while (node)
+    {
+        if (node->m_first_child)
+        {
+            auto last = node->m_first_child.get();
+            while (last->m_sibling)
+                last = last->m_sibling.get();
+            last->m_sibling = move(node->m_sibling);
+            node->m_sibling = move(node->m_first_child);
+        }
+        node = move(node->m_sibling);
+    }
+}
 
 void SgfNode::append(unique_ptr<SgfNode> node)
 {
@@ -54,8 +97,8 @@ void SgfNode::delete_variations()
         m_first_child->m_sibling.reset(nullptr);
 }
 
-forward_list<Property>::const_iterator SgfNode::find_property(
-        const string& id) const
+auto SgfNode::find_property(const string& id) const
+-> PropertyList::const_iterator
 {
     return find_if(m_properties.begin(), m_properties.end(),
                    [&](const Property& p) { return p.id == id; });
@@ -182,7 +225,7 @@ void SgfNode::make_first_child()
 bool SgfNode::move_property_to_front(const string& id)
 {
     auto i = m_properties.begin();
-    forward_list<Property>::const_iterator previous = m_properties.end();
+    PropertyList::const_iterator previous = m_properties.end();
     for ( ; i != m_properties.end(); ++i)
         if (i->id == id)
             break;
@@ -255,7 +298,7 @@ void SgfNode::move_up()
 
 bool SgfNode::remove_property(const string& id)
 {
-    forward_list<Property>::const_iterator previous = m_properties.end();
+    PropertyList::const_iterator previous = m_properties.end();
     for (auto i = m_properties.begin() ; i != m_properties.end(); ++i)
         if (i->id == id)
         {
@@ -270,6 +313,18 @@ bool SgfNode::remove_property(const string& id)
     return false;
 }
 
+void* SgfNode::operator new(size_t size)
+{
+    LIBBOARDGAME_ASSERT(size == sizeof(SgfNode));
+    LIBBOARDGAME_UNUSED_IF_NOT_DEBUG(size);
+    return NodePool::allocate();
+}
+
+void SgfNode::operator delete(void* p)
+{
+    NodePool::deallocate(p);
+}
+
 unique_ptr<SgfNode> SgfNode::remove_child(SgfNode& child)
 {
     auto node = &m_first_child;
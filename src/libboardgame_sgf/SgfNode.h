@@ -13,6 +13,7 @@
 #include <vector>
 #include "SgfError.h"
 #include "libboardgame_util/Assert.h"
+#include "libboardgame_util/MemoryPool.h"
 #include "libboardgame_util/StringUtil.h"
 
 namespace libboardgame_sgf {
@@ -20,28 +21,39 @@ namespace libboardgame_sgf {
 using namespace std;
 using libboardgame_util::from_string;
 using libboardgame_util::to_string;
+using libboardgame_util::PoolAllocator;
+
+//-----------------------------------------------------------------------------
+
+/** Get a unique copy of a property identifier.
+    Returns a reference to a string that is equal to the argument and stays
+    valid until the end of the program. All properties with the same
+    identifier share the same string, there are only few different
+    identifiers even in large files.
+    This function is thread-safe. */
+const string& intern_property_id(const string& id);
 
 //-----------------------------------------------------------------------------
 
 struct Property
 {
-    string id;
+    /** The identifier.
+        Refers to the string returned by intern_property_id(). */
+    const string& id;
 
     vector<string> values;
 
-    unique_ptr<Property> next;
-
     Property(const Property& p)
         : id(p.id),
           values(p.values)
     { }
 
-    Property(const string& id, const vector<string>& values)
-        : id(id),
-          values(values)
+    Property(const string& id, vector<string> values)
+        : id(intern_property_id(id)),
+          values(move(values))
     {
         LIBBOARDGAME_ASSERT(! id.empty());
-        LIBBOARDGAME_ASSERT(! values.empty());
+        LIBBOARDGAME_ASSERT(! this->values.empty());
     }
 
     ~Property();
@@ -114,8 +126,22 @@ public:
         Iterator m_begin;
     };
 
+    /** The list type of the properties of a node. */
+    typedef forward_list<Property, PoolAllocator<Property>> PropertyList;
+
+    /** Allocate nodes from a memory pool.
+        Reading and deleting large trees creates and deletes many nodes,
+        which is much faster with a pool and saves the per-allocation
+        overhead of the general-purpose allocator. */
+    static void* operator new(size_t size);
+
+    static void operator delete(void* p);
+
     SgfNode();
 
+    /** Destructor.
+        Deletes the subtree without recursion, such that very deep trees
+        cannot cause a stack overflow. */
     ~SgfNode();
 
     /** Append a new child. */
@@ -160,7 +186,7 @@ public:
         front. */
     bool move_property_to_front(const string& id);
 
-    const forward_list<Property>& get_properties() const
+    const PropertyList& get_properties() const
     {
         return m_properties;
     }
@@ -247,9 +273,9 @@ private:
     /** The properties.
         Often a node has only one property (the move), so it saves memory
         to use a forward_list instead of a vector. */
-    forward_list<Property> m_properties;
+    PropertyList m_properties;
 
-    forward_list<Property>::const_iterator find_property(
+    PropertyList::const_iterator find_property(
             const string& id) const;
 
     SgfNode* get_last_child() const;
@@ -366,22 +392,23 @@ template<typename T>
 bool SgfNode::set_property(const string& id, const vector<T>& values)
 {
     vector<string> values_to_string;
+    values_to_string.reserve(values.size());
     for (const T& v : values)
         values_to_string.push_back(to_string(v));
-    forward_list<Property>::const_iterator last = m_properties.end();
+    PropertyList::const_iterator last = m_properties.end();
     for (auto i = m_properties.begin(); i != m_properties.end(); ++i)
         if (i->id == id)
         {
             bool was_changed = (i->values != values_to_string);
-            i->values = values_to_string;
+            i->values = move(values_to_string);
             return was_changed;
         }
         else
             last = i;
     if (last == m_properties.end())
-        m_properties.emplace_front(id, values_to_string);
+        m_properties.emplace_front(id, move(values_to_string));
     else
-        m_properties.emplace_after(last, id, values_to_string);
+        m_properties.emplace_after(last, id, move(values_to_string));
     return true;
 }
 
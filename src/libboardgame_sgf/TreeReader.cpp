@@ -54,10 +54,14 @@ void TreeReader::on_end_node()
 {
 }
 
-void TreeReader::on_property(const string& identifier,
-                             const vector<string>& values)
+void TreeReader::on_property(StringView id,
+                             const vector<StringView>& values)
 {
-    m_current->set_property(identifier, values);
+    m_id.assign(id.begin(), id.end());
+    m_values.resize(values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+        m_values[i].assign(values[i].begin(), values[i].end());
+    m_current->set_property(m_id, m_values);
 }
 
 //-----------------------------------------------------------------------------
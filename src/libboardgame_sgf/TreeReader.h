@@ -34,8 +34,8 @@ public:
 
     void on_end_node() override;
 
-    void on_property(const string& identifier,
-                     const vector<string>& values) override;
+    void on_property(StringView id,
+                     const vector<StringView>& values) override;
 
     const SgfNode& get_tree() const { return *m_root; }
 
@@ -48,6 +48,14 @@ private:
     unique_ptr<SgfNode> m_root;
 
     stack<SgfNode*> m_stack;
+
+    /** Local variable in on_property().
+        Reused for efficiency. */
+    string m_id;
+
+    /** Local variable in on_property().
+        Reused for efficiency. */
+    vector<string> m_values;
 };
 
 //-----------------------------------------------------------------------------
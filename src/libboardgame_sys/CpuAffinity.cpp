@@ -0,0 +1,170 @@
+//-----------------------------------------------------------------------------
+/** @file libboardgame_sys/CpuAffinity.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "CpuAffinity.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#if HAVE_SCHED_H
+#include <sched.h>
+#endif
+
+namespace libboardgame_sys {
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+/** Get the CPUs that the current thread is allowed to run on. */
+vector<unsigned> get_thread_cpus()
+{
+    vector<unsigned> result;
+
+#ifdef _WIN32
+
+    // There is no function to query the thread affinity mask on Windows
+    // without setting it, but setting the current mask again returns it.
+    DWORD_PTR process_mask;
+    DWORD_PTR system_mask;
+    if (! GetProcessAffinityMask(GetCurrentProcess(), &process_mask,
+                                 &system_mask))
+        return result;
+    auto mask = SetThreadAffinityMask(GetCurrentThread(), process_mask);
+    if (mask == 0)
+        return result;
+    SetThreadAffinityMask(GetCurrentThread(), mask);
+    for (unsigned i = 0; i < 8 * sizeof(DWORD_PTR); ++i)
+        if (mask & (static_cast<DWORD_PTR>(1) << i))
+            result.push_back(i);
+
+#elif HAVE_SCHED_H && defined CPU_SET
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    // On Linux, pid 0 refers to the calling thread
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        for (unsigned i = 0; i < CPU_SETSIZE; ++i)
+            if (CPU_ISSET(i, &set))
+                result.push_back(i);
+
+#endif
+
+    return result;
+}
+
+/** Allow the current thread to run on a set of CPUs. */
+void set_thread_cpus(const vector<unsigned>& cpus)
+{
+#ifdef _WIN32
+
+    DWORD_PTR mask = 0;
+    for (auto cpu : cpus)
+        mask |= static_cast<DWORD_PTR>(1) << cpu;
+    SetThreadAffinityMask(GetCurrentThread(), mask);
+
+#elif HAVE_SCHED_H && defined CPU_SET
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : cpus)
+        CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+
+#else
+
+    static_cast<void>(cpus);
+
+#endif
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+vector<unsigned> get_available_cpus()
+{
+    vector<unsigned> result;
+
+#ifdef _WIN32
+
+    DWORD_PTR process_mask;
+    DWORD_PTR system_mask;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask,
+                               &system_mask))
+        for (unsigned i = 0; i < 8 * sizeof(DWORD_PTR); ++i)
+            if (process_mask & (static_cast<DWORD_PTR>(1) << i))
+                result.push_back(i);
+
+#elif HAVE_SCHED_H && defined CPU_SET
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        for (unsigned i = 0; i < CPU_SETSIZE; ++i)
+            if (CPU_ISSET(i, &set))
+                result.push_back(i);
+
+#endif
+
+    return result;
+}
+
+bool set_thread_affinity(unsigned cpu)
+{
+#ifdef _WIN32
+
+    if (cpu >= 8 * sizeof(DWORD_PTR))
+        return false;
+    return SetThreadAffinityMask(GetCurrentThread(),
+                                 static_cast<DWORD_PTR>(1) << cpu) != 0;
+
+#elif HAVE_SCHED_H && defined CPU_SET
+
+    if (cpu >= CPU_SETSIZE)
+        return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    // On Linux, pid 0 refers to the calling thread
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+
+#else
+
+    static_cast<void>(cpu);
+    return false;
+
+#endif
+}
+
+//-----------------------------------------------------------------------------
+
+ScopedThreadAffinity::~ScopedThreadAffinity()
+{
+    if (m_is_bound)
+        set_thread_cpus(m_old_cpus);
+}
+
+bool ScopedThreadAffinity::bind(unsigned cpu)
+{
+    if (m_is_bound)
+        // Keep the affinity from before the first call
+        return set_thread_affinity(cpu);
+    m_old_cpus = get_thread_cpus();
+    if (m_old_cpus.empty())
+        return false;
+    m_is_bound = set_thread_affinity(cpu);
+    return m_is_bound;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace libboardgame_sys
@@ -0,0 +1,67 @@
+//-----------------------------------------------------------------------------
+/** @file libboardgame_sys/CpuAffinity.h
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifndef LIBBOARDGAME_SYS_CPU_AFFINITY_H
+#define LIBBOARDGAME_SYS_CPU_AFFINITY_H
+
+#include <vector>
+
+namespace libboardgame_sys {
+
+using namespace std;
+
+//-----------------------------------------------------------------------------
+
+/** Get the CPUs that the current process is allowed to run on.
+    @return The CPU numbers or an empty vector if they cannot be
+    determined. */
+vector<unsigned> get_available_cpus();
+
+/** Bind the current thread to a CPU.
+    Memory pages are usually allocated on the NUMA node of the CPU that
+    accesses them first, so pinning the threads of a search also keeps the
+    memory they initialize local to them.
+    @return @c false if thread affinity is not supported on this system or
+    the CPU does not exist. */
+bool set_thread_affinity(unsigned cpu);
+
+//-----------------------------------------------------------------------------
+
+/** Binds the current thread to a CPU until the object is destroyed.
+    The destructor restores the previous affinity of the thread, so that
+    threads that later do other work (e.g. the workers of a thread pool or
+    the thread that started a search) are not left bound to the CPU.
+    The object must be destroyed in the thread that called bind(). */
+class ScopedThreadAffinity
+{
+public:
+    ScopedThreadAffinity() = default;
+
+    ScopedThreadAffinity(const ScopedThreadAffinity&) = delete;
+
+    ScopedThreadAffinity& operator=(const ScopedThreadAffinity&) = delete;
+
+    ~ScopedThreadAffinity();
+
+    /** Bind the current thread to a CPU.
+        If bind() is called again, the destructor still restores the
+        affinity from before the first call.
+        @return @c false if the thread could not be bound or if its current
+        affinity could not be determined. */
+    bool bind(unsigned cpu);
+
+private:
+    bool m_is_bound = false;
+
+    /** The CPUs that the thread was allowed to run on before bind(). */
+    vector<unsigned> m_old_cpus;
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace libboardgame_sys
+
+#endif // LIBBOARDGAME_SYS_CPU_AFFINITY_H
@@ -0,0 +1,55 @@
+//-----------------------------------------------------------------------------
+/** @file libboardgame_sys/Directory.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "Directory.h"
+
+#include <algorithm>
+#include <sys/stat.h>
+
+#if HAVE_DIRENT_H
+#include <dirent.h>
+#endif
+
+namespace libboardgame_sys {
+
+//-----------------------------------------------------------------------------
+
+bool is_directory(const string& path)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+        return false;
+    return (st.st_mode & S_IFMT) == S_IFDIR;
+}
+
+bool list_directory(const string& path, vector<string>& names)
+{
+    names.clear();
+#if HAVE_DIRENT_H
+    auto dir = opendir(path.c_str());
+    if (! dir)
+        return false;
+    while (auto entry = readdir(dir))
+    {
+        string name = entry->d_name;
+        if (name != "." && name != "..")
+            names.push_back(name);
+    }
+    closedir(dir);
+    sort(names.begin(), names.end());
+    return true;
+#else
+    return false;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace libboardgame_sys
@@ -0,0 +1,33 @@
+//-----------------------------------------------------------------------------
+/** @file libboardgame_sys/Directory.h
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifndef LIBBOARDGAME_SYS_DIRECTORY_H
+#define LIBBOARDGAME_SYS_DIRECTORY_H
+
+#include <string>
+#include <vector>
+
+namespace libboardgame_sys {
+
+using namespace std;
+
+//-----------------------------------------------------------------------------
+
+/** Check if a path is a directory. */
+bool is_directory(const string& path);
+
+/** Get the names of the entries in a directory.
+    The names do not include the path of the directory, the entries . and ..
+    are not included. The names are sorted.
+    @return @c false if the directory could not be read or if the system does
+    not support listing directories. */
+bool list_directory(const string& path, vector<string>& names);
+
+//-----------------------------------------------------------------------------
+
+} // namespace libboardgame_sys
+
+#endif // LIBBOARDGAME_SYS_DIRECTORY_H
@@ -0,0 +1,94 @@
+//-----------------------------------------------------------------------------
+/** @file libboardgame_sys/MappedFile.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "MappedFile.h"
+
+#include <fstream>
+#include <iterator>
+#if HAVE_SYS_MMAN_H
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace libboardgame_sys {
+
+//-----------------------------------------------------------------------------
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+void MappedFile::close()
+{
+#if HAVE_SYS_MMAN_H
+    if (m_is_mapped)
+        munmap(const_cast<char*>(m_data), m_size);
+#endif
+    m_is_open = false;
+    m_is_mapped = false;
+    m_data = nullptr;
+    m_size = 0;
+    m_buffer.clear();
+    m_buffer.shrink_to_fit();
+}
+
+bool MappedFile::open(const string& path)
+{
+    close();
+#if HAVE_SYS_MMAN_H
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    auto size = static_cast<size_t>(st.st_size);
+    if (size > 0)
+    {
+        void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+        {
+            ::close(fd);
+            m_data = static_cast<const char*>(data);
+            m_size = size;
+            m_is_mapped = true;
+            m_is_open = true;
+            return true;
+        }
+    }
+    ::close(fd);
+    // Fall back to reading the file, mmap() fails for empty files and
+    // might not be supported by all file systems
+#endif
+    ifstream in(path, ios::binary);
+    if (! in)
+        return false;
+    m_buffer.assign(istreambuf_iterator<char>(in),
+                    istreambuf_iterator<char>());
+    if (in.bad())
+    {
+        m_buffer.clear();
+        return false;
+    }
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+    m_is_open = true;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace libboardgame_sys
@@ -0,0 +1,67 @@
+//-----------------------------------------------------------------------------
+/** @file libboardgame_sys/MappedFile.h
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifndef LIBBOARDGAME_SYS_MAPPED_FILE_H
+#define LIBBOARDGAME_SYS_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace libboardgame_sys {
+
+using namespace std;
+
+//-----------------------------------------------------------------------------
+
+/** Read-only view of the content of a file.
+    Uses a read-only memory mapping if mmap() is available, such that opening
+    a file does not read it and the pages can be shared between processes.
+    Otherwise the file is read into memory. */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /** Open a file.
+        Closes the currently open file.
+        @return @c false if the file could not be opened. */
+    bool open(const string& path);
+
+    void close();
+
+    bool is_open() const { return m_is_open; }
+
+    /** Get the content of the file.
+        Valid until the file is closed. May be null if the file is empty. */
+    const char* get_data() const { return m_data; }
+
+    size_t get_size() const { return m_size; }
+
+private:
+    bool m_is_open = false;
+
+    bool m_is_mapped = false;
+
+    const char* m_data = nullptr;
+
+    size_t m_size = 0;
+
+    /** Content of the file if it was read instead of mapped. */
+    vector<char> m_buffer;
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace libboardgame_sys
+
+#endif // LIBBOARDGAME_SYS_MAPPED_FILE_H
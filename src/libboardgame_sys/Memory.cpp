@@ -14,8 +14,16 @@
 #include <algorithm>
 #include <windows.h>
 #else
+#include <cstdlib>
 #include <unistd.h>
 #endif
+#if HAVE_SYS_MMAN_H
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sys/mman.h>
+#endif
 // sysctl() is unsupported on Linux with x32 ABI (last checked on Ubuntu 14.10)
 #if HAVE_SYS_SYSCTL_H && ! (defined __x86_64__ && defined __ILP32__)
 #include <sys/sysctl.h>
@@ -25,6 +33,146 @@ namespace libboardgame_sys {
 
 //-----------------------------------------------------------------------------
 
+namespace {
+
+#if HAVE_SYS_MMAN_H && defined MAP_HUGETLB
+
+/** Get the default size of explicit huge pages. */
+size_t get_huge_page_size()
+{
+    ifstream in("/proc/meminfo");
+    string line;
+    while (getline(in, line))
+    {
+        istringstream s(line);
+        string key;
+        size_t value;
+        if (s >> key >> value && key == "Hugepagesize:")
+            return value * 1024;
+    }
+    return 2 * 1024 * 1024;
+}
+
+#endif
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+void* allocate_huge_pages(size_t& size, PageType& page_type)
+{
+#if HAVE_SYS_MMAN_H
+
+#ifdef MAP_HUGETLB
+    auto huge_page_size = get_huge_page_size();
+    auto huge_size = (size + huge_page_size - 1) / huge_page_size
+            * huge_page_size;
+    // Don't use MAP_NORESERVE here, the mapping must fail if the huge page
+    // pool is too small, otherwise the first access of an unavailable page
+    // causes SIGBUS
+    auto p = mmap(nullptr, huge_size, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED)
+    {
+        size = huge_size;
+        page_type = PageType::huge;
+        return p;
+    }
+#endif
+    auto q = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (q == MAP_FAILED)
+        return nullptr;
+    page_type = PageType::normal;
+#ifdef MADV_HUGEPAGE
+    if (madvise(q, size, MADV_HUGEPAGE) == 0)
+        page_type = PageType::transparent_huge;
+#endif
+    return q;
+
+#else
+
+    page_type = PageType::normal;
+    auto p = reserve_memory(size);
+    if (p && ! commit_memory(p, size))
+    {
+        release_memory(p, size);
+        return nullptr;
+    }
+    return p;
+
+#endif
+}
+
+bool commit_memory(void* p, size_t size)
+{
+#ifdef _WIN32
+
+    return VirtualAlloc(p, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+
+#elif HAVE_SYS_MMAN_H
+
+    static const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    auto begin = reinterpret_cast<uintptr_t>(p);
+    auto end = begin + size;
+    begin -= begin % page_size;
+    end = (end + page_size - 1) / page_size * page_size;
+    return mprotect(reinterpret_cast<void*>(begin), end - begin,
+                    PROT_READ | PROT_WRITE) == 0;
+
+#else
+
+    static_cast<void>(p);
+    static_cast<void>(size);
+    return true;
+
+#endif
+}
+
+size_t get_huge_page_memory(const void* p, size_t size)
+{
+#if HAVE_SYS_MMAN_H
+
+    // Sum up the huge page sizes of the mappings in /proc/self/smaps that
+    // start in the range
+    auto begin = reinterpret_cast<uintptr_t>(p);
+    auto end = begin + size;
+    ifstream in("/proc/self/smaps");
+    string line;
+    bool is_in_range = false;
+    size_t result = 0;
+    while (getline(in, line))
+    {
+        istringstream s(line);
+        string key;
+        s >> key;
+        auto pos = key.find('-');
+        if (pos != string::npos && key.back() != ':')
+        {
+            uintptr_t start;
+            istringstream(key.substr(0, pos)) >> hex >> start;
+            is_in_range = (start >= begin && start < end);
+        }
+        else if (is_in_range && (key == "AnonHugePages:"
+                                 || key == "Private_Hugetlb:"
+                                 || key == "Shared_Hugetlb:"))
+        {
+            size_t value;
+            if (s >> value)
+                result += value * 1024;
+        }
+    }
+    return result;
+
+#else
+
+    static_cast<void>(p);
+    static_cast<void>(size);
+    return 0;
+
+#endif
+}
+
 size_t get_memory()
 {
 #ifdef _WIN32
@@ -65,6 +213,46 @@ size_t get_memory()
 #endif
 }
 
+void release_memory(void* p, size_t size)
+{
+    if (! p)
+        return;
+#ifdef _WIN32
+
+    static_cast<void>(size);
+    VirtualFree(p, 0, MEM_RELEASE);
+
+#elif HAVE_SYS_MMAN_H
+
+    munmap(p, size);
+
+#else
+
+    static_cast<void>(size);
+    free(p);
+
+#endif
+}
+
+void* reserve_memory(size_t size)
+{
+#ifdef _WIN32
+
+    return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+
+#elif HAVE_SYS_MMAN_H
+
+    auto p = mmap(nullptr, size, PROT_NONE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return p != MAP_FAILED ? p : nullptr;
+
+#else
+
+    return malloc(size);
+
+#endif
+}
+
 //-----------------------------------------------------------------------------
 
 } // namespace libboardgame_sys
@@ -15,10 +15,61 @@ using namespace std;
 
 //-----------------------------------------------------------------------------
 
+/** Type of the pages backing memory allocated with allocate_huge_pages(). */
+enum class PageType
+{
+    normal,
+
+    /** Transparent huge pages were requested with madvise().
+        Whether the kernel really uses huge pages depends on the system
+        configuration and available memory, see get_huge_page_memory(). */
+    transparent_huge,
+
+    /** Explicit huge pages (MAP_HUGETLB). */
+    huge
+};
+
+//-----------------------------------------------------------------------------
+
+/** Allocate memory backed by huge pages if possible.
+    Tries explicit huge pages first, then transparent huge pages, and falls
+    back to normal pages. Unlike reserve_memory(), the memory can be accessed
+    immediately, but physical memory is still used only when the pages are
+    accessed for the first time.
+    @param[in,out] size The size of the memory. Rounded up to a multiple of
+    the huge page size if huge pages are used.
+    @param[out] page_type The type of pages obtained.
+    @return The start address or null if the memory could not be allocated.
+    Must be released with release_memory() and the returned size. */
+void* allocate_huge_pages(size_t& size, PageType& page_type);
+
+/** Get the amount of a memory range that is currently backed by huge pages.
+    @return The memory in bytes or 0 if it could not be determined. */
+size_t get_huge_page_memory(const void* p, size_t size);
+
 /** Get the physical memory available on the system.
     @return The memory in bytes or 0 if the memory could not be determined. */
 size_t get_memory();
 
+/** Reserve address space without using physical memory.
+    The memory must be committed with commit_memory() before it is accessed.
+    On systems that do not support reserving address space, the memory is
+    allocated immediately.
+    @return The start address or null if the memory could not be reserved. */
+void* reserve_memory(size_t size);
+
+/** Commit a range of memory reserved with reserve_memory().
+    The range is extended to page boundaries. Physical memory is used only
+    when the pages are accessed for the first time.
+    @return @c false if the memory could not be committed. */
+bool commit_memory(void* p, size_t size);
+
+/** Release memory reserved with reserve_memory() or allocated with
+    allocate_huge_pages().
+    @param p The start address
+    @param size The size of the memory */
+void release_memory(void* p, size_t size);
+
 //-----------------------------------------------------------------------------
 
 } // namespace libboardgame_sys
@@ -0,0 +1,38 @@
+//-----------------------------------------------------------------------------
+/** @file libboardgame_sys/Process.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "Process.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+namespace libboardgame_sys {
+
+//-----------------------------------------------------------------------------
+
+unsigned long get_process_id()
+{
+#ifdef _WIN32
+    return GetCurrentProcessId();
+#elif HAVE_UNISTD_H
+    return static_cast<unsigned long>(getpid());
+#else
+    return 0;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace libboardgame_sys
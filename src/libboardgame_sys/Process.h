@@ -0,0 +1,22 @@
+//-----------------------------------------------------------------------------
+/** @file libboardgame_sys/Process.h
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifndef LIBBOARDGAME_SYS_PROCESS_H
+#define LIBBOARDGAME_SYS_PROCESS_H
+
+namespace libboardgame_sys {
+
+//-----------------------------------------------------------------------------
+
+/** Get the ID of the current process.
+    @return The process ID or 0 if it cannot be determined on this system. */
+unsigned long get_process_id();
+
+//-----------------------------------------------------------------------------
+
+} // namespace libboardgame_sys
+
+#endif // LIBBOARDGAME_SYS_PROCESS_H
@@ -11,6 +11,7 @@
 #include "Assert.h"
 
 #include <list>
+#include <mutex>
 #include "Unused.h"
 
 #if LIBBOARDGAME_DEBUG
@@ -36,17 +37,27 @@ list<AssertionHandler*>& get_all_handlers()
     return all_handlers;
 }
 
+/** Protects the list of all handlers against concurrent construction or
+    destruction of handlers. */
+mutex& get_all_handlers_mutex()
+{
+    static mutex all_handlers_mutex;
+    return all_handlers_mutex;
+}
+
 } // namespace
 
 //----------------------------------------------------------------------------
 
 AssertionHandler::AssertionHandler()
 {
+    lock_guard<mutex> lock(get_all_handlers_mutex());
     get_all_handlers().push_back(this);
 }
 
 AssertionHandler::~AssertionHandler()
 {
+    lock_guard<mutex> lock(get_all_handlers_mutex());
     get_all_handlers().remove(this);
 }
 
@@ -0,0 +1,136 @@
+//-----------------------------------------------------------------------------
+/** @file libboardgame_util/MemoryPool.h
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifndef LIBBOARDGAME_UTIL_MEMORY_POOL_H
+#define LIBBOARDGAME_UTIL_MEMORY_POOL_H
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace libboardgame_util {
+
+using namespace std;
+
+//-----------------------------------------------------------------------------
+
+/** Thread-safe pool of memory blocks of a fixed size.
+    Intended for small objects that are created and destroyed in large
+    numbers, like the nodes of game trees. The blocks are requested from the
+    system in large chunks and reused after they are freed, which avoids the
+    per-allocation overhead of the general-purpose allocator. The chunks are
+    never returned to the system.
+    @tparam S The size of a block
+    @tparam A The alignment of a block */
+template<size_t S, size_t A>
+class MemoryPool
+{
+public:
+    static void* allocate();
+
+    static void deallocate(void* p);
+
+private:
+    union Block
+    {
+        Block* next;
+
+        alignas(A) char data[S];
+    };
+
+    static const size_t chunk_size = 1024;
+
+    static mutex s_mutex;
+
+    static Block* s_free;
+};
+
+template<size_t S, size_t A>
+mutex MemoryPool<S, A>::s_mutex;
+
+template<size_t S, size_t A>
+typename MemoryPool<S, A>::Block* MemoryPool<S, A>::s_free = nullptr;
+
+template<size_t S, size_t A>
+void* MemoryPool<S, A>::allocate()
+{
+    lock_guard<mutex> lock(s_mutex);
+    if (! s_free)
+    {
+        // Intentionally never deleted, blocks may still be in use during
+        // the destruction of global objects
+        auto chunk = new Block[chunk_size];
+        for (size_t i = 0; i < chunk_size - 1; ++i)
+            chunk[i].next = &chunk[i + 1];
+        chunk[chunk_size - 1].next = nullptr;
+        s_free = chunk;
+    }
+    auto block = s_free;
+    s_free = block->next;
+    return block;
+}
+
+template<size_t S, size_t A>
+void MemoryPool<S, A>::deallocate(void* p)
+{
+    if (! p)
+        return;
+    auto block = static_cast<Block*>(p);
+    lock_guard<mutex> lock(s_mutex);
+    block->next = s_free;
+    s_free = block;
+}
+
+//-----------------------------------------------------------------------------
+
+/** Allocator using a MemoryPool for single objects.
+    Can be used for node-based standard containers. Allocations of more than
+    one object use the global operator new. */
+template<typename T>
+class PoolAllocator
+{
+public:
+    typedef T value_type;
+
+    PoolAllocator() = default;
+
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>&) { }
+
+    T* allocate(size_t n)
+    {
+        if (n == 1)
+            return static_cast<T*>(
+                        MemoryPool<sizeof(T), alignof(T)>::allocate());
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        if (n == 1)
+            MemoryPool<sizeof(T), alignof(T)>::deallocate(p);
+        else
+            ::operator delete(p);
+    }
+};
+
+template<typename T, typename U>
+bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&)
+{
+    return true;
+}
+
+template<typename T, typename U>
+bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&)
+{
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace libboardgame_util
+
+#endif // LIBBOARDGAME_UTIL_MEMORY_POOL_H
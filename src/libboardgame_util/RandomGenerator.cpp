@@ -11,6 +11,7 @@
 #include "RandomGenerator.h"
 
 #include <list>
+#include <mutex>
 
 namespace libboardgame_util {
 
@@ -28,6 +29,14 @@ list<RandomGenerator*>& get_all_generators()
     return all_generators;
 }
 
+/** Protects the list of all generators, such that generators can be
+    constructed and destroyed in different threads at the same time. */
+mutex& get_all_generators_mutex()
+{
+    static mutex all_generators_mutex;
+    return all_generators_mutex;
+}
+
 RandomGenerator::ResultType get_nondet_seed()
 {
     random_device generator;
@@ -41,11 +50,13 @@ RandomGenerator::ResultType get_nondet_seed()
 RandomGenerator::RandomGenerator()
 {
     set_seed(is_seed_set ? the_seed : get_nondet_seed());
+    lock_guard<mutex> lock(get_all_generators_mutex());
     get_all_generators().push_back(this);
 }
 
 RandomGenerator::~RandomGenerator()
 {
+    lock_guard<mutex> lock(get_all_generators_mutex());
     get_all_generators().remove(this);
 }
 
@@ -58,15 +69,18 @@ void RandomGenerator::set_global_seed(ResultType seed)
 {
     is_seed_set = true;
     the_seed = seed;
+    lock_guard<mutex> lock(get_all_generators_mutex());
     for (RandomGenerator* i : get_all_generators())
         i->set_seed(the_seed);
 }
 
 void RandomGenerator::set_global_seed_last()
 {
-    if (is_seed_set)
-        for (RandomGenerator* i : get_all_generators())
-            i->set_seed(the_seed);
+    if (! is_seed_set)
+        return;
+    lock_guard<mutex> lock(get_all_generators_mutex());
+    for (RandomGenerator* i : get_all_generators())
+        i->set_seed(the_seed);
 }
 
 //-----------------------------------------------------------------------------
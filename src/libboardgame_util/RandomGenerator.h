@@ -22,6 +22,8 @@ using namespace std;
     All instances of this class register themselves automatically at a
     global list of random generators, such that the random seed can be
     changed at all existing generators with a single function call.
+    Generators can be constructed and destroyed concurrently in different
+    threads.
     (@ref libboardgame_doc_threadsafe_after_construction) */
 class RandomGenerator
 {
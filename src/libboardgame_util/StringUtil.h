@@ -45,6 +45,14 @@ string to_string(const T& t)
     return buffer.str();
 }
 
+/** Overload of to_string() for strings.
+    Avoids the stream conversion, which is slow and was a bottleneck when
+    reading large SGF files. */
+inline string to_string(const string& s)
+{
+    return s;
+}
+
 string to_lower(string s);
 
 string trim(const string& s);
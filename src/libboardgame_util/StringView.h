@@ -0,0 +1,82 @@
+//-----------------------------------------------------------------------------
+/** @file libboardgame_util/StringView.h
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifndef LIBBOARDGAME_UTIL_STRING_VIEW_H
+#define LIBBOARDGAME_UTIL_STRING_VIEW_H
+
+#include <cstring>
+#include <string>
+#include "Assert.h"
+
+namespace libboardgame_util {
+
+using namespace std;
+
+//-----------------------------------------------------------------------------
+
+/** Non-owning reference to a sequence of characters.
+    Subset of std::string_view, which is not available in C++14. The
+    referenced characters must stay valid while the view is used. */
+class StringView
+{
+public:
+    StringView() = default;
+
+    StringView(const char* data, size_t size)
+        : m_data(data),
+          m_size(size)
+    { }
+
+    StringView(const char* s)
+        : m_data(s),
+          m_size(strlen(s))
+    { }
+
+    StringView(const string& s)
+        : m_data(s.data()),
+          m_size(s.size())
+    { }
+
+    char operator[](size_t i) const
+    {
+        LIBBOARDGAME_ASSERT(i < m_size);
+        return m_data[i];
+    }
+
+    const char* data() const { return m_data; }
+
+    size_t size() const { return m_size; }
+
+    bool empty() const { return m_size == 0; }
+
+    const char* begin() const { return m_data; }
+
+    const char* end() const { return m_data + m_size; }
+
+    string to_string() const { return string(m_data, m_size); }
+
+private:
+    const char* m_data = nullptr;
+
+    size_t m_size = 0;
+};
+
+inline bool operator==(StringView s1, StringView s2)
+{
+    return s1.size() == s2.size()
+            && (s1.size() == 0 || memcmp(s1.data(), s2.data(), s1.size()) == 0);
+}
+
+inline bool operator!=(StringView s1, StringView s2)
+{
+    return ! (s1 == s2);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace libboardgame_util
+
+#endif // LIBBOARDGAME_UTIL_STRING_VIEW_H
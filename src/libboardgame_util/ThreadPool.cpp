@@ -0,0 +1,182 @@
+//-----------------------------------------------------------------------------
+/** @file libboardgame_util/ThreadPool.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "ThreadPool.h"
+
+#include "Assert.h"
+
+namespace libboardgame_util {
+
+//----------------------------------------------------------------------------
+
+constexpr chrono::microseconds ThreadPool::spin_time;
+
+ThreadPool::ThreadPool() = default;
+
+ThreadPool::~ThreadPool()
+{
+    m_quit.store(true);
+    {
+        lock_guard<mutex> lock(m_sleep_mutex);
+    }
+    m_wake_up.notify_all();
+    for (unsigned i = 0; i < m_nu_workers.load(); ++i)
+        m_workers[i]->thr.join();
+}
+
+void ThreadPool::finish_task(TaskGroup& group)
+{
+    // Decrement while holding the mutex, such that wait() cannot return and
+    // the group cannot be destroyed before we are done with it.
+    lock_guard<mutex> lock(group.m_mutex);
+    if (--group.m_nu_unfinished == 0)
+        group.m_finished.notify_all();
+}
+
+ThreadPool& ThreadPool::get_global()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+bool ThreadPool::pop_task(unsigned worker, QueuedTask& queued_task)
+{
+    {
+        auto& w = *m_workers[worker];
+        lock_guard<mutex> lock(w.queue_mutex);
+        if (! w.queue.empty())
+        {
+            queued_task = move(w.queue.back());
+            w.queue.pop_back();
+            --m_nu_queued;
+            return true;
+        }
+    }
+    auto nu_workers = get_nu_workers();
+    for (unsigned i = 1; i < nu_workers; ++i)
+    {
+        auto& w = *m_workers[(worker + i) % nu_workers];
+        lock_guard<mutex> lock(w.queue_mutex);
+        if (! w.queue.empty())
+        {
+            queued_task = move(w.queue.front());
+            w.queue.pop_front();
+            --m_nu_queued;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::reserve(unsigned nu_workers)
+{
+    if (nu_workers > max_workers)
+        nu_workers = max_workers;
+    lock_guard<mutex> lock(m_reserve_mutex);
+    for (unsigned i = m_nu_workers.load(); i < nu_workers; ++i)
+    {
+        m_workers[i] = make_unique<Worker>();
+        m_nu_workers.store(i + 1, memory_order_release);
+        m_workers[i]->thr = thread(&ThreadPool::worker_main, this, i);
+    }
+}
+
+bool ThreadPool::steal_task(const TaskGroup& group, QueuedTask& queued_task)
+{
+    auto nu_workers = get_nu_workers();
+    for (unsigned i = 0; i < nu_workers; ++i)
+    {
+        auto& w = *m_workers[i];
+        lock_guard<mutex> lock(w.queue_mutex);
+        for (auto j = w.queue.begin(); j != w.queue.end(); ++j)
+            if (j->group == &group)
+            {
+                queued_task = move(*j);
+                w.queue.erase(j);
+                --m_nu_queued;
+                return true;
+            }
+    }
+    return false;
+}
+
+void ThreadPool::submit(TaskGroup& group, Task task)
+{
+    auto nu_workers = get_nu_workers();
+    LIBBOARDGAME_ASSERT(nu_workers > 0);
+    ++group.m_nu_unfinished;
+    auto& w = *m_workers[m_next_queue++ % nu_workers];
+    ++m_nu_queued;
+    {
+        lock_guard<mutex> lock(w.queue_mutex);
+        w.queue.push_back({move(task), &group});
+    }
+    // Only workers that already blocked need a notification, spinning
+    // workers see the new value of m_nu_queued. Taking the mutex ensures
+    // that a worker that is about to block does not miss the notification.
+    if (m_nu_sleeping.load() > 0)
+    {
+        {
+            lock_guard<mutex> lock(m_sleep_mutex);
+        }
+        m_wake_up.notify_one();
+    }
+}
+
+void ThreadPool::wait(TaskGroup& group)
+{
+    // Tasks of the group that are still queued would otherwise have to wait
+    // for a worker that might be busy with tasks of other groups.
+    QueuedTask queued_task;
+    while (steal_task(group, queued_task))
+    {
+        queued_task.task();
+        finish_task(group);
+    }
+    auto start = chrono::steady_clock::now();
+    while (group.m_nu_unfinished.load() > 0
+           && chrono::steady_clock::now() - start < spin_time)
+        this_thread::yield();
+    unique_lock<mutex> lock(group.m_mutex);
+    while (group.m_nu_unfinished.load() > 0)
+        group.m_finished.wait(lock);
+}
+
+void ThreadPool::worker_main(unsigned worker)
+{
+    QueuedTask queued_task;
+    while (true)
+    {
+        if (pop_task(worker, queued_task))
+        {
+            queued_task.task();
+            finish_task(*queued_task.group);
+            queued_task.task = nullptr;
+            continue;
+        }
+        if (m_quit.load())
+            break;
+        auto start = chrono::steady_clock::now();
+        while (m_nu_queued.load() == 0 && ! m_quit.load()
+               && chrono::steady_clock::now() - start < spin_time)
+            this_thread::yield();
+        if (m_nu_queued.load() > 0)
+            continue;
+        unique_lock<mutex> lock(m_sleep_mutex);
+        ++m_nu_sleeping;
+        while (m_nu_queued.load() == 0 && ! m_quit.load())
+            m_wake_up.wait(lock);
+        --m_nu_sleeping;
+    }
+}
+
+//----------------------------------------------------------------------------
+
+} // namespace libboardgame_util
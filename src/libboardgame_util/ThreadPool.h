@@ -0,0 +1,157 @@
+//-----------------------------------------------------------------------------
+/** @file libboardgame_util/ThreadPool.h
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifndef LIBBOARDGAME_UTIL_THREAD_POOL_H
+#define LIBBOARDGAME_UTIL_THREAD_POOL_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace libboardgame_util {
+
+using namespace std;
+
+//-----------------------------------------------------------------------------
+
+/** Pool of persistent worker threads with work stealing.
+    Each worker has its own task queue. Submitted tasks are distributed
+    round-robin over the queues, a worker takes tasks from the back of its
+    own queue and steals from the front of the queues of the other workers
+    if its own queue is empty.
+    Idle workers spin for a short time before they block on a condition
+    variable, such that work submitted shortly after the previous work
+    finished (e.g. a sequence of short searches) starts without the latency
+    of waking up a blocked thread.
+    The pool is usually shared by all users in a process (see get_global())
+    to avoid creating more threads than the users need at the same time. */
+class ThreadPool
+{
+public:
+    typedef function<void()> Task;
+
+    /** Set of tasks that are waited for together.
+        A group may not be destroyed while it has unfinished tasks. */
+    class TaskGroup
+    {
+        friend class ThreadPool;
+
+    public:
+        TaskGroup() = default;
+
+        TaskGroup(const TaskGroup&) = delete;
+
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+    private:
+        atomic<unsigned> m_nu_unfinished{0};
+
+        mutex m_mutex;
+
+        condition_variable m_finished;
+    };
+
+    /** Maximum number of worker threads. */
+    static const unsigned max_workers = 256;
+
+    /** Time that an idle worker or a thread in wait() spins before it
+        blocks. */
+    static constexpr chrono::microseconds spin_time{2000};
+
+    /** Get the pool shared by all users in the process.
+        The pool is created with no workers on the first call. */
+    static ThreadPool& get_global();
+
+    ThreadPool();
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /** Ensure that the pool has at least a number of workers.
+        Workers are never removed, so the number of workers is the maximum
+        that was ever requested. Requests for more than max_workers workers
+        are reduced to max_workers. */
+    void reserve(unsigned nu_workers);
+
+    unsigned get_nu_workers() const;
+
+    /** Add a task to a group and queue it for execution.
+        @pre get_nu_workers() > 0 */
+    void submit(TaskGroup& group, Task task);
+
+    /** Wait until all tasks of a group are finished.
+        Tasks of the group that were not started by a worker yet are run by
+        the calling thread. */
+    void wait(TaskGroup& group);
+
+private:
+    struct QueuedTask
+    {
+        Task task;
+
+        TaskGroup* group;
+    };
+
+    struct Worker
+    {
+        mutex queue_mutex;
+
+        deque<QueuedTask> queue;
+
+        thread thr;
+    };
+
+    array<unique_ptr<Worker>, max_workers> m_workers;
+
+    /** Number of elements of m_workers that are initialized.
+        Workers read it to find the queues they can steal from. */
+    atomic<unsigned> m_nu_workers{0};
+
+    /** Number of tasks in all queues. */
+    atomic<unsigned> m_nu_queued{0};
+
+    /** Number of workers blocked on m_wake_up. */
+    atomic<unsigned> m_nu_sleeping{0};
+
+    /** Queue that gets the next submitted task. */
+    atomic<unsigned> m_next_queue{0};
+
+    atomic<bool> m_quit{false};
+
+    mutex m_reserve_mutex;
+
+    mutex m_sleep_mutex;
+
+    condition_variable m_wake_up;
+
+    static void finish_task(TaskGroup& group);
+
+    bool pop_task(unsigned worker, QueuedTask& queued_task);
+
+    bool steal_task(const TaskGroup& group, QueuedTask& queued_task);
+
+    void worker_main(unsigned worker);
+};
+
+inline unsigned ThreadPool::get_nu_workers() const
+{
+    return m_nu_workers.load(memory_order_acquire);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace libboardgame_util
+
+#endif // LIBBOARDGAME_UTIL_THREAD_POOL_H
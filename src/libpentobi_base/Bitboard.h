@@ -0,0 +1,139 @@
+//-----------------------------------------------------------------------------
+/** @file libpentobi_base/Bitboard.h
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifndef LIBPENTOBI_BASE_BITBOARD_H
+#define LIBPENTOBI_BASE_BITBOARD_H
+
+#include <cstdint>
+#include "Geometry.h"
+
+namespace libpentobi_base {
+
+using namespace std;
+
+//-----------------------------------------------------------------------------
+
+/** Points of a move as a bit mask for Bitboard::intersects().
+    The points of a move cover at most max_words consecutive words of a
+    Bitboard in all game variants apart from GembloQ, for which no masks are
+    created (see BoardConst::has_move_masks()). */
+struct MoveMask
+{
+    typedef uint64_t Word;
+
+    static const unsigned max_words = 3;
+
+    Word bits[max_words];
+
+    /** Index of the bitboard word corresponding to bits[0]. */
+    uint_least16_t first_word;
+};
+
+//-----------------------------------------------------------------------------
+
+/** Set of on-board points stored as bits.
+    The bit of a point is at position Point::to_int() and the points of a
+    geometry are numbered row by row, so the points of a piece are stored in
+    a few consecutive words. This allows to test a move against the set with
+    a MoveMask and to count points of set intersections with popcount
+    instructions. */
+class Bitboard
+{
+public:
+    typedef MoveMask::Word Word;
+
+    static const unsigned word_bits = 64;
+
+    /** Number of words needed for the points of a geometry.
+        Only these words need to be cleared or copied, the remaining ones
+        are always zero. */
+    static unsigned get_nu_words(const Geometry& geo)
+    {
+        return (geo.get_range() + word_bits - 1) / word_bits;
+    }
+
+    Bitboard()
+    {
+        for (auto& w : m_words)
+            w = 0;
+    }
+
+    bool operator[](Point p) const
+    {
+        return ((m_words[p.to_int() / word_bits] >> (p.to_int() % word_bits))
+                & 1) != 0;
+    }
+
+    void set(Point p)
+    {
+        m_words[p.to_int() / word_bits] |= Word(1) << (p.to_int() % word_bits);
+    }
+
+    void reset(Point p)
+    {
+        m_words[p.to_int() / word_bits] &=
+                ~(Word(1) << (p.to_int() % word_bits));
+    }
+
+    void clear(const Geometry& geo)
+    {
+        for (unsigned i = 0; i < get_nu_words(geo); ++i)
+            m_words[i] = 0;
+    }
+
+    void copy_from(const Bitboard& bb, const Geometry& geo)
+    {
+        for (unsigned i = 0; i < get_nu_words(geo); ++i)
+            m_words[i] = bb.m_words[i];
+    }
+
+    /** Check if any point of a move is in the set. */
+    bool intersects(const MoveMask& mask) const
+    {
+        auto w = m_words + mask.first_word;
+        return ((w[0] & mask.bits[0]) | (w[1] & mask.bits[1])
+                | (w[2] & mask.bits[2])) != 0;
+    }
+
+    /** Count the points that are in this set but not in another set. */
+    unsigned count_and_not(const Bitboard& bb, const Geometry& geo) const
+    {
+        unsigned n = 0;
+        for (unsigned i = 0; i < get_nu_words(geo); ++i)
+            n += popcount(m_words[i] & ~bb.m_words[i]);
+        return n;
+    }
+
+private:
+    static_assert(Point::range_onboard < (1 << 16) * word_bits, "");
+
+    /** Number of words, including MoveMask::max_words - 1 words of
+        padding, such that intersects() can always read all words of a
+        mask. */
+    static const unsigned nu_words =
+            (Point::range_onboard + word_bits - 1) / word_bits
+            + MoveMask::max_words - 1;
+
+    Word m_words[nu_words];
+
+    static unsigned popcount(Word w)
+    {
+#ifdef __GNUC__
+        return static_cast<unsigned>(__builtin_popcountll(w));
+#else
+        unsigned n = 0;
+        for ( ; w != 0; w &= w - 1)
+            ++n;
+        return n;
+#endif
+    }
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace libpentobi_base
+
+#endif // LIBPENTOBI_BASE_BITBOARD_H
@@ -75,6 +75,7 @@ void set_color(ostream& out, const char* esc_sequence)
 bool Board::color_output = false;
 
 Board::Board(Variant variant)
+    : m_zobrist(&Zobrist::get())
 {
     m_color_char[Color(0)] = 'X';
     m_color_char[Color(1)] = 'O';
@@ -96,6 +97,7 @@ void Board::copy_from(const Board& bd)
     if (m_variant != bd.m_variant)
         init_variant(bd.m_variant);
     m_moves = bd.m_moves;
+    m_undo.clear();
     m_setup.to_play = bd.m_setup.to_play;
     m_state_base = bd.m_state_base;
     for (Color c : get_colors())
@@ -300,6 +302,8 @@ void Board::init(Variant variant, const Setup* setup)
         auto& state = m_state_color[c];
         state.forbidden.fill(false, *m_geo);
         state.is_attach_point.fill(false, *m_geo);
+        state.forbidden_bits.clear(*m_geo);
+        state.attach_point_bits.clear(*m_geo);
         state.pieces_left.clear();
         state.nu_onboard_pieces = 0;
         state.points = 0;
@@ -313,6 +317,7 @@ void Board::init(Variant variant, const Setup* setup)
         m_attach_points[c].clear();
     }
     m_state_base.nu_onboard_pieces_all = 0;
+    m_state_base.hash = 0;
     if (! setup)
     {
         m_setup.clear();
@@ -329,6 +334,7 @@ void Board::init(Variant variant, const Setup* setup)
                 m_state_color[c].points += m_bonus_all_pieces;
     }
     m_moves.clear();
+    m_undo.clear();
 }
 
 void Board::init_variant(Variant variant)
@@ -403,6 +409,7 @@ void Board::init_variant(Variant variant)
     m_move_info_array = m_bc->get_move_info_array();
     m_move_info_ext_array = m_bc->get_move_info_ext_array();
     m_move_info_ext_2_array = m_bc->get_move_info_ext_2_array();
+    m_move_mask_array = m_bc->get_move_mask_array();
     m_starting_points.init(variant, *m_geo);
     if (m_piece_set == PieceSet::gembloq)
         m_needed_starting_points = 4;
@@ -428,6 +435,8 @@ void Board::init_variant(Variant variant)
         Piece piece(i);
         auto& piece_info = get_piece_info(piece);
         m_score_points[piece] = piece_info.get_score_points();
+        m_nu_instances[piece] =
+                static_cast<uint_fast8_t>(piece_info.get_nu_instances());
         if (piece_info.get_name() == "1")
             m_one_piece = piece;
     }
@@ -532,13 +541,28 @@ void Board::play(Color c, Move mv)
         play<22, 44>(c, mv);
 }
 
+void Board::play_undoable(Color c, Move mv)
+{
+    if (m_max_piece_size == 5)
+        play_undoable<5, 16>(c, mv);
+    else if (m_max_piece_size == 6)
+        play_undoable<6, 22>(c, mv);
+    else if (m_max_piece_size == 7)
+        play_undoable<7, 12>(c, mv);
+    else
+        play_undoable<22, 44>(c, mv);
+}
+
 void Board::take_snapshot()
 {
+    // optimize_attach_point_lists() changes the attach point lists
+    m_undo.clear();
     optimize_attach_point_lists();
     m_snapshot.moves_size = m_moves.size();
     m_snapshot.state_base.to_play = m_state_base.to_play;
     m_snapshot.state_base.nu_onboard_pieces_all =
         m_state_base.nu_onboard_pieces_all;
+    m_snapshot.state_base.hash = m_state_base.hash;
     m_snapshot.state_base.point_state.copy_from(m_state_base.point_state,
                                                 *m_geo);
     for (Color c : get_colors())
@@ -549,6 +573,9 @@ void Board::take_snapshot()
         snapshot_state.forbidden.copy_from(state.forbidden, *m_geo);
         snapshot_state.is_attach_point.copy_from(state.is_attach_point,
                                                  *m_geo);
+        snapshot_state.forbidden_bits.copy_from(state.forbidden_bits, *m_geo);
+        snapshot_state.attach_point_bits.copy_from(state.attach_point_bits,
+                                                   *m_geo);
         snapshot_state.pieces_left = state.pieces_left;
         snapshot_state.nu_left_piece = state.nu_left_piece;
         snapshot_state.nu_onboard_pieces = state.nu_onboard_pieces;
@@ -556,6 +583,18 @@ void Board::take_snapshot()
     }
 }
 
+void Board::undo()
+{
+    if (m_max_piece_size == 5)
+        undo<5, 16>();
+    else if (m_max_piece_size == 6)
+        undo<6, 22>();
+    else if (m_max_piece_size == 7)
+        undo<7, 12>();
+    else
+        undo<22, 44>();
+}
+
 void Board::write(ostream& out, bool mark_last_move) const
 {
     // Sort lists of left pieces by name
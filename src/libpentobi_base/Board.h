@@ -7,6 +7,7 @@
 #ifndef LIBPENTOBI_BASE_BOARD_H
 #define LIBPENTOBI_BASE_BOARD_H
 
+#include <algorithm>
 #include "BoardConst.h"
 #include "ColorMap.h"
 #include "ColorMove.h"
@@ -18,6 +19,7 @@
 #include "PointState.h"
 #include "Setup.h"
 #include "StartingPoints.h"
+#include "Zobrist.h"
 
 namespace libpentobi_base {
 
@@ -117,6 +119,15 @@ public:
         of a unique piece per player. */
     unsigned get_nu_left_piece(Color c, Piece piece) const;
 
+    /** Get a Zobrist hash of the current position.
+        The hash depends on the points occupied by each color, the pieces
+        left of each color and the color to play, but not on the order in
+        which the pieces were placed or whether they were placed by a setup.
+        Therefore, it can be used for detecting transpositions. The game
+        variant is not included, users that store hashes of different game
+        variants need to store the variant as well. */
+    Zobrist::HashType get_hash() const;
+
     /** Get number of points of a color including the bonus. */
     ScoreType get_points(Color c) const { return m_state_color[c].points; }
 
@@ -131,6 +142,10 @@ public:
         Does not check if the point is forbidden. */
     const PointList& get_attach_points(Color c) const;
 
+    /** Get the number of attachment points of a color that are not
+        forbidden. */
+    unsigned get_nu_free_attach_points(Color c) const;
+
     /** Initialize the current board for a given game variant.
         @param variant The game variant
         @param setup An optional setup position to initialize the board
@@ -162,6 +177,34 @@ public:
         @pre get_nu_moves() < max_game_moves */
     void play(ColorMove mv);
 
+    /** Play a move that can be taken back with undo().
+        Remembers the points whose state is changed by the move, the length
+        of the attach point list and the piece counters, such that undo()
+        takes time proportional to the size of the move instead of restoring
+        the whole board.
+        @pre ! mv.is_null() */
+    void play_undoable(Color c, Move mv);
+
+    /** More efficient version of play_undoable() if maximum piece size of
+        current game variant is known at compile time. */
+    template<unsigned MAX_SIZE, unsigned MAX_ADJ_ATTACH>
+    void play_undoable(Color c, Move mv);
+
+    /** Take back the last move played with play_undoable().
+        Restores the position and color to play before the move.
+        @pre get_nu_undoable() > 0 */
+    void undo();
+
+    /** More efficient version of undo() if maximum piece size of current
+        game variant is known at compile time. */
+    template<unsigned MAX_SIZE, unsigned MAX_ADJ_ATTACH>
+    void undo();
+
+    /** Number of moves that can be taken back with undo().
+        The undo information is discarded by init(), copy_from(), play(),
+        take_snapshot() and restore_snapshot(). */
+    unsigned get_nu_undoable() const;
+
     void set_to_play(Color c);
 
     void write(ostream& out, bool mark_last_move = true) const;
@@ -218,6 +261,11 @@ public:
 
     const GridExt<bool>& is_forbidden(Color c) const;
 
+    /** Same as is_forbidden(Color) but as a bitboard.
+        Can be used together with the move masks of BoardConst to check
+        moves with a few word operations. */
+    const Bitboard& get_forbidden_bits(Color c) const;
+
     /** Check that no points of move are already occupied or adjacent to own
         color.
         Does not check if the move is diagonally adjacent to an existing
@@ -342,6 +390,9 @@ private:
 
         unsigned nu_onboard_pieces_all;
 
+        /** Zobrist hash without the color to play. */
+        Zobrist::HashType hash;
+
         PointStateGrid point_state;
     };
 
@@ -352,6 +403,12 @@ private:
 
         Grid<bool> is_attach_point;
 
+        /** Same as forbidden but as a bitboard. */
+        Bitboard forbidden_bits;
+
+        /** Same as is_attach_point but as a bitboard. */
+        Bitboard attach_point_bits;
+
         PiecesLeftList pieces_left;
 
         PieceMap<uint_fast8_t> nu_left_piece;
@@ -361,6 +418,31 @@ private:
         ScoreType points;
     };
 
+    /** Information needed to take back a move played with
+        play_undoable(). */
+    struct UndoInfo
+    {
+        /** Bit i is set if the i-th point of the move was forbidden for
+            the color before the move. */
+        ColorMap<uint_least32_t> was_forbidden;
+
+        /** Bit i is set if the i-th adjacent point of the move was
+            forbidden for the color of the move before the move. */
+        uint_least64_t was_forbidden_adj;
+
+        Zobrist::HashType hash;
+
+        ScoreType points;
+
+        unsigned attach_points_size;
+
+        /** Index of the piece in the list of left pieces, or
+            Piece::max_pieces if the piece was not removed from the list. */
+        unsigned piece_index;
+
+        Color to_play;
+    };
+
     /** Snapshot for fast restoration of a previous position. */
     struct Snapshot
     {
@@ -406,6 +488,11 @@ private:
     /** Caches get_piece_info(piece).get_score_points() */
     PieceMap<ScoreType> m_score_points;
 
+    /** Caches get_piece_info(piece).get_nu_instances() */
+    PieceMap<uint_fast8_t> m_nu_instances;
+
+    const Zobrist* m_zobrist;
+
     const BoardConst* m_bc;
 
     /** Caches m_bc->get_move_info_array() */
@@ -417,6 +504,9 @@ private:
     /** Caches m_bc->get_move_info_ext_2_array() */
     const MoveInfoExt2* m_move_info_ext_2_array;
 
+    /** Caches m_bc->get_move_mask_array() */
+    const MoveMask* m_move_mask_array;
+
     const Geometry* m_geo;
 
     /** See is_center_section(). */
@@ -440,6 +530,8 @@ private:
 
     ArrayList<ColorMove, max_moves> m_moves;
 
+    ArrayList<UndoInfo, max_moves> m_undo;
+
     Snapshot m_snapshot;
 
     Setup m_setup;
@@ -521,6 +613,16 @@ inline BoardType Board::get_board_type() const
     return m_bc->get_board_type();
 }
 
+inline const Bitboard& Board::get_forbidden_bits(Color c) const
+{
+    return m_state_color[c].forbidden_bits;
+}
+
+inline Zobrist::HashType Board::get_hash() const
+{
+    return m_state_base.hash ^ m_zobrist->get_to_play(m_state_base.to_play);
+}
+
 inline ColorMove Board::get_move(unsigned n) const
 {
     return m_moves[n];
@@ -564,6 +666,13 @@ inline Color::IntType Board::get_nu_colors() const
     return m_nu_colors;
 }
 
+inline unsigned Board::get_nu_free_attach_points(Color c) const
+{
+    auto& state_color = m_state_color[c];
+    return state_color.attach_point_bits.count_and_not(
+                state_color.forbidden_bits, *m_geo);
+}
+
 inline unsigned Board::get_nu_left_piece(Color c, Piece piece) const
 {
     LIBBOARDGAME_ASSERT(piece.to_int() < get_nu_uniq_pieces());
@@ -575,6 +684,11 @@ inline unsigned Board::get_nu_moves() const
     return m_moves.size();
 }
 
+inline unsigned Board::get_nu_undoable() const
+{
+    return m_undo.size();
+}
+
 inline Color::IntType Board::get_nu_nonalt_colors() const
 {
     return m_variant != Variant::classic_3 ? m_nu_colors : 3;
@@ -761,6 +875,9 @@ inline const GridExt<bool>& Board::is_forbidden(Color c) const
 
 inline bool Board::is_forbidden(Color c, Move mv) const
 {
+    if (m_move_mask_array)
+        return m_state_color[c].forbidden_bits.intersects(
+                    m_move_mask_array[mv.to_int()]);
     auto points = get_move_points(mv);
     auto i = points.begin();
     auto end = points.end();
@@ -799,6 +916,9 @@ inline void Board::place(Color c, Move mv)
     auto& state_color = m_state_color[c];
     LIBBOARDGAME_ASSERT(state_color.nu_left_piece[piece] > 0);
     auto score_points = m_score_points[piece];
+    auto nu_placed = m_nu_instances[piece] - state_color.nu_left_piece[piece];
+    m_state_base.hash ^= m_zobrist->get_piece(c, piece, nu_placed)
+            ^ m_zobrist->get_piece(c, piece, nu_placed + 1);
     if (--state_color.nu_left_piece[piece] == 0)
     {
         state_color.pieces_left.remove_fast(piece);
@@ -824,8 +944,10 @@ inline void Board::place(Color c, Move mv)
     do
     {
         m_state_base.point_state[*i] = PointState(c);
+        m_state_base.hash ^= m_zobrist->get_point(c, *i);
         for_each_color([&](Color c) {
             m_state_color[c].forbidden[*i] = true;
+            m_state_color[c].forbidden_bits.set(*i);
         });
     }
     while (++i != end);
@@ -839,7 +961,10 @@ inline void Board::place(Color c, Move mv)
     {
         end = info_ext.end_adj();
         for (i = info_ext.begin_adj(); i != end; ++i)
+        {
             state_color.forbidden[*i] = true;
+            state_color.forbidden_bits.set(*i);
+        }
         LIBBOARDGAME_ASSERT(i == info_ext.begin_attach());
         end += info_ext.size_attach_points;
     }
@@ -849,6 +974,7 @@ inline void Board::place(Color c, Move mv)
         if (! state_color.forbidden[*i] && ! state_color.is_attach_point[*i])
         {
             state_color.is_attach_point[*i] = true;
+            state_color.attach_point_bits.set(*i);
             attach_points.get_unchecked(n) = *i;
             ++n;
         }
@@ -859,6 +985,8 @@ inline void Board::place(Color c, Move mv)
 template<unsigned MAX_SIZE, unsigned MAX_ADJ_ATTACH>
 inline void Board::play(Color c, Move mv)
 {
+    // The undo information would not match the last move anymore
+    m_undo.clear();
     place<MAX_SIZE, MAX_ADJ_ATTACH>(c, mv);
     m_moves.push_back(ColorMove(c, mv));
     m_state_base.to_play = get_next(c);
@@ -869,14 +997,120 @@ inline void Board::play(ColorMove mv)
     play(mv.color, mv.move);
 }
 
+template<unsigned MAX_SIZE, unsigned MAX_ADJ_ATTACH>
+void Board::play_undoable(Color c, Move mv)
+{
+    static_assert(MAX_SIZE <= 32, "");
+    static_assert(MAX_ADJ_ATTACH <= 64, "");
+    auto& info = BoardConst::get_move_info<MAX_SIZE>(mv, m_move_info_array);
+    auto& info_ext = BoardConst::get_move_info_ext<MAX_ADJ_ATTACH>(
+                mv, m_move_info_ext_array);
+    auto& state_color = m_state_color[c];
+    m_undo.push_back(UndoInfo());
+    auto& undo_info = m_undo.back();
+    undo_info.hash = m_state_base.hash;
+    undo_info.points = state_color.points;
+    undo_info.attach_points_size = m_attach_points[c].size();
+    undo_info.to_play = m_state_base.to_play;
+    auto piece = info.get_piece();
+    undo_info.piece_index = Piece::max_pieces;
+    if (state_color.nu_left_piece[piece] == 1)
+        undo_info.piece_index = static_cast<unsigned>(
+                    find(state_color.pieces_left.begin(),
+                         state_color.pieces_left.end(), piece)
+                    - state_color.pieces_left.begin());
+    for_each_color([&](Color c) {
+        auto& forbidden = m_state_color[c].forbidden;
+        uint_least32_t mask = 0;
+        unsigned j = 0;
+        for (Point p : info)
+            mask |= uint_least32_t(forbidden[p]) << j++;
+        undo_info.was_forbidden[c] = mask;
+    });
+    uint_least64_t mask = 0;
+    unsigned j = 0;
+    for (auto i = info_ext.begin_adj(); i != info_ext.end_adj(); ++i)
+        mask |= uint_least64_t(state_color.forbidden[*i]) << j++;
+    undo_info.was_forbidden_adj = mask;
+    place<MAX_SIZE, MAX_ADJ_ATTACH>(c, mv);
+    m_moves.push_back(ColorMove(c, mv));
+    m_state_base.to_play = get_next(c);
+}
+
+template<unsigned MAX_SIZE, unsigned MAX_ADJ_ATTACH>
+void Board::undo()
+{
+    LIBBOARDGAME_ASSERT(! m_undo.empty());
+    LIBBOARDGAME_ASSERT(! m_moves.empty());
+    auto& undo_info = m_undo.back();
+    auto c = m_moves.back().color;
+    auto mv = m_moves.back().move;
+    auto& info = BoardConst::get_move_info<MAX_SIZE>(mv, m_move_info_array);
+    auto& info_ext = BoardConst::get_move_info_ext<MAX_ADJ_ATTACH>(
+                mv, m_move_info_ext_array);
+    auto& state_color = m_state_color[c];
+    auto& attach_points = m_attach_points[c];
+    for (auto i = attach_points.begin() + undo_info.attach_points_size;
+         i != attach_points.end(); ++i)
+    {
+        state_color.is_attach_point[*i] = false;
+        state_color.attach_point_bits.reset(*i);
+    }
+    attach_points.resize(undo_info.attach_points_size);
+    unsigned j = 0;
+    for (auto i = info_ext.begin_adj(); i != info_ext.end_adj(); ++i)
+        if (! ((undo_info.was_forbidden_adj >> j++) & 1))
+        {
+            state_color.forbidden[*i] = false;
+            state_color.forbidden_bits.reset(*i);
+        }
+    for (Point p : info)
+        m_state_base.point_state[p] = PointState::empty();
+    for_each_color([&](Color c) {
+        auto& state = m_state_color[c];
+        auto mask = undo_info.was_forbidden[c];
+        unsigned j = 0;
+        for (Point p : info)
+            if (! ((mask >> j++) & 1))
+            {
+                state.forbidden[p] = false;
+                state.forbidden_bits.reset(p);
+            }
+    });
+    auto piece = info.get_piece();
+    if (state_color.nu_left_piece[piece]++ == 0)
+    {
+        // Reverse ArrayList::remove_fast()
+        auto& pieces_left = state_color.pieces_left;
+        auto i = undo_info.piece_index;
+        LIBBOARDGAME_ASSERT(i <= pieces_left.size());
+        if (i == pieces_left.size())
+            pieces_left.push_back(piece);
+        else
+        {
+            pieces_left.push_back(pieces_left[i]);
+            pieces_left[i] = piece;
+        }
+    }
+    --m_state_base.nu_onboard_pieces_all;
+    --state_color.nu_onboard_pieces;
+    state_color.points = undo_info.points;
+    m_state_base.hash = undo_info.hash;
+    m_state_base.to_play = undo_info.to_play;
+    m_moves.pop_back();
+    m_undo.pop_back();
+}
+
 inline void Board::restore_snapshot()
 {
     LIBBOARDGAME_ASSERT(m_snapshot.moves_size <= m_moves.size());
     auto& geo = get_geometry();
     m_moves.resize(m_snapshot.moves_size);
+    m_undo.clear();
     m_state_base.to_play = m_snapshot.state_base.to_play;
     m_state_base.nu_onboard_pieces_all =
         m_snapshot.state_base.nu_onboard_pieces_all;
+    m_state_base.hash = m_snapshot.state_base.hash;
     m_state_base.point_state.memcpy_from(m_snapshot.state_base.point_state,
                                          geo);
     for (Color c : get_colors())
@@ -885,6 +1119,9 @@ inline void Board::restore_snapshot()
         auto& state = m_state_color[c];
         state.forbidden.copy_from(snapshot_state.forbidden, geo);
         state.is_attach_point.copy_from(snapshot_state.is_attach_point, geo);
+        state.forbidden_bits.copy_from(snapshot_state.forbidden_bits, geo);
+        state.attach_point_bits.copy_from(snapshot_state.attach_point_bits,
+                                          geo);
         state.pieces_left = snapshot_state.pieces_left;
         state.nu_left_piece = snapshot_state.nu_left_piece;
         state.nu_onboard_pieces = snapshot_state.nu_onboard_pieces;
@@ -11,6 +11,10 @@
 #include "BoardConst.h"
 
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <sstream>
 #include "Marker.h"
 #include "PieceTransformsClassic.h"
 #include "PieceTransformsGembloQ.h"
@@ -19,6 +23,7 @@
 #include "libboardgame_util/Log.h"
 #include "libboardgame_util/StringUtil.h"
 #include "libboardgame_sys/Compiler.h"
+#include "libboardgame_sys/Process.h"
 
 namespace libpentobi_base {
 
@@ -26,6 +31,7 @@ using libboardgame_base::Transform;
 using libboardgame_util::split;
 using libboardgame_util::to_lower;
 using libboardgame_util::trim;
+using libboardgame_sys::get_process_id;
 using libboardgame_sys::get_type_name;
 
 //-----------------------------------------------------------------------------
@@ -34,6 +40,13 @@ namespace {
 
 const bool log_move_creation = false;
 
+/** Increase if the content of the move tables changes without a change of
+    the package version, e.g. during development. */
+const unsigned cache_format_version = 1;
+
+/** See BoardConst::set_cache_dir() */
+string g_cache_dir;
+
 /** Local variable used during construction.
     Making this variable global slightly speeds up construction and a
     thread-safe construction is not needed. */
@@ -46,6 +59,31 @@ Grid<array<ArrayList<Move, 44>, PrecompMoves::nu_adj_status>>
     g_full_move_table;
 
 
+/** Get the element sizes of the MoveInfo and MoveInfoExt arrays. */
+void get_move_info_sizes(unsigned max_piece_size, size_t& move_info_size,
+                         size_t& move_info_ext_size)
+{
+    switch (max_piece_size)
+    {
+    case 5:
+        move_info_size = sizeof(MoveInfo<5>);
+        move_info_ext_size = sizeof(MoveInfoExt<16>);
+        break;
+    case 6:
+        move_info_size = sizeof(MoveInfo<6>);
+        move_info_ext_size = sizeof(MoveInfoExt<22>);
+        break;
+    case 7:
+        move_info_size = sizeof(MoveInfo<7>);
+        move_info_ext_size = sizeof(MoveInfoExt<12>);
+        break;
+    default:
+        LIBBOARDGAME_ASSERT(max_piece_size == 22);
+        move_info_size = sizeof(MoveInfo<22>);
+        move_info_ext_size = sizeof(MoveInfoExt<44>);
+    }
+}
+
 bool is_reverse(MovePoints::const_iterator begin1, const Point* begin2, unsigned size)
 {
     auto j = begin2 + size - 1;
@@ -916,6 +954,8 @@ BoardConst::BoardConst(BoardType board_type, PieceSet piece_set)
         break;
     }
     m_move_info_ext_2 = make_unique<MoveInfoExt2[]>(m_range);
+    if (piece_set != PieceSet::gembloq)
+        m_move_mask = make_unique<MoveMask[]>(m_range);
     m_nu_pieces = static_cast<Piece::IntType>(m_pieces.size());
     for (Point p : m_geo)
         if (has_adj_status_points(p))
@@ -925,7 +965,10 @@ BoardConst::BoardConst(BoardType board_type, PieceSet piece_set)
     for (Point p : m_geo)
         m_compare_val[p] =
                 (height - m_geo.get_y(p) - 1) * width + m_geo.get_x(p);
-    create_moves();
+    auto cache_file = get_cache_file();
+    bool is_cached = (! cache_file.empty() && read_cache(cache_file));
+    if (! is_cached)
+        create_moves();
     switch (piece_set)
     {
     case PieceSet::classic:
@@ -947,12 +990,21 @@ BoardConst::BoardConst(BoardType board_type, PieceSet piece_set)
         LIBBOARDGAME_ASSERT(m_nu_pieces == 21);
         break;
     }
+    if (is_cached)
+    {
+        // The symmetric moves are already in the cached MoveInfoExt2 array
+        if (has_symmetry_info())
+            m_symmetric_points.init(m_geo);
+        return;
+    }
     if (board_type == BoardType::duo || board_type == BoardType::callisto_2)
         init_symmetry_info<5>();
     else if (board_type == BoardType::trigon)
         init_symmetry_info<6>();
     else if (board_type == BoardType::gembloq_2)
         init_symmetry_info<22>();
+    if (! cache_file.empty())
+        write_cache(cache_file);
 }
 
 template<unsigned MAX_SIZE, unsigned MAX_ADJ_ATTACH>
@@ -972,6 +1024,8 @@ inline void BoardConst::create_move(unsigned& moves_created, Piece piece,
             + moves_created;
     auto& info_ext = *new(place) MoveInfoExt<MAX_ADJ_ATTACH>();
     auto& info_ext_2 = m_move_info_ext_2[moves_created];
+    if (m_move_mask)
+        init_move_mask(m_move_mask[moves_created], points);
     ++moves_created;
     auto scored_points = &info_ext_2.scored_points[0];
     for (auto p : points)
@@ -1165,6 +1219,8 @@ Move BoardConst::from_string(const string& s) const
 const BoardConst& BoardConst::get(Variant variant)
 {
     static map<BoardType, map<PieceSet, unique_ptr<BoardConst>>> board_const;
+    static mutex board_const_mutex;
+    lock_guard<mutex> lock(board_const_mutex);
     auto board_type = libpentobi_base::get_board_type(variant);
     auto piece_set = libpentobi_base::get_piece_set(variant);
     auto& bc = board_const[board_type][piece_set];
@@ -1173,6 +1229,40 @@ const BoardConst& BoardConst::get(Variant variant)
     return *bc;
 }
 
+string BoardConst::get_cache_file() const
+{
+    if (g_cache_dir.empty())
+        return string();
+    return g_cache_dir + "/moves-"
+            + std::to_string(static_cast<int>(m_board_type)) + "-"
+            + std::to_string(static_cast<int>(m_piece_set)) + ".dat";
+}
+
+/** Get the first line of the cache file.
+    Contains everything the binary layout of the cached tables depends on. */
+string BoardConst::get_cache_header() const
+{
+    size_t move_info_size;
+    size_t move_info_ext_size;
+    get_move_info_sizes(m_max_piece_size, move_info_size, move_info_ext_size);
+    uint_least32_t byte_order = 0x01020304;
+    ostringstream header;
+    header << "Pentobi move tables "
+#ifdef VERSION
+           << VERSION
+#endif
+           << ' ' << cache_format_version << ' '
+           << static_cast<int>(m_board_type) << ' '
+           << static_cast<int>(m_piece_set) << ' ' << m_range << ' '
+           << Point::range << ' ' << PrecompMoves::adj_status_nu_adj << ' '
+           << move_info_size << ' ' << move_info_ext_size << ' '
+           << sizeof(MoveInfoExt2) << ' ' << sizeof(MoveMask) << ' '
+           << sizeof(Move) << ' '
+           << static_cast<int>(
+                  *reinterpret_cast<const unsigned char*>(&byte_order));
+    return header.str();
+}
+
 bool BoardConst::get_piece_by_name(const string& name, Piece& piece) const
 {
     for (Piece::IntType i = 0; i < m_nu_pieces; ++i)
@@ -1223,6 +1313,14 @@ bool BoardConst::find_move(const MovePoints& points, Piece piece,
     return false;
 }
 
+bool BoardConst::has_symmetry_info() const
+{
+    return m_board_type == BoardType::duo
+            || m_board_type == BoardType::callisto_2
+            || m_board_type == BoardType::trigon
+            || m_board_type == BoardType::gembloq_2;
+}
+
 /** Builds the list of neighboring points that is used for the adjacent
     status for matching precompted move lists. */
 void BoardConst::init_adj_status_points(Point p)
@@ -1279,6 +1377,24 @@ void BoardConst::init_adj_status_points(Point p)
     LIBBOARDGAME_ASSERT(n == max_size);
 }
 
+void BoardConst::init_move_mask(MoveMask& mask,
+                                const MovePoints& points) const
+{
+    auto first_word = Bitboard::get_nu_words(m_geo);
+    for (Point p : points)
+        first_word = min(first_word, p.to_int() / Bitboard::word_bits);
+    mask.first_word = static_cast<uint_least16_t>(first_word);
+    for (auto& bits : mask.bits)
+        bits = 0;
+    for (Point p : points)
+    {
+        auto i = p.to_int() / Bitboard::word_bits - first_word;
+        LIBBOARDGAME_ASSERT(i < MoveMask::max_words);
+        mask.bits[i] |=
+                MoveMask::Word(1) << (p.to_int() % Bitboard::word_bits);
+    }
+}
+
 template<unsigned MAX_SIZE>
 void BoardConst::init_symmetry_info()
 {
@@ -1309,6 +1425,44 @@ void BoardConst::init_symmetry_info()
     }
 }
 
+bool BoardConst::read_cache(const string& file)
+{
+    ifstream in(file, ios::binary);
+    if (! in)
+        return false;
+    string header;
+    if (! getline(in, header) || header != get_cache_header())
+    {
+        LIBBOARDGAME_LOG("Ignoring incompatible cache file ", file);
+        return false;
+    }
+    size_t move_info_size;
+    size_t move_info_ext_size;
+    get_move_info_sizes(m_max_piece_size, move_info_size, move_info_ext_size);
+    in.read(static_cast<char*>(m_move_info.get()), m_range * move_info_size);
+    in.read(static_cast<char*>(m_move_info_ext.get()),
+            m_range * move_info_ext_size);
+    in.read(reinterpret_cast<char*>(m_move_info_ext_2.get()),
+            m_range * sizeof(MoveInfoExt2));
+    if (m_move_mask)
+        in.read(reinterpret_cast<char*>(m_move_mask.get()),
+                m_range * sizeof(MoveMask));
+    in.read(reinterpret_cast<char*>(&m_nu_attach_points),
+            sizeof(m_nu_attach_points));
+    if (! in || ! m_precomp_moves.read(in, m_geo)
+            || in.peek() != ifstream::traits_type::eof())
+    {
+        LIBBOARDGAME_LOG("Ignoring invalid cache file ", file);
+        return false;
+    }
+    return true;
+}
+
+void BoardConst::set_cache_dir(const string& dir)
+{
+    g_cache_dir = dir;
+}
+
 void BoardConst::sort(MovePoints& points) const
 {
     auto less = [this](Point a, Point b)
@@ -1410,6 +1564,42 @@ string BoardConst::to_string(Move mv, bool with_piece_name) const
     return s.str();
 }
 
+void BoardConst::write_cache(const string& file) const
+{
+    // Write to a temporary file first, such that a concurrently started
+    // process never reads a partially written file. The name of the
+    // temporary file contains the process ID, so that processes started at
+    // the same time don't write to the same temporary file (threads of the
+    // same process don't write concurrently because get() is locked).
+    auto tmp_file =
+            file + "." + std::to_string(get_process_id()) + ".tmp";
+    {
+        ofstream out(tmp_file, ios::binary);
+        size_t move_info_size;
+        size_t move_info_ext_size;
+        get_move_info_sizes(m_max_piece_size, move_info_size,
+                            move_info_ext_size);
+        out << get_cache_header() << '\n';
+        out.write(static_cast<const char*>(m_move_info.get()),
+                  m_range * move_info_size);
+        out.write(static_cast<const char*>(m_move_info_ext.get()),
+                  m_range * move_info_ext_size);
+        out.write(reinterpret_cast<const char*>(m_move_info_ext_2.get()),
+                  m_range * sizeof(MoveInfoExt2));
+        if (m_move_mask)
+            out.write(reinterpret_cast<const char*>(m_move_mask.get()),
+                      m_range * sizeof(MoveMask));
+        out.write(reinterpret_cast<const char*>(&m_nu_attach_points),
+                  sizeof(m_nu_attach_points));
+        m_precomp_moves.write(out, m_geo);
+        out.close();
+        if (out && rename(tmp_file.c_str(), file.c_str()) == 0)
+            return;
+    }
+    LIBBOARDGAME_LOG("Could not write cache file ", file);
+    remove(tmp_file.c_str());
+}
+
 //-----------------------------------------------------------------------------
 
 } // namespace libpentobi_base
@@ -8,6 +8,7 @@
 #define LIBPENTOBI_BASE_BOARD_CONST_H
 
 #include "Geometry.h"
+#include "Bitboard.h"
 #include "MoveInfo.h"
 #include "PieceInfo.h"
 #include "PieceTransforms.h"
@@ -43,9 +44,20 @@ public:
 
     /** Get the single instance for a given board size.
         The instance is created the first time this function is called.
-        This function is not thread-safe. */
+        This function is thread-safe, such that several threads with their
+        own boards can share the instance. */
     static const BoardConst& get(Variant variant);
 
+    /** Set a directory for caching the move tables.
+        If set, the move tables are read from a file in this directory
+        instead of being created, if the file exists and was written by the
+        same version of this library. Otherwise, the tables are created and
+        written to the file. Creating the tables takes a noticeable time
+        in game variants with many moves. The directory must exist and must
+        be set before the first call of get(). An empty string (the default)
+        disables the cache. */
+    static void set_cache_dir(const string& dir);
+
     template<unsigned MAX_SIZE>
     static const MoveInfo<MAX_SIZE>&
     get_move_info(Move mv, MoveInfoArray move_info_array);
@@ -96,6 +108,19 @@ public:
 
     const MoveInfoExt2* get_move_info_ext_2_array() const;
 
+    /** Are move masks available in the current game variant?
+        Not available in GembloQ, in which the points of a move can span more
+        than MoveMask::max_words words of a Bitboard. */
+    bool has_move_masks() const { return m_move_mask != nullptr; }
+
+    /** Get the points of a move as a mask for Bitboard::intersects().
+        @pre has_move_masks() */
+    const MoveMask& get_move_mask(Move mv) const;
+
+    /** Get pointer to move mask array or @c nullptr if
+        has_move_masks() is false. */
+    const MoveMask* get_move_mask_array() const { return m_move_mask.get(); }
+
     Move::IntType get_range() const { return m_range; }
 
     bool find_move(const MovePoints& points, Move& move) const;
@@ -197,6 +222,9 @@ private:
 
     unique_ptr<MoveInfoExt2[]> m_move_info_ext_2;
 
+    /** See get_move_mask() */
+    unique_ptr<MoveMask[]> m_move_mask;
+
     PrecompMoves m_precomp_moves;
 
     /** Value for comparing points using the ordering used in blksgf files.
@@ -216,6 +244,12 @@ private:
 
     void create_moves();
 
+    string get_cache_file() const;
+
+    string get_cache_header() const;
+
+    bool has_symmetry_info() const;
+
     template<unsigned MAX_SIZE, unsigned MAX_ADJ_ATTACH>
     void create_moves(unsigned& moves_created, Piece piece);
 
@@ -224,8 +258,14 @@ private:
 
     void init_adj_status_points(Point p);
 
+    void init_move_mask(MoveMask& mask, const MovePoints& points) const;
+
     template<unsigned MAX_SIZE>
     void init_symmetry_info();
+
+    bool read_cache(const string& file);
+
+    void write_cache(const string& file) const;
 };
 
 inline const Geometry& BoardConst::get_geometry() const
@@ -258,6 +298,13 @@ BoardConst::get_move_info_ext(Move mv, MoveInfoExtArray move_info_ext_array)
                  move_info_ext_array) + mv.to_int());
 }
 
+inline const MoveMask& BoardConst::get_move_mask(Move mv) const
+{
+    LIBBOARDGAME_ASSERT(has_move_masks());
+    LIBBOARDGAME_ASSERT(mv.to_int() < m_range);
+    return m_move_mask[mv.to_int()];
+}
+
 inline const MoveInfoExt2& BoardConst::get_move_info_ext_2(Move mv) const
 {
     LIBBOARDGAME_ASSERT(mv.to_int() < m_range);
@@ -60,6 +60,16 @@ void get_current_position_as_setup(const Board& bd, Setup& setup)
     setup.to_play = bd.get_to_play();
 }
 
+string get_result_property(const Board& bd)
+{
+    auto score = static_cast<int>(bd.get_score_twoplayer(Color(0)));
+    if (score > 0)
+        return "B+" + std::to_string(score);
+    if (score < 0)
+        return "W+" + std::to_string(-score);
+    return "0";
+}
+
 Move get_transformed(const Board& bd, Move mv,
                      const PointTransform<Point>& transform)
 {
@@ -29,6 +29,13 @@ void get_current_position_as_setup(const Board& bd, Setup& setup);
 
 void write_setup(Writer& writer, Variant variant, const Setup& setup);
 
+/** Get the result of a finished two-player game as a value of the SGF RE
+    property.
+    Uses the same format as PentobiTree::set_result() ("B+n", "W+n" or "0"
+    for a draw) with the score of the first player.
+    @pre bd.get_nu_players() == 2 */
+string get_result_property(const Board& bd);
+
 Move get_transformed(const Board& bd, Move mv,
                      const PointTransform<Point>& transform);
 
@@ -10,6 +10,9 @@
 
 #include "Book.h"
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
 #include "libboardgame_sgf/TreeReader.h"
 #include "libboardgame_util/Log.h"
 #include "libpentobi_base/BoardUtil.h"
@@ -18,64 +21,235 @@
 
 namespace libpentobi_base {
 
-using libboardgame_base::PointTransfIdent;
-using libboardgame_base::PointTransfRefl;
-using libboardgame_base::PointTransfReflRot180;
-using libboardgame_base::PointTransfRot180;
-using libboardgame_base::PointTransfRot270Refl;
-using libboardgame_base::PointTransfTrigonReflRot60;
-using libboardgame_base::PointTransfTrigonReflRot120;
-using libboardgame_base::PointTransfTrigonReflRot240;
-using libboardgame_base::PointTransfTrigonReflRot300;
-using libboardgame_base::PointTransfTrigonRot60;
-using libboardgame_base::PointTransfTrigonRot120;
-using libboardgame_base::PointTransfTrigonRot240;
-using libboardgame_base::PointTransfTrigonRot300;
-using libboardgame_sgf::InvalidProperty;
 using libboardgame_sgf::TreeReader;
 using boardutil::get_transformed;
 
 //-----------------------------------------------------------------------------
 
+namespace {
+
+const char magic[8] = { 'P', 'e', 'n', 't', 'B', 'o', 'o', 'k' };
+
+const uint32_t byte_order = 0x01020304;
+
+/** Version of the compiled book format.
+    Must be increased if the format or the hashing of positions changes. */
+const uint32_t format_version = 1;
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
 Book::Book(Variant variant)
-    : m_tree(variant)
+    : m_variant(variant)
 {
-    get_transforms(variant, m_transforms, m_inv_transforms);
+    create_compiled({}, 0);
 }
 
 Book::~Book() = default;
 
+void Book::add_replies(Board& bd, const PentobiTree& tree,
+                       const SgfNode& node,
+                       map<HashType, vector<Move>>& replies,
+                       unsigned& max_nu_moves)
+{
+    unsigned nu_children = node.get_nu_children();
+    for (unsigned i = 0; i < nu_children; ++i)
+    {
+        auto& child = node.get_child(i);
+        ColorMove color_mv = tree.get_move(child);
+        if (color_mv.is_null())
+        {
+            LIBBOARDGAME_LOG("WARNING: Book contains nodes without moves");
+            continue;
+        }
+        if (! bd.is_legal(color_mv.color, color_mv.move))
+        {
+            LIBBOARDGAME_LOG("WARNING: Book contains illegal move");
+            continue;
+        }
+        if (tree.get_good_move(child) > 0)
+        {
+            unsigned transform;
+            auto hash = get_canonical_hash(bd, color_mv.color, transform);
+            auto mv = get_transformed(bd, color_mv.move,
+                                      *m_transforms[transform]);
+            auto& moves = replies[hash];
+            if (find(moves.begin(), moves.end(), mv) == moves.end())
+                moves.push_back(mv);
+            max_nu_moves = max(max_nu_moves, bd.get_nu_moves());
+        }
+        bd.play_undoable(color_mv.color, color_mv.move);
+        add_replies(bd, tree, child, replies, max_nu_moves);
+        bd.undo();
+    }
+}
+
+void Book::clear()
+{
+    m_file.close();
+    create_compiled({}, 0);
+}
+
+void Book::create_compiled(const map<HashType, vector<Move>>& replies,
+                           unsigned max_nu_moves)
+{
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, magic, sizeof(magic));
+    header.byte_order = byte_order;
+    header.format_version = format_version;
+    strncpy(header.variant, to_string_id(m_variant),
+            sizeof(header.variant) - 1);
+    header.move_range = BoardConst::get(m_variant).get_range();
+    header.max_nu_moves = max_nu_moves;
+    header.nu_entries = static_cast<uint32_t>(replies.size());
+    header.nu_replies = 0;
+    for (auto& i : replies)
+        header.nu_replies += static_cast<uint32_t>(i.second.size());
+    vector<char> buffer(get_size(header));
+    auto pos = buffer.data();
+    memcpy(pos, &header, sizeof(header));
+    pos += sizeof(header);
+    auto reply_pos = pos + header.nu_entries * sizeof(Entry);
+    Entry entry;
+    entry.begin = 0;
+    // Entries are sorted by hash because map is sorted
+    for (auto& i : replies)
+    {
+        entry.hash = i.first;
+        entry.nu_replies = static_cast<uint32_t>(i.second.size());
+        memcpy(pos, &entry, sizeof(entry));
+        pos += sizeof(entry);
+        for (Move mv : i.second)
+        {
+            Reply reply = mv.to_int();
+            memcpy(reply_pos, &reply, sizeof(reply));
+            reply_pos += sizeof(reply);
+        }
+        entry.begin += entry.nu_replies;
+    }
+    init_compiled(buffer.data(), buffer.size());
+    m_buffer.swap(buffer);
+    m_file.close();
+}
+
 Move Book::genmove(const Board& bd, Color c)
 {
     if (bd.has_setup())
         // Book cannot handle setup positions
         return Move::null();
-    Move mv;
-    for (unsigned i = 0; i < m_transforms.size(); ++i)
-        if (genmove(bd, c, mv, *m_transforms[i], *m_inv_transforms[i]))
-            return mv;
-    return Move::null();
+    if (bd.get_variant() != m_variant
+            || bd.get_nu_moves() > m_header->max_nu_moves
+            || m_header->nu_entries == 0)
+        return Move::null();
+    unsigned transform;
+    auto hash = get_canonical_hash(bd, c, transform);
+    auto end = m_entries + m_header->nu_entries;
+    auto entry = lower_bound(m_entries, end, hash,
+                             [](const Entry& e, HashType h) {
+        return e.hash < h;
+    });
+    if (entry == end || entry->hash != hash)
+        return Move::null();
+    vector<Move> good_moves;
+    for (unsigned i = 0; i < entry->nu_replies; ++i)
+    {
+        Move mv(m_replies[entry->begin + i]);
+        mv = get_transformed(bd, mv, *m_inv_transforms[transform]);
+        if (! bd.is_legal(c, mv))
+        {
+            LIBBOARDGAME_LOG("WARNING: Book contains illegal move");
+            continue;
+        }
+        LIBBOARDGAME_LOG(bd.to_string(mv), " !");
+        good_moves.push_back(mv);
+    }
+    if (good_moves.empty())
+        return Move::null();
+    LIBBOARDGAME_LOG("Book moves: ", good_moves.size());
+    unsigned nu_good_moves = static_cast<unsigned>(good_moves.size());
+    return good_moves[m_random.generate() % nu_good_moves];
 }
 
-bool Book::genmove(const Board& bd, Color c, Move& mv,
-                   const PointTransform& transform,
-                   const PointTransform& inv_transform)
+auto Book::get_canonical_hash(const Board& bd, Color c, unsigned& transform)
+-> HashType
 {
-    LIBBOARDGAME_ASSERT(! bd.has_setup());
-    auto node = &m_tree.get_root();
+    auto& zobrist = Zobrist::get();
+    auto& geo = bd.get_geometry();
+    auto nu_transforms = static_cast<unsigned>(m_transforms.size());
+    m_transformed_hash.assign(nu_transforms, 0);
+    HashType hash = 0;
     for (unsigned i = 0; i < bd.get_nu_moves(); ++i)
     {
-        ColorMove color_mv = bd.get_move(i);
-        color_mv.move = get_transformed(bd, color_mv.move, transform);
-        node = m_tree.find_child_with_move(*node, color_mv);
-        if (! node)
-            return false;
+        auto mv = bd.get_move(i);
+        for (Point p : bd.get_move_points(mv.move))
+        {
+            hash ^= zobrist.get_point(mv.color, p);
+            for (unsigned j = 0; j < nu_transforms; ++j)
+                m_transformed_hash[j] ^= zobrist.get_point(
+                            mv.color, m_transforms[j]->get_transformed(p, geo));
+        }
     }
-    node = select_child(bd, c, m_tree, *node, inv_transform);
-    if (! node)
-        return false;
-    mv = get_transformed(bd, m_tree.get_move(*node).move, inv_transform);
-    return true;
+    // The hash of the pieces on the board does not depend on the
+    // transformation, only the hash of the occupied points needs to be
+    // replaced.
+    hash ^= bd.get_hash() ^ zobrist.get_to_play(bd.get_to_play())
+            ^ zobrist.get_to_play(c);
+    transform = 0;
+    for (unsigned j = 1; j < nu_transforms; ++j)
+        if (m_transformed_hash[j] < m_transformed_hash[transform])
+            transform = j;
+    return hash ^ m_transformed_hash[transform];
+}
+
+size_t Book::get_size(const Header& header)
+{
+    return sizeof(Header) + header.nu_entries * sizeof(Entry)
+            + header.nu_replies * sizeof(Reply);
+}
+
+void Book::init_compiled(const char* data, size_t size)
+{
+    if (size < sizeof(Header))
+        throw runtime_error("invalid compiled book: file too short");
+    auto header = reinterpret_cast<const Header*>(data);
+    if (memcmp(header->magic, magic, sizeof(magic)) != 0)
+        throw runtime_error("invalid compiled book: wrong file type");
+    if (header->byte_order != byte_order)
+        throw runtime_error("invalid compiled book: wrong byte order");
+    if (header->format_version != format_version)
+        throw runtime_error("invalid compiled book: wrong format version");
+    Variant variant;
+    string id(header->variant,
+              find(header->variant,
+                   header->variant + sizeof(header->variant), '\0'));
+    if (! parse_variant_id(id, variant))
+        throw runtime_error("invalid compiled book: unknown game variant");
+    auto move_range = BoardConst::get(variant).get_range();
+    if (header->move_range != move_range)
+        throw runtime_error("invalid compiled book: wrong number of moves");
+    if (header->nu_entries > size / sizeof(Entry)
+            || header->nu_replies > size / sizeof(Reply)
+            || get_size(*header) != size)
+        throw runtime_error("invalid compiled book: wrong file size");
+    auto entries = reinterpret_cast<const Entry*>(data + sizeof(Header));
+    auto replies = reinterpret_cast<const Reply*>(
+                data + sizeof(Header) + header->nu_entries * sizeof(Entry));
+    for (unsigned i = 0; i < header->nu_entries; ++i)
+        if ((i > 0 && entries[i].hash <= entries[i - 1].hash)
+                || entries[i].begin > header->nu_replies
+                || entries[i].nu_replies > header->nu_replies
+                                           - entries[i].begin)
+            throw runtime_error("invalid compiled book: invalid entry");
+    for (unsigned i = 0; i < header->nu_replies; ++i)
+        if (replies[i] == 0 || replies[i] >= move_range)
+            throw runtime_error("invalid compiled book: invalid move");
+    m_header = header;
+    m_entries = entries;
+    m_replies = replies;
+    m_variant = variant;
+    get_transforms(variant, m_transforms, m_inv_transforms);
 }
 
 void Book::load(istream& in)
@@ -90,51 +264,49 @@ void Book::load(istream& in)
         throw runtime_error(string("could not read book: ") + e.what());
     }
     unique_ptr<SgfNode> root = reader.get_tree_transfer_ownership();
-    m_tree.init(root);
-    get_transforms(m_tree.get_variant(), m_transforms, m_inv_transforms);
+    PentobiTree tree(m_variant);
+    tree.init(root);
+    m_variant = tree.get_variant();
+    get_transforms(m_variant, m_transforms, m_inv_transforms);
+    auto bd = make_unique<Board>(m_variant);
+    map<HashType, vector<Move>> replies;
+    unsigned max_nu_moves = 0;
+    add_replies(*bd, tree, tree.get_root(), replies, max_nu_moves);
+    create_compiled(replies, max_nu_moves);
 }
 
-const SgfNode* Book::select_child(const Board& bd, Color c,
-                                  const PentobiTree& tree, const SgfNode& node,
-                                  const PointTransform& inv_transform)
+bool Book::load_compiled(const string& path)
 {
-    unsigned nu_children = node.get_nu_children();
-    if (nu_children == 0)
-        return nullptr;
-    vector<const SgfNode*> good_moves;
-    for (unsigned i = 0; i < nu_children; ++i)
+    clear();
+    if (! m_file.open(path))
+        return false;
+    try
     {
-        auto& child = node.get_child(i);
-        ColorMove color_mv = tree.get_move(child);
-        if (color_mv.is_null())
-        {
-            LIBBOARDGAME_LOG("WARNING: Book contains nodes without moves");
-            continue;
-        }
-        if (color_mv.color != c)
-        {
-            LIBBOARDGAME_LOG("WARNING: Book contains non-alternating move sequences");
-            continue;
-        }
-        auto mv = get_transformed(bd, color_mv.move, inv_transform);
-        if (! bd.is_legal(color_mv.color, mv))
-        {
-            LIBBOARDGAME_LOG("WARNING: Book contains illegal move");
-            continue;
-        }
-        if (m_tree.get_good_move(child) > 0)
-        {
-            LIBBOARDGAME_LOG(bd.to_string(mv), " !");
-            good_moves.push_back(&child);
-        }
-        else
-            LIBBOARDGAME_LOG(bd.to_string(mv));
+        init_compiled(m_file.get_data(), m_file.get_size());
     }
-    if (good_moves.empty())
-        return nullptr;
-    LIBBOARDGAME_LOG("Book moves: ", good_moves.size());
-    unsigned nu_good_moves = static_cast<unsigned>(good_moves.size());
-    return good_moves[m_random.generate() % nu_good_moves];
+    catch (const runtime_error&)
+    {
+        clear();
+        throw;
+    }
+    m_buffer.clear();
+    m_buffer.shrink_to_fit();
+    return true;
+}
+
+void Book::load_compiled(istream& in)
+{
+    vector<char> buffer((istreambuf_iterator<char>(in)),
+                        istreambuf_iterator<char>());
+    init_compiled(buffer.data(), buffer.size());
+    m_buffer.swap(buffer);
+    m_file.close();
+}
+
+void Book::write_compiled(ostream& out) const
+{
+    out.write(reinterpret_cast<const char*>(m_header),
+              static_cast<streamsize>(get_size(*m_header)));
 }
 
 //-----------------------------------------------------------------------------
@@ -8,13 +8,16 @@
 #define LIBPENTOBI_BASE_BOOK_H
 
 #include <iosfwd>
+#include <map>
 #include "Board.h"
 #include "PentobiTree.h"
 #include "libboardgame_base/PointTransform.h"
+#include "libboardgame_sys/MappedFile.h"
 #include "libboardgame_util/RandomGenerator.h"
 
 namespace libpentobi_base {
 
+using libboardgame_sys::MappedFile;
 using libboardgame_util::RandomGenerator;
 
 //-----------------------------------------------------------------------------
@@ -23,7 +26,21 @@ using libboardgame_util::RandomGenerator;
     Opening books are stored as trees in SGF files. Thay contain move
     annotation properties according to the SGF standard. The book will select
     randomly among the child nodes that have the move annotation good move
-    or very good move (TE[1] or TE[2]). */
+    or very good move (TE[1] or TE[2]).
+
+    The book does not search the tree. Instead, load() converts the tree into
+    a table that maps the hash of each position in the tree to the good moves
+    in this position. The positions are normalized by using the hash of the
+    transformed position with the smallest hash among the invariance
+    transformations of the game variant (see get_transforms()), so a lookup
+    finds the position independent of the symmetry and the move order that
+    led to it.
+
+    The table can be written with write_compiled() to a compiled book file.
+    Loading a compiled book with load_compiled() maps the file into memory
+    and does not need to parse or convert anything. The file format depends
+    on the byte order and on the move numbering of BoardConst, it is not
+    meant to be distributed independently of the program that created it. */
 class Book
 {
 public:
@@ -31,16 +48,71 @@ public:
 
     ~Book();
 
+    /** Load a book from an SGF file.
+        @throws runtime_error If the file is not a valid SGF file. */
     void load(istream& in);
 
+    /** Load a compiled book file by mapping it into memory.
+        @return @c false if the file could not be opened.
+        @throws runtime_error If the file is not a valid compiled book. */
+    bool load_compiled(const string& path);
+
+    /** Load a compiled book file from a stream.
+        Can be used if the book file cannot be mapped into memory.
+        @throws runtime_error If the file is not a valid compiled book. */
+    void load_compiled(istream& in);
+
+    /** Write the current book as a compiled book file. */
+    void write_compiled(ostream& out) const;
+
     Move genmove(const Board& bd, Color c);
 
-    const PentobiTree& get_tree() const;
+    Variant get_variant() const { return m_variant; }
 
 private:
     typedef libboardgame_base::PointTransform<Point> PointTransform;
 
-    PentobiTree m_tree;
+    typedef Zobrist::HashType HashType;
+
+    struct Header
+    {
+        char magic[8];
+
+        /** Value to detect files written on machines with another byte
+            order. */
+        uint32_t byte_order;
+
+        uint32_t format_version;
+
+        /** Game variant as returned by to_string_id(), padded with zeros. */
+        char variant[16];
+
+        /** BoardConst::get_range() of the game variant. */
+        uint32_t move_range;
+
+        /** Maximum number of moves of positions in the book. */
+        uint32_t max_nu_moves;
+
+        uint32_t nu_entries;
+
+        uint32_t nu_replies;
+    };
+
+    /** Position in the compiled book.
+        The entries are sorted by hash. */
+    struct Entry
+    {
+        HashType hash;
+
+        /** Index of the first good move in the reply array. */
+        uint32_t begin;
+
+        uint32_t nu_replies;
+    };
+
+    typedef uint16_t Reply;
+
+    Variant m_variant;
 
     RandomGenerator m_random;
 
@@ -48,19 +120,49 @@ private:
 
     vector<unique_ptr<PointTransform>> m_inv_transforms;
 
-    bool genmove(const Board& bd, Color c, Move& mv,
-                 const PointTransform& transform,
-                 const PointTransform& inv_transform);
+    /** Hash of the occupied points for each transformation.
+        Used in get_canonical_hash(). */
+    vector<HashType> m_transformed_hash;
 
-    const SgfNode* select_child(const Board& bd, Color c,
-                                const PentobiTree& tree, const SgfNode& node,
-                                const PointTransform& inv_transform);
-};
+    /** Compiled book if it was mapped from a file. */
+    MappedFile m_file;
 
-inline const PentobiTree& Book::get_tree() const
-{
-    return m_tree;
-}
+    /** Compiled book if it was created or read into memory. */
+    vector<char> m_buffer;
+
+    const Header* m_header = nullptr;
+
+    const Entry* m_entries = nullptr;
+
+    const Reply* m_replies = nullptr;
+
+    void add_replies(Board& bd, const PentobiTree& tree, const SgfNode& node,
+                     map<HashType, vector<Move>>& replies,
+                     unsigned& max_nu_moves);
+
+    /** Replace the book by an empty book. */
+    void clear();
+
+    void create_compiled(const map<HashType, vector<Move>>& replies,
+                         unsigned max_nu_moves);
+
+    /** Get the hash of a position normalized for symmetry.
+        @param bd The board
+        @param c The color to play
+        @param[out] transform The index of the transformation in
+        m_transforms that transforms the position into the normalized
+        position. */
+    HashType get_canonical_hash(const Board& bd, Color c,
+                                unsigned& transform);
+
+    static size_t get_size(const Header& header);
+
+    /** Use a compiled book.
+        The data must stay valid while the book is used.
+        @throws runtime_error If the data is not a valid compiled book. In
+        this case, the book is not changed. */
+    void init_compiled(const char* data, size_t size);
+};
 
 //-----------------------------------------------------------------------------
 
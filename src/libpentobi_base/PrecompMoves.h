@@ -7,6 +7,9 @@
 #ifndef LIBPENTOBI_BASE_PRECOMP_MOVES_H
 #define LIBPENTOBI_BASE_PRECOMP_MOVES_H
 
+#include <algorithm>
+#include <istream>
+#include <ostream>
 #include "Grid.h"
 #include "Move.h"
 #include "PieceMap.h"
@@ -91,6 +94,15 @@ public:
         during the construction. */
     const Move* move_lists_begin() const { return &(*m_move_lists.begin()); }
 
+    /** Write the lists in a binary format for BoardConst::set_cache_dir().
+        The format depends on the platform and the build configuration. */
+    void write(ostream& out, const Geometry& geo) const;
+
+    /** Read lists written by write().
+        @return @c false if reading failed, in which case the content of the
+        lists is undefined. */
+    bool read(istream& in, const Geometry& geo);
+
 private:
     class CompressedRange
     {
@@ -127,6 +139,44 @@ private:
     array<Move, max_move_lists_sum_length> m_move_lists;
 };
 
+inline bool PrecompMoves::read(istream& in, const Geometry& geo)
+{
+    for (Point p : geo)
+        in.read(reinterpret_cast<char*>(&m_moves_range[p]),
+                sizeof(m_moves_range[p]));
+    uint_least32_t size;
+    in.read(reinterpret_cast<char*>(&size), sizeof(size));
+    if (! in || size > max_move_lists_sum_length)
+        return false;
+    in.read(reinterpret_cast<char*>(&m_move_lists[0]), size * sizeof(Move));
+    if (! in)
+        return false;
+    for (Point p : geo)
+        for (auto& ranges : m_moves_range[p])
+            for (Piece::IntType i = 0; i < Piece::max_pieces; ++i)
+                if (ranges[Piece(i)].begin() + ranges[Piece(i)].size() > size)
+                    return false;
+    return true;
+}
+
+inline void PrecompMoves::write(ostream& out, const Geometry& geo) const
+{
+    uint_least32_t size = 0;
+    for (Point p : geo)
+    {
+        out.write(reinterpret_cast<const char*>(&m_moves_range[p]),
+                  sizeof(m_moves_range[p]));
+        for (auto& ranges : m_moves_range[p])
+            for (Piece::IntType i = 0; i < Piece::max_pieces; ++i)
+                size = max(size, static_cast<uint_least32_t>(
+                               ranges[Piece(i)].begin()
+                               + ranges[Piece(i)].size()));
+    }
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(reinterpret_cast<const char*>(&m_move_lists[0]),
+              size * sizeof(Move));
+}
+
 //-----------------------------------------------------------------------------
 
 } // namespace libpentobi_base
@@ -10,6 +10,7 @@
 
 #include "Variant.h"
 
+#include <mutex>
 #include "CallistoGeometry.h"
 #include "GembloQGeometry.h"
 #include "NexosGeometry.h"
@@ -92,6 +93,9 @@ BoardType get_board_type(Variant variant)
 
 const Geometry& get_geometry(BoardType board_type)
 {
+    // The geometry classes create their instances without locking
+    static mutex geometry_mutex;
+    lock_guard<mutex> lock(geometry_mutex);
     const Geometry* result = nullptr; // Init to avoid compiler warning
     switch (board_type)
     {
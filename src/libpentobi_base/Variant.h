@@ -142,6 +142,9 @@ inline Color::Range get_colors(Variant variant)
 
 Color::IntType get_nu_players(Variant variant);
 
+/** Get the geometry of a board type.
+    The geometry is created the first time it is needed. This function is
+    thread-safe. */
 const Geometry& get_geometry(BoardType board_type);
 
 const Geometry& get_geometry(Variant variant);
@@ -0,0 +1,46 @@
+//-----------------------------------------------------------------------------
+/** @file libpentobi_base/Zobrist.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "Zobrist.h"
+
+#include <random>
+
+namespace libpentobi_base {
+
+//-----------------------------------------------------------------------------
+
+Zobrist::Zobrist()
+{
+    // Use a fixed seed independent of RandomGenerator::set_global_seed(),
+    // hashes may be stored in files.
+    mt19937_64 generator(20160901);
+    for_each_color([&](Color c) {
+        for (auto& i : m_point[c])
+            i = generator();
+        for (Piece::IntType i = 0; i < Piece::max_pieces; ++i)
+        {
+            auto& values = m_piece[c][Piece(i)];
+            values[0] = 0;
+            for (unsigned j = 1; j < values.size(); ++j)
+                values[j] = generator();
+        }
+        m_to_play[c] = generator();
+    });
+}
+
+const Zobrist& Zobrist::get()
+{
+    static Zobrist zobrist;
+    return zobrist;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace libpentobi_base
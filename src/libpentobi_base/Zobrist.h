@@ -0,0 +1,79 @@
+//-----------------------------------------------------------------------------
+/** @file libpentobi_base/Zobrist.h
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifndef LIBPENTOBI_BASE_ZOBRIST_H
+#define LIBPENTOBI_BASE_ZOBRIST_H
+
+#include <cstdint>
+#include "ColorMap.h"
+#include "Point.h"
+#include "PieceInfo.h"
+#include "PieceMap.h"
+
+namespace libpentobi_base {
+
+//-----------------------------------------------------------------------------
+
+/** Random values for Zobrist hashing of Blokus positions.
+    A position is hashed as the XOR of the values of all occupied points
+    (depending on the color of the point) and of the number of placed
+    instances of each piece per color. The number of placed instances is
+    needed because different sets of pieces can occupy the same points.
+    The values for zero placed instances are zero, such that the empty
+    board has hash 0 independent of the game variant. The values are
+    generated with a fixed seed, so hashes are reproducible across runs.
+    (@ref libboardgame_doc_threadsafe_after_construction) */
+class Zobrist
+{
+public:
+    typedef uint64_t HashType;
+
+    static const Zobrist& get();
+
+    HashType get_point(Color c, Point p) const;
+
+    /** Get the value for a given number of placed instances of a piece.
+        @param c
+        @param piece
+        @param nu_placed The number of placed instances in
+        [0..PieceInfo::max_instances] */
+    HashType get_piece(Color c, Piece piece, unsigned nu_placed) const;
+
+    HashType get_to_play(Color c) const;
+
+private:
+    ColorMap<array<HashType, Point::range>> m_point;
+
+    ColorMap<PieceMap<array<HashType, PieceInfo::max_instances + 1>>>
+    m_piece;
+
+    ColorMap<HashType> m_to_play;
+
+    Zobrist();
+};
+
+inline auto Zobrist::get_piece(Color c, Piece piece,
+                               unsigned nu_placed) const -> HashType
+{
+    LIBBOARDGAME_ASSERT(nu_placed <= PieceInfo::max_instances);
+    return m_piece[c][piece][nu_placed];
+}
+
+inline auto Zobrist::get_point(Color c, Point p) const -> HashType
+{
+    return m_point[c][p.to_int()];
+}
+
+inline auto Zobrist::get_to_play(Color c) const -> HashType
+{
+    return m_to_play[c];
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace libpentobi_base
+
+#endif // LIBPENTOBI_BASE_ZOBRIST_H
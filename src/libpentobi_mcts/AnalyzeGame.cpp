@@ -10,7 +10,7 @@
 
 #include "AnalyzeGame.h"
 
-#include "Search.h"
+#include "Player.h"
 #include "libboardgame_util/Log.h"
 #include "libboardgame_util/WallTimeSource.h"
 
@@ -31,8 +31,18 @@ void AnalyzeGame::clear()
     m_values.clear();
 }
 
-void AnalyzeGame::run(const Game& game, Search& search, size_t nu_simulations,
+void AnalyzeGame::run(const Game& game, Player& player, size_t nu_simulations,
                       const function<void(unsigned,unsigned)>& progress_callback)
+{
+    player.with_search([&](auto& search) {
+        this->run_search(game, search, nu_simulations, progress_callback);
+    });
+}
+
+template<class S>
+void AnalyzeGame::run_search(
+        const Game& game, S& search, size_t nu_simulations,
+        const function<void(unsigned,unsigned)>& progress_callback)
 {
     m_variant = game.get_variant();
     m_moves.clear();
@@ -54,7 +64,7 @@ void AnalyzeGame::run(const Game& game, Search& search, size_t nu_simulations,
     clear_abort();
     node = &root;
     unsigned move_number = 0;
-    auto tie_value = Search::SearchParamConst::tie_value;
+    auto tie_value = S::SearchParamConst::tie_value;
     do
     {
         auto mv = tree.get_move(*node);
@@ -73,7 +83,8 @@ void AnalyzeGame::run(const Game& game, Search& search, size_t nu_simulations,
                 {
                     updater.update(*bd, tree, node->get_parent());
                     LIBBOARDGAME_LOG("Analyzing move ", bd->get_nu_moves());
-                    const Float max_count = Float(nu_simulations);
+                    auto max_count =
+                            static_cast<typename S::Float>(nu_simulations);
                     double max_time = 0;
                     // Set min_simulations to a reasonable value because
                     // nu_simulations can be reached without having that many
@@ -13,7 +13,7 @@
 
 namespace libpentobi_mcts {
 
-class Search;
+class Player;
 
 using namespace std;
 using libpentobi_base::ColorMove;
@@ -32,12 +32,12 @@ public:
         The analysis can be aborted from a different thread with
         libboardgame_util::set_abort().
         @param game
-        @param search
+        @param player The player whose search is used
         @param nu_simulations
         @param progress_callback Function that will be called at the beginning
         of the analysis of a position. Arguments: number moves analyzed so far,
         total number of moves. */
-    void run(const Game& game, Search& search, size_t nu_simulations,
+    void run(const Game& game, Player& player, size_t nu_simulations,
              const function<void(unsigned,unsigned)>& progress_callback);
 
     Variant get_variant() const;
@@ -56,6 +56,11 @@ private:
     vector<ColorMove> m_moves;
 
     vector<double> m_values;
+
+
+    template<class S>
+    void run_search(const Game& game, S& search, size_t nu_simulations,
+                    const function<void(unsigned,unsigned)>& progress_callback);
 };
 
 
@@ -12,6 +12,7 @@
 
 #include <fstream>
 #include <iomanip>
+#include "Util.h"
 #include "libboardgame_util/CpuTimeSource.h"
 #include "libboardgame_util/WallTimeSource.h"
 #include "libboardgame_sys/Memory.h"
@@ -74,9 +75,11 @@ static const float counts_gembloq_2[Player::max_supported_level] =
 //-----------------------------------------------------------------------------
 
 Player::Player(Variant initial_variant, unsigned max_level,
-               const string&  books_dir, unsigned nu_threads)
+               const string&  books_dir, unsigned nu_threads, size_t memory,
+               bool long_analysis)
     : m_is_book_loaded(false),
       m_use_book(true),
+      m_use_solver(true),
       m_resign(false),
       m_books_dir(books_dir),
       m_max_level(max_level),
@@ -84,10 +87,19 @@ Player::Player(Variant initial_variant, unsigned max_level,
       m_fixed_simulations(0),
       m_resign_threshold(0.09f),
       m_resign_min_simulations(500),
-      m_search(initial_variant, nu_threads, get_memory()),
       m_book(initial_variant),
       m_time_source(new WallTimeSource)
 {
+    memory = get_memory(memory);
+    if (nu_threads == 0)
+        nu_threads = util::get_nu_threads();
+    if (long_analysis)
+        m_search_long =
+                make_unique<SearchLong>(initial_variant, nu_threads, memory);
+    else if (nu_threads == 1)
+        m_search_st = make_unique<SearchST>(initial_variant, 1, memory);
+    else
+        m_search = make_unique<Search>(initial_variant, nu_threads, memory);
     for (unsigned i = 0; i < Board::max_player_moves; ++i)
     {
         // Hand-tuned such that time per move is more evenly spread among all
@@ -145,8 +157,12 @@ Move Player::genmove(const Board& bd, Color c)
         && (level >= 4 || bd.get_nu_moves() < 2u * bd.get_nu_colors()))
     {
         if (! is_book_loaded(variant))
-            load_book(m_books_dir
-                      + "/book_" + to_string_id(variant) + ".blksgf");
+        {
+            m_is_book_loaded = false;
+            auto filepath = m_books_dir + "/book_" + to_string_id(variant);
+            if (! load_compiled_book(filepath + ".blkbook"))
+                load_book(filepath + ".blksgf");
+        }
         if (m_is_book_loaded)
         {
             mv = m_book.genmove(bd, c);
@@ -154,6 +170,14 @@ Move Player::genmove(const Board& bd, Color c)
                 return mv;
         }
     }
+    if (m_use_solver && level >= 4)
+    {
+        if (! m_solver)
+            m_solver = make_unique<Solver>();
+        ScoreType score;
+        if (m_solver->is_applicable(bd) && m_solver->solve(bd, c, mv, score))
+            return mv;
+    }
     Float max_count = 0;
     double max_time = 0;
     if (m_fixed_simulations > 0)
@@ -229,20 +253,34 @@ Move Player::genmove(const Board& bd, Color c)
         LIBBOARDGAME_LOG("MaxCnt ", fixed, setprecision(0), max_count);
     else
         LIBBOARDGAME_LOG("MaxTime ", max_time);
-    if (! m_search.search(mv, bd, c, max_count, 0, max_time, *m_time_source))
+    bool result = with_search([&](auto& search) {
+        if (! search.search(mv, bd, c, max_count, 0, max_time,
+                            *m_time_source))
+            return false;
+        // Resign only in two-player game variants
+        if (get_nu_players(variant) == 2)
+            if (search.get_root_visit_count() > m_resign_min_simulations
+                    && search.get_root_val().get_mean() < m_resign_threshold)
+                m_resign = true;
+        return true;
+    });
+    if (! result)
         return Move::null();
-    // Resign only in two-player game variants
-    if (get_nu_players(variant) == 2)
-        if (m_search.get_root_visit_count() > m_resign_min_simulations
-                && m_search.get_root_val().get_mean() < m_resign_threshold)
-            m_resign = true;
     return mv;
 }
 
-/** Suggest how much memory to use for the trees depending on the maximum
-    level used. */
-size_t Player::get_memory()
+/** Suggest how much memory to use for the tree depending on the maximum
+    level used.
+    The memory is only reserved and used as the tree grows, but we still
+    limit it to a fraction of the system memory to avoid swapping.
+    @param memory The memory requested by the user (0 if none) */
+size_t Player::get_memory(size_t memory)
 {
+    if (memory != 0)
+    {
+        LIBBOARDGAME_LOG("Using max. ", memory / 1000000, " MB");
+        return memory;
+    }
     size_t available = libboardgame_sys::get_memory();
     if (available == 0)
     {
@@ -271,8 +309,8 @@ size_t Player::get_memory()
                           / counts_trigon[max(m_max_level, 5u) - 1], 0.8);
         wanted = static_cast<size_t>(double(wanted) / factor);
     }
-    size_t memory = min(wanted, reasonable);
-    LIBBOARDGAME_LOG("Using ", memory / 1000000, " MB of ",
+    memory = min(wanted, reasonable);
+    LIBBOARDGAME_LOG("Using max. ", memory / 1000000, " MB of ",
                      available / 1000000, " MB");
     return memory;
 }
@@ -345,7 +383,7 @@ Rating Player::get_rating(Variant variant, unsigned level)
 
 bool Player::is_book_loaded(Variant variant) const
 {
-    return m_is_book_loaded && m_book.get_tree().get_variant() == variant;
+    return m_is_book_loaded && m_book.get_variant() == variant;
 }
 
 void Player::load_book(istream& in)
@@ -368,6 +406,35 @@ bool Player::load_book(const string& filepath)
     return true;
 }
 
+bool Player::load_compiled_book(const string& filepath)
+{
+    try
+    {
+        if (! m_book.load_compiled(filepath))
+            return false;
+    }
+    catch (const runtime_error& e)
+    {
+        LIBBOARDGAME_LOG("Could not load book ", filepath, ": ", e.what());
+        return false;
+    }
+    m_is_book_loaded = true;
+    LIBBOARDGAME_LOG("Loaded book ", filepath);
+    return true;
+}
+
+void Player::ponder(const Board& bd, Color c)
+{
+    if (! bd.has_moves(c))
+        return;
+    LIBBOARDGAME_LOG("Pondering");
+    Move mv;
+    with_search([&](auto& search) {
+        search.search(mv, bd, c, 0, 0, numeric_limits<double>::max(),
+                      *m_time_source);
+    });
+}
+
 bool Player::resign() const
 {
     return m_resign;
@@ -8,6 +8,7 @@
 #define LIBPENTOBI_MCTS_PLAYER_H
 
 #include "Search.h"
+#include "Solver.h"
 #include "libboardgame_base/Rating.h"
 #include "libpentobi_base/Book.h"
 #include "libpentobi_base/PlayerBase.h"
@@ -34,9 +35,17 @@ public:
         @param max_level The maximum level used
         @param books_dir Directory containing opening books.
         @param nu_threads The number of threads to use in the search (0 means
-        to select a reasonable default value) */
+        to select a reasonable default value). If the search uses only one
+        thread, the player uses SearchST, which avoids the overhead of atomic
+        operations.
+        @param memory The maximum memory used for the search tree (0 means
+        to select a default value depending on the system memory and
+        max_level)
+        @param long_analysis Use SearchLong instead of Search or SearchST.
+        Needed for searches with more than 2^24 simulations. */
     Player(Variant initial_variant, unsigned max_level, const string& books_dir,
-           unsigned nu_threads = 0);
+           unsigned nu_threads = 0, size_t memory = 0,
+           bool long_analysis = false);
 
     ~Player();
 
@@ -44,6 +53,16 @@ public:
 
     bool resign() const override;
 
+    /** Search on the opponent's time.
+        Runs a search without count or time limit in the given position until
+        it is aborted with libboardgame_util::set_abort(). A later call of
+        genmove() in the same or a follow-up position can reuse the search
+        tree (if Search::get_reuse_tree() or Search::get_reuse_subtree() are
+        enabled).
+        @param bd The board. Must stay unmodified and valid during the call.
+        @param c The color to play */
+    void ponder(const Board& bd, Color c);
+
     Float get_fixed_simulations() const;
 
     double get_fixed_time() const;
@@ -63,6 +82,16 @@ public:
 
     void set_use_book(bool enable);
 
+    /** Use the endgame solver.
+        If enabled, genmove() plays the move found by Solver in endgame
+        positions, in which Solver::is_applicable() returns true and the
+        solver finishes within its node limit. The solver is not used in
+        levels below 4.
+        Default is true. */
+    bool get_use_solver() const;
+
+    void set_use_solver(bool enable);
+
     unsigned get_level() const;
 
     void set_level(unsigned level);
@@ -70,7 +99,13 @@ public:
     /** Use CPU time instead of Wall time to measure time. */
     void use_cpu_time(bool enable);
 
-    Search& get_search();
+    bool is_long_analysis() const;
+
+    /** Call a function with the search used by the player.
+        The function is called with a Search, SearchST or SearchLong
+        argument, so it should usually be a generic lambda. */
+    template<class F>
+    auto with_search(F f) -> decltype(f(declval<Search&>()));
 
     void load_book(istream& in);
 
@@ -93,6 +128,8 @@ private:
 
     bool m_use_book;
 
+    bool m_use_solver;
+
     bool m_resign;
 
     string m_books_dir;
@@ -119,18 +156,33 @@ private:
 
     double m_fixed_time;
 
-    Search m_search;
+    /** @name Searches
+        Exactly one of the searches is created. */
+    /** @{ */
+
+    unique_ptr<Search> m_search;
+
+    unique_ptr<SearchST> m_search_st;
+
+    unique_ptr<SearchLong> m_search_long;
+
+    /** @} */ // @name
 
     Book m_book;
 
+    /** Created on the first use. */
+    unique_ptr<Solver> m_solver;
+
     unique_ptr<TimeSource> m_time_source;
 
 
-    size_t get_memory();
+    size_t get_memory(size_t memory);
 
     void init_settings();
 
     bool load_book(const string& filepath);
+
+    bool load_compiled_book(const string& filepath);
 };
 
 inline Float Player::get_fixed_simulations() const
@@ -153,14 +205,19 @@ inline Rating Player::get_rating(Variant variant) const
     return get_rating(variant, m_level);
 }
 
-inline Search& Player::get_search()
+inline bool Player::get_use_book() const
+{
+    return m_use_book;
+}
+
+inline bool Player::get_use_solver() const
 {
-    return m_search;
+    return m_use_solver;
 }
 
-inline bool Player::get_use_book() const
+inline bool Player::is_long_analysis() const
 {
-    return m_use_book;
+    return static_cast<bool>(m_search_long);
 }
 
 inline void Player::set_fixed_simulations(Float n)
@@ -187,6 +244,21 @@ inline void Player::set_use_book(bool enable)
     m_use_book = enable;
 }
 
+inline void Player::set_use_solver(bool enable)
+{
+    m_use_solver = enable;
+}
+
+template<class F>
+inline auto Player::with_search(F f) -> decltype(f(declval<Search&>()))
+{
+    if (m_search_st)
+        return f(*m_search_st);
+    if (m_search_long)
+        return f(*m_search_long);
+    return f(*m_search);
+}
+
 //-----------------------------------------------------------------------------
 
 } // namespace libpentobi_mcts
@@ -9,7 +9,6 @@
 
 #include "Float.h"
 #include "SearchParamConst.h"
-#include "libboardgame_mcts/Tree.h"
 #include "libboardgame_util/MathUtil.h"
 #include "libpentobi_base/Board.h"
 
@@ -35,21 +34,21 @@ using libpentobi_base::Variant;
 class PriorKnowledge
 {
 public:
-    typedef libboardgame_mcts::Node<Move, Float, SearchParamConst::multithread>
-    Node;
-
-    typedef libboardgame_mcts::Tree<Node> Tree;
-
     PriorKnowledge();
 
     void start_search(const Board& bd);
 
     /** Generate children nodes initialized with prior knowledge.
+        @param bd
+        @param moves
+        @param is_symmetry_broken
+        @param expander The libboardgame_mcts::Tree::NodeExpander of the
+        search (depends on the node type of the search)
+        @param root_val
         @return false If the tree has not enough capacity for the children. */
-    template<unsigned MAX_SIZE, unsigned MAX_ADJ_ATTACH>
+    template<unsigned MAX_SIZE, unsigned MAX_ADJ_ATTACH, class E>
     bool gen_children(const Board& bd, const MoveList& moves,
-                      bool is_symmetry_broken, Tree::NodeExpander& expander,
-                      Float root_val);
+                      bool is_symmetry_broken, E& expander, Float root_val);
 
 private:
     struct MoveFeatures
@@ -274,10 +273,10 @@ void PriorKnowledge::compute_features(const Board& bd, const MoveList& moves,
     }
 }
 
-template<unsigned MAX_SIZE, unsigned MAX_ADJ_ATTACH>
+template<unsigned MAX_SIZE, unsigned MAX_ADJ_ATTACH, class E>
 bool PriorKnowledge::gen_children(const Board& bd, const MoveList& moves,
-                                  bool is_symmetry_broken,
-                                  Tree::NodeExpander& expander, Float root_val)
+                                  bool is_symmetry_broken, E& expander,
+                                  Float root_val)
 {
     if (moves.empty())
     {
@@ -11,25 +11,36 @@
 #include "Search.h"
 
 #include "Util.h"
+#include "libboardgame_util/Timer.h"
+#include "libboardgame_util/WallTimeSource.h"
 
 namespace libpentobi_mcts {
 
+using libboardgame_util::Timer;
+using libboardgame_util::WallTimeSource;
+
 //-----------------------------------------------------------------------------
 
-Search::Search(Variant initial_variant, unsigned nu_threads, size_t memory)
+template<class R>
+BasicSearch<R>::BasicSearch(Variant initial_variant, unsigned nu_threads,
+                            size_t memory)
     : SearchBase(nu_threads == 0 ? util::get_nu_threads() : nu_threads,
                  memory),
       m_auto_param(true),
       m_variant(initial_variant),
-      m_shared_const(m_to_play)
+      m_shared_const(m_to_play),
+      m_init_time(0),
+      m_is_init_followup(false)
 {
     set_default_param(m_variant);
-    create_threads();
+    this->create_threads();
 }
 
-Search::~Search() = default;
+template<class R>
+BasicSearch<R>::~BasicSearch() = default;
 
-bool Search::check_followup(ArrayList<Move, max_moves>& sequence)
+template<class R>
+bool BasicSearch<R>::check_followup(ArrayList<Move, max_moves>& sequence)
 {
     auto& bd = get_board();
     m_history.init(bd, m_to_play);
@@ -51,23 +62,31 @@ bool Search::check_followup(ArrayList<Move, max_moves>& sequence)
     return is_followup;
 }
 
-unique_ptr<State> Search::create_state()
+template<class R>
+unique_ptr<State> BasicSearch<R>::create_state()
 {
     return make_unique<State>(m_variant, m_shared_const);
 }
 
-void Search::get_root_position(Variant& variant, Setup& setup) const
+template<class R>
+void BasicSearch<R>::get_root_position(Variant& variant, Setup& setup) const
 {
     m_last_history.get_as_setup(variant, setup);
     setup.to_play = m_to_play;
 }
 
-void Search::on_start_search(bool is_followup)
+template<class R>
+void BasicSearch<R>::on_start_search(bool is_followup)
 {
+    WallTimeSource time_source;
+    Timer timer(time_source);
     m_shared_const.init(is_followup);
+    m_init_time = timer();
+    m_is_init_followup = is_followup;
 }
 
-bool Search::search(Move& mv, const Board& bd, Color to_play,
+template<class R>
+bool BasicSearch<R>::search(Move& mv, const Board& bd, Color to_play,
                     Float max_count, size_t min_simulations,
                     double max_time, TimeSource& time_source)
 {
@@ -97,11 +116,12 @@ bool Search::search(Move& mv, const Board& bd, Color to_play,
     return result;
 }
 
-void Search::set_default_param(Variant variant)
+template<class R>
+void BasicSearch<R>::set_default_param(Variant variant)
 {
     LIBBOARDGAME_LOG("Setting default parameters for ", to_string(variant));
-    set_rave_weight(0.7f);
-    set_rave_child_max(2000);
+    this->set_rave_weight(0.7f);
+    this->set_rave_child_max(2000);
     // The following parameters are currently tuned for duo, classic_2 and
     // trigon_2 and used for all other game variants with the same board type
     switch (variant)
@@ -112,14 +132,14 @@ void Search::set_default_param(Variant variant)
     case Variant::gembloq: // Not tuned
     case Variant::gembloq_2_4: // Not tuned
     case Variant::gembloq_3: // Not tuned
-        set_exploration_constant(0.021f);
-        set_rave_parent_max(50000);
+        this->set_exploration_constant(0.021f);
+        this->set_rave_parent_max(50000);
         break;
     case Variant::duo:
     case Variant::junior:
     case Variant::gembloq_2: // Not tuned
-        set_exploration_constant(0.020f);
-        set_rave_parent_max(25000);
+        this->set_exploration_constant(0.020f);
+        this->set_rave_parent_max(25000);
         break;
     case Variant::trigon:
     case Variant::trigon_2:
@@ -127,48 +147,60 @@ void Search::set_default_param(Variant variant)
     case Variant::callisto:
     case Variant::callisto_2_4:
     case Variant::callisto_3:
-        set_exploration_constant(0.014f);
-        set_rave_parent_max(50000);
+        this->set_exploration_constant(0.014f);
+        this->set_rave_parent_max(50000);
         break;
     case Variant::nexos:
     case Variant::nexos_2:
-        set_exploration_constant(0.008f);
-        set_rave_parent_max(50000);
+        this->set_exploration_constant(0.008f);
+        this->set_rave_parent_max(50000);
         break;
     case Variant::callisto_2:
-        set_exploration_constant(0.011f);
-        set_rave_parent_max(25000);
+        this->set_exploration_constant(0.011f);
+        this->set_rave_parent_max(25000);
         break;
     }
 }
 
-string Search::get_info() const
+template<class R>
+string BasicSearch<R>::get_info() const
 {
-    if (get_nu_simulations() == 0)
+    if (this->get_nu_simulations() == 0)
         return string();
-    auto& root = get_tree().get_root();
+    auto& root = this->get_tree().get_root();
     if (! root.has_children())
         return string();
     ostringstream s;
     s << SearchBase::get_info()
-      << "Mov: " << root.get_nu_children() << ", ";
+      << "Mov: " << root.get_nu_children() << ", Init: " << fixed
+      << setprecision(1) << 1000 * m_init_time << " ms"
+      << (m_is_init_followup ? " (followup)" : "") << ", ";
     if (libpentobi_base::get_nu_players(m_variant) > 2)
     {
         s << "All:";
         for (PlayerInt i = 0; i < libpentobi_base::get_nu_colors(m_variant);
              ++i)
         {
-            if (get_root_val(i).get_count() == 0)
+            if (this->get_root_val(i).get_count() == 0)
                 s << " -";
             else
-                s << " " << setprecision(2) << get_root_val(i).get_mean();
+                s << " " << setprecision(2)
+                  << this->get_root_val(i).get_mean();
         }
         s << ", ";
     }
-    s << get_state(0).get_info();
+    s << this->get_state(0).get_info();
     return s.str();
 }
 
 //-----------------------------------------------------------------------------
 
+template class BasicSearch<SearchParamConst>;
+
+template class BasicSearch<SearchParamConstST>;
+
+template class BasicSearch<SearchParamConstLong>;
+
+//-----------------------------------------------------------------------------
+
 } // namespace libpentobi_mcts
@@ -29,14 +29,24 @@ using libpentobi_base::Setup;
     game result with the main color of the player.
     The maximum number of players is 6, which occurs in Classic 3 with 3
     real players and 3 pseudo-players for the 4th color.
-    @note @ref libboardgame_avoid_stack_allocation */
-class Search final
-    : public libboardgame_mcts::SearchBase<State, Move, SearchParamConst>
+    @note @ref libboardgame_avoid_stack_allocation
+    @tparam R The compile-time parameters (SearchParamConst,
+    SearchParamConstST or SearchParamConstLong). The class is explicitly
+    instantiated for all of them in Search.cpp. */
+template<class R>
+class BasicSearch final
+    : public libboardgame_mcts::SearchBase<State, Move, R>
 {
 public:
-    Search(Variant initial_variant, unsigned nu_threads, size_t memory);
+    typedef libboardgame_mcts::SearchBase<State, Move, R> SearchBase;
 
-    ~Search();
+    typedef typename SearchBase::Float Float;
+
+    using SearchBase::max_moves;
+
+    BasicSearch(Variant initial_variant, unsigned nu_threads, size_t memory);
+
+    ~BasicSearch();
 
     unique_ptr<State> create_state() override;
 
@@ -96,6 +106,13 @@ private:
 
     SharedConst m_shared_const;
 
+    /** Wall time of SharedConst::init() in the last search in seconds. */
+    double m_init_time;
+
+    /** Whether SharedConst::init() was called for a follow-up position in
+        the last search. */
+    bool m_is_init_followup;
+
     /** Local variable reused for efficiency. */
     History m_history;
 
@@ -106,32 +123,38 @@ private:
     void set_default_param(Variant variant);
 };
 
-inline bool Search::get_auto_param() const
+template<class R>
+inline bool BasicSearch<R>::get_auto_param() const
 {
     return m_auto_param;
 }
 
-inline bool Search::get_avoid_symmetric_draw() const
+template<class R>
+inline bool BasicSearch<R>::get_avoid_symmetric_draw() const
 {
     return m_shared_const.avoid_symmetric_draw;
 }
 
-inline const Board& Search::get_board() const
+template<class R>
+inline const Board& BasicSearch<R>::get_board() const
 {
     return *m_shared_const.board;
 }
 
-inline const History& Search::get_last_history() const
+template<class R>
+inline const History& BasicSearch<R>::get_last_history() const
 {
     return m_last_history;
 }
 
-inline PlayerInt Search::get_nu_players() const
+template<class R>
+inline PlayerInt BasicSearch<R>::get_nu_players() const
 {
     return m_variant != Variant::classic_3 ? get_board().get_nu_colors() : 6;
 }
 
-inline PlayerInt Search::get_player() const
+template<class R>
+inline PlayerInt BasicSearch<R>::get_player() const
 {
     auto to_play = m_to_play.to_int();
     if ( m_variant == Variant::classic_3 && to_play == 3)
@@ -140,21 +163,35 @@ inline PlayerInt Search::get_player() const
         return to_play;
 }
 
-inline Color Search::get_to_play() const
+template<class R>
+inline Color BasicSearch<R>::get_to_play() const
 {
     return m_to_play;
 }
 
-inline void Search::set_auto_param(bool enable)
+template<class R>
+inline void BasicSearch<R>::set_auto_param(bool enable)
 {
     m_auto_param = enable;
 }
 
-inline void Search::set_avoid_symmetric_draw(bool enable)
+template<class R>
+inline void BasicSearch<R>::set_avoid_symmetric_draw(bool enable)
 {
     m_shared_const.avoid_symmetric_draw = enable;
 }
 
+/** The search used for playing. */
+typedef BasicSearch<SearchParamConst> Search;
+
+/** The search used for playing with a single thread.
+    @see SearchParamConstST */
+typedef BasicSearch<SearchParamConstST> SearchST;
+
+/** The search used for long analysis.
+    @see SearchParamConstLong */
+typedef BasicSearch<SearchParamConstLong> SearchLong;
+
 //-----------------------------------------------------------------------------
 
 } // namespace libpentobi_mcts
@@ -21,10 +21,13 @@ using libpentobi_base::Color;
 
 /** Optional compile-time parameters for libboardgame_mcts::Search.
     See libboardgame_mcts::SearchParamConstDefault for the meaning of the
-    members. */
-struct SearchParamConst
+    members.
+    @tparam F The floating type for the values and counts in the search.
+    @tparam MT Support multi-threading. */
+template<typename F, bool MT>
+struct BasicSearchParamConst
 {
-    typedef libpentobi_mcts::Float Float;
+    typedef F Float;
 
     static const PlayerInt max_players = 6;
 
@@ -37,11 +40,7 @@ struct SearchParamConst
     static const unsigned max_moves =
             Color::range * (Color::range * Board::max_pieces + 1);
 
-#ifdef LIBBOARDGAME_MCTS_SINGLE_THREAD
-    static const bool multithread = false;
-#else
-    static const bool multithread = true;
-#endif
+    static const bool multithread = MT;
 
     static const bool rave = true;
 
@@ -59,6 +58,14 @@ struct SearchParamConst
 
     static const bool use_unlikely_change = true;
 
+    static const bool simd_select_child = true;
+
+#ifdef LIBPENTOBI_MCTS_COMPACT_NODE
+    static const bool compact_node = true;
+#else
+    static const bool compact_node = false;
+#endif
+
     static constexpr Float child_min_count = 3;
 
     static constexpr Float tie_value = 0.5f;
@@ -72,6 +79,38 @@ struct SearchParamConst
     static constexpr double expected_sim_per_sec = 100;
 };
 
+/** Compile-time parameters of the search used for playing. */
+struct SearchParamConst
+#ifdef LIBBOARDGAME_MCTS_SINGLE_THREAD
+    : public BasicSearchParamConst<Float, false>
+#else
+    : public BasicSearchParamConst<Float, true>
+#endif
+{
+};
+
+/** Compile-time parameters of the search used for playing with a single
+    thread.
+    Avoids the overhead of atomic operations in the search tree, the
+    last-good-reply table and the statistics. */
+struct SearchParamConstST
+    : public BasicSearchParamConst<Float, false>
+{
+};
+
+/** Compile-time parameters of the search used for long analysis.
+    Uses @c double for the counts to avoid the termination of the search at
+    the maximum count of @c float (2^24 simulations) at the cost of a larger
+    node size and a slightly slower search. */
+struct SearchParamConstLong
+#ifdef LIBBOARDGAME_MCTS_SINGLE_THREAD
+    : public BasicSearchParamConst<double, false>
+#else
+    : public BasicSearchParamConst<double, true>
+#endif
+{
+};
+
 //-----------------------------------------------------------------------------
 
 } // namespace libpentobi_mcts
@@ -221,12 +221,13 @@ void SharedConst::init(bool is_followup)
         if (bd.get_point_state(p).is_empty() && bc.has_adj_status_points(p))
             points.get_unchecked(n++) = p;
     points.resize(n);
+    // In Nexos, moves can also become forbidden by occupied junction points,
+    // for which BoardConst has no move lists, so update_precomp_moves() cannot
+    // find them.
+    bool is_incremental =
+            (is_followup && bc.get_board_type() != BoardType::nexos);
     for (Color c : bd.get_colors())
     {
-        auto& precomp = precomp_moves[c];
-        auto& old_precomp = (is_followup ? precomp : bc.get_precomp_moves());
-        m_is_forbidden.set();
-
         // Don't use bd.get_pieces_left() because its ordering is not preserved
         // during a game. The in-place construction requires that the loop
         // iterates in the same order as during the last construction such that
@@ -235,52 +236,11 @@ void SharedConst::init(bool is_followup)
         for (Piece::IntType i = 0; i < bc.get_nu_pieces(); ++i)
             if (bd.is_piece_left(c, Piece(i)))
                 pieces.push_back(Piece(i));
-
-        for (Point p : points)
-            if (! bd.is_forbidden(p, c))
-            {
-                auto adj_status = bd.get_adj_status(p, c);
-                for (Piece piece : pieces)
-                {
-                    if (! old_precomp.has_moves(piece, p, adj_status))
-                        continue;
-                    for (Move mv : old_precomp.get_moves(piece, p, adj_status))
-                        if (m_is_forbidden[mv] && ! bd.is_forbidden(c, mv))
-                            m_is_forbidden.clear(mv);
-                }
-            }
-        if (! is_followup)
-            for (Point p : points)
-                if (! bd.is_forbidden(p, c))
-                {
-                    auto adj_status = bd.get_adj_status(p, c);
-                    for (unsigned i = 0; i < PrecompMoves::nu_adj_status; ++i)
-                        if (is_followup_adj_status(i, adj_status))
-                            for (auto piece : pieces)
-                                precomp.set_list_range(p, i, piece, 0, 0);
-                }
-        unsigned n = 0;
-        for (Point p : points)
-        {
-            if (bd.is_forbidden(p, c))
-                continue;
-            auto adj_status = bd.get_adj_status(p, c);
-            for (unsigned i = 0; i < PrecompMoves::nu_adj_status; ++i)
-            {
-                if (! is_followup_adj_status(i, adj_status))
-                    continue;
-                for (auto piece : pieces)
-                {
-                    if (! old_precomp.has_moves(piece, p, i))
-                        continue;
-                    auto begin = n;
-                    for (auto& mv : old_precomp.get_moves(piece, p, i))
-                        if (! m_is_forbidden[mv])
-                            precomp.set_move(n++, mv);
-                    precomp.set_list_range(p, i, piece, begin, n - begin);
-                }
-            }
-        }
+        if (is_incremental)
+            update_precomp_moves(c, pieces);
+        else
+            init_precomp_moves(c, pieces, points, is_followup);
+        m_forbidden[c].copy_from(bd.is_forbidden(c), bd.get_geometry());
     }
 
     if (! is_followup)
@@ -368,6 +328,123 @@ void SharedConst::init_pieces_considered()
     is_piece_considered_none.fill(false);
 }
 
+void SharedConst::init_precomp_moves(Color c,
+                                     const Board::PiecesLeftList& pieces,
+                                     const PointList& points, bool is_followup)
+{
+    auto& bd = *board;
+    auto& bc = bd.get_board_const();
+    auto& precomp = precomp_moves[c];
+    auto& old_precomp = (is_followup ? precomp : bc.get_precomp_moves());
+    m_is_forbidden.set();
+
+    for (Point p : points)
+        if (! bd.is_forbidden(p, c))
+        {
+            auto adj_status = bd.get_adj_status(p, c);
+            for (Piece piece : pieces)
+            {
+                if (! old_precomp.has_moves(piece, p, adj_status))
+                    continue;
+                for (Move mv : old_precomp.get_moves(piece, p, adj_status))
+                    if (m_is_forbidden[mv] && ! bd.is_forbidden(c, mv))
+                        m_is_forbidden.clear(mv);
+            }
+        }
+    if (! is_followup)
+        for (Point p : points)
+            if (! bd.is_forbidden(p, c))
+            {
+                auto adj_status = bd.get_adj_status(p, c);
+                for (unsigned i = 0; i < PrecompMoves::nu_adj_status; ++i)
+                    if (is_followup_adj_status(i, adj_status))
+                        for (auto piece : pieces)
+                            precomp.set_list_range(p, i, piece, 0, 0);
+            }
+    unsigned n = 0;
+    for (Point p : points)
+    {
+        if (bd.is_forbidden(p, c))
+            continue;
+        auto adj_status = bd.get_adj_status(p, c);
+        for (unsigned i = 0; i < PrecompMoves::nu_adj_status; ++i)
+        {
+            if (! is_followup_adj_status(i, adj_status))
+                continue;
+            for (auto piece : pieces)
+            {
+                if (! old_precomp.has_moves(piece, p, i))
+                    continue;
+                auto begin = n;
+                for (auto& mv : old_precomp.get_moves(piece, p, i))
+                    if (! m_is_forbidden[mv])
+                        precomp.set_move(n++, mv);
+                precomp.set_list_range(p, i, piece, begin, n - begin);
+            }
+        }
+    }
+}
+
+void SharedConst::update_precomp_moves(Color c,
+                                       const Board::PiecesLeftList& pieces)
+{
+    auto& bd = *board;
+    auto& bc = bd.get_board_const();
+    auto& precomp = precomp_moves[c];
+    auto& is_forbidden = bd.is_forbidden(c);
+    auto& was_forbidden = m_forbidden[c];
+
+    // Only moves that include a point that became forbidden since the last
+    // call of init() need to be removed. Mark them and find the points whose
+    // lists can contain them.
+    PointList points;
+    m_is_dirty.clear();
+    m_is_forbidden.clear();
+    for (Point p : bd)
+    {
+        if (! is_forbidden[p] || was_forbidden[p])
+            continue;
+        for (Piece piece : pieces)
+            for (Move mv : bc.get_moves(piece, p))
+            {
+                if (m_is_forbidden[mv])
+                    continue;
+                m_is_forbidden.set(mv);
+                auto& info_ext_2 = bc.get_move_info_ext_2(mv);
+                for (auto i = info_ext_2.begin_scored_points();
+                     i != info_ext_2.end_scored_points(); ++i)
+                    if (! m_is_dirty.set(*i) && ! is_forbidden[*i])
+                        points.push_back(*i);
+            }
+    }
+
+    // Remove the forbidden moves from these lists in place, the lists only
+    // get shorter and keep their position in the storage of precomp
+    for (Point p : points)
+    {
+        auto adj_status = bd.get_adj_status(p, c);
+        for (unsigned i = 0; i < PrecompMoves::nu_adj_status; ++i)
+        {
+            if (! is_followup_adj_status(i, adj_status))
+                continue;
+            for (auto piece : pieces)
+            {
+                if (! precomp.has_moves(piece, p, i))
+                    continue;
+                auto moves = precomp.get_moves(piece, p, i);
+                auto begin =
+                        static_cast<unsigned>(
+                            moves.begin() - precomp.move_lists_begin());
+                auto n = begin;
+                for (auto& mv : moves)
+                    if (! m_is_forbidden[mv])
+                        precomp.set_move(n++, mv);
+                precomp.set_list_range(p, i, piece, begin, n - begin);
+            }
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------
 
 } // namespace libpentobi_mcts
@@ -8,6 +8,7 @@
 #define LIBPENTOBI_MCTS_SHARED_CONST_H
 
 #include "libpentobi_base/Board.h"
+#include "libpentobi_base/Marker.h"
 #include "libpentobi_base/MoveMarker.h"
 
 namespace libpentobi_mcts {
@@ -17,6 +18,8 @@ using libboardgame_util::ArrayList;
 using libpentobi_base::Board;
 using libpentobi_base::Color;
 using libpentobi_base::ColorMap;
+using libpentobi_base::GridExt;
+using libpentobi_base::Marker;
 using libpentobi_base::Move;
 using libpentobi_base::MoveMarker;
 using libpentobi_base::PieceMap;
@@ -75,6 +78,10 @@ public:
 
     explicit SharedConst(const Color& to_play);
 
+    /** Initialize for a search in the current position of board.
+        @param is_followup If true, the position is a follow-up position of the
+        position in the last call, which is used for updating the data
+        incrementally. */
     void init(bool is_followup);
 
 private:
@@ -82,9 +89,22 @@ private:
         Reused for efficiency. */
     MoveMarker m_is_forbidden;
 
+    /** Temporary variable used in update_precomp_moves().
+        Reused for efficiency. */
+    Marker m_is_dirty;
+
+    /** Forbidden points of each color in the position of the last call of
+        init(). */
+    ColorMap<GridExt<bool>> m_forbidden;
+
     void init_one_piece_callisto(bool is_followup);
 
     void init_pieces_considered();
+
+    void init_precomp_moves(Color c, const Board::PiecesLeftList& pieces,
+                            const PointList& points, bool is_followup);
+
+    void update_precomp_moves(Color c, const Board::PiecesLeftList& pieces);
 };
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,202 @@
+//-----------------------------------------------------------------------------
+/** @file libpentobi_mcts/Solver.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "Solver.h"
+
+#include <algorithm>
+#include <limits>
+#include "libboardgame_util/Abort.h"
+#include "libboardgame_util/Log.h"
+
+namespace libpentobi_mcts {
+
+using libboardgame_util::get_abort;
+using libpentobi_base::PieceSet;
+using libpentobi_base::Variant;
+
+//-----------------------------------------------------------------------------
+
+Solver::Solver()
+    : m_nu_nodes(0),
+      m_is_aborted(false),
+      m_variant(Variant::duo),
+      m_tt(tt_size),
+      m_marker(make_unique<MoveMarker>())
+{
+}
+
+Solver::~Solver() = default;
+
+void Solver::gen_moves(unsigned depth, Move tt_move)
+{
+    while (m_moves.size() <= depth)
+        m_moves.push_back(make_unique<MoveList>());
+    auto& bd = *m_bd;
+    auto& moves = *m_moves[depth];
+    bd.gen_moves(bd.get_to_play(), *m_marker, moves);
+    m_marker->clear(moves);
+    // Larger pieces first, they usually change the score the most and the
+    // smaller pieces often still fit in later.
+    sort(moves.begin(), moves.end(), [&](Move mv1, Move mv2) {
+        return bd.get_piece_info(bd.get_move_piece(mv1)).get_score_points()
+                > bd.get_piece_info(bd.get_move_piece(mv2)).get_score_points();
+    });
+    if (tt_move.is_null())
+        return;
+    auto i = find(moves.begin(), moves.end(), tt_move);
+    if (i != moves.end())
+        rotate(moves.begin(), i, i + 1);
+}
+
+bool Solver::is_applicable(const Board& bd)
+{
+    auto piece_set = bd.get_piece_set();
+    if (bd.get_nu_players() != 2
+            || (piece_set != PieceSet::classic
+                && piece_set != PieceSet::junior))
+        return false;
+    // Use the move list of depth 0, solve() generates it again. MoveList is
+    // too large to be put on the stack of a search thread.
+    if (m_moves.empty())
+        m_moves.push_back(make_unique<MoveList>());
+    auto& moves = *m_moves[0];
+    unsigned nu_moves = 0;
+    for (Color c : bd.get_colors())
+    {
+        bd.gen_moves(c, *m_marker, moves);
+        m_marker->clear(moves);
+        nu_moves += moves.size();
+        if (nu_moves > max_legal_moves)
+            return false;
+    }
+    return true;
+}
+
+ScoreType Solver::search(unsigned depth, ScoreType alpha, ScoreType beta,
+                         unsigned nu_passes)
+{
+    if (++m_nu_nodes > m_max_nodes
+            || ((m_nu_nodes & 0x3ff) == 0 && get_abort()))
+        m_is_aborted = true;
+    if (m_is_aborted)
+        return 0;
+    auto& bd = *m_bd;
+    Color c = bd.get_to_play();
+    auto score = bd.get_score_twoplayer(c);
+    auto hash = bd.get_hash();
+    auto& entry = m_tt[hash & (tt_size - 1)];
+    Move tt_move = Move::null();
+    if (entry.hash == hash && entry.bound != Bound::none)
+    {
+        // No cutoff at the root, we need the best move
+        auto value = score + entry.value;
+        if (depth > 0
+                && (entry.bound == Bound::exact
+                    || (entry.bound == Bound::lower && value >= beta)
+                    || (entry.bound == Bound::upper && value <= alpha)))
+            return value;
+        tt_move = entry.mv;
+    }
+    gen_moves(depth, tt_move);
+    auto& moves = *m_moves[depth];
+    Color next = bd.get_next(c);
+    bool is_same_player = bd.is_same_player(c, next);
+    auto alpha_orig = alpha;
+    ScoreType best;
+    Move best_move = Move::null();
+    if (moves.empty())
+    {
+        // The game is over if all colors had to pass in a row
+        if (nu_passes + 1u == bd.get_nu_colors())
+            return score;
+        bd.set_to_play(next);
+        if (is_same_player)
+            best = search(depth + 1, alpha, beta, nu_passes + 1);
+        else
+            best = -search(depth + 1, -beta, -alpha, nu_passes + 1);
+        bd.set_to_play(c);
+        if (m_is_aborted)
+            return 0;
+    }
+    else
+    {
+        best = -numeric_limits<ScoreType>::max();
+        // The move list at this depth is not changed by the children
+        for (Move mv : moves)
+        {
+            bd.play_undoable(c, mv);
+            ScoreType value;
+            if (is_same_player)
+                value = search(depth + 1, alpha, beta, 0);
+            else
+                value = -search(depth + 1, -beta, -alpha, 0);
+            bd.undo();
+            if (m_is_aborted)
+                return 0;
+            if (value > best)
+            {
+                best = value;
+                best_move = mv;
+                if (best > alpha)
+                {
+                    alpha = best;
+                    if (alpha >= beta)
+                        break;
+                }
+            }
+        }
+    }
+    if (depth == 0)
+        m_best_move = best_move;
+    entry.hash = hash;
+    entry.value = best - score;
+    entry.mv = best_move;
+    if (best <= alpha_orig)
+        entry.bound = Bound::upper;
+    else if (best >= beta)
+        entry.bound = Bound::lower;
+    else
+        entry.bound = Bound::exact;
+    return best;
+}
+
+bool Solver::solve(const Board& bd, Color c, Move& mv, ScoreType& score)
+{
+    m_nu_nodes = 0;
+    m_is_aborted = false;
+    // Entries of earlier calls are still valid because the values stored
+    // in the table do not depend on the root position, but the hash does not
+    // include the game variant
+    if (bd.get_variant() != m_variant)
+    {
+        fill(m_tt.begin(), m_tt.end(), Entry());
+        m_variant = bd.get_variant();
+        m_bd.reset();
+    }
+    if (! m_bd)
+        m_bd = make_unique<Board>(m_variant);
+    m_bd->copy_from(bd);
+    m_bd->set_to_play(c);
+    auto value = search(0, -numeric_limits<ScoreType>::max(),
+                        numeric_limits<ScoreType>::max(), 0);
+    if (m_is_aborted)
+    {
+        LIBBOARDGAME_LOG("Solver aborted after ", m_nu_nodes, " nodes");
+        return false;
+    }
+    mv = m_best_move;
+    score = value;
+    LIBBOARDGAME_LOG("Solver: score ", value, ", nodes ", m_nu_nodes);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace libpentobi_mcts
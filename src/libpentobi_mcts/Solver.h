@@ -0,0 +1,134 @@
+//-----------------------------------------------------------------------------
+/** @file libpentobi_mcts/Solver.h
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifndef LIBPENTOBI_MCTS_SOLVER_H
+#define LIBPENTOBI_MCTS_SOLVER_H
+
+#include <memory>
+#include <vector>
+#include "libpentobi_base/Board.h"
+#include "libpentobi_base/MoveMarker.h"
+
+namespace libpentobi_mcts {
+
+using namespace std;
+using libpentobi_base::Board;
+using libpentobi_base::Color;
+using libpentobi_base::Move;
+using libpentobi_base::MoveList;
+using libpentobi_base::MoveMarker;
+using libpentobi_base::ScoreType;
+using libpentobi_base::Zobrist;
+
+//-----------------------------------------------------------------------------
+
+/** Exact solver for endgame positions of two-player game variants.
+    Uses alpha-beta search over the score difference with a transposition
+    table. The moves are played on a single board with
+    Board::play_undoable() and taken back with Board::undo().
+    The solver is only used for game variants with the Classic or Junior
+    piece set and two players (Duo, Junior, Classic 2), in which the number
+    of legal moves drops quickly near the end of the game. */
+class Solver
+{
+public:
+    /** Default maximum number of searched nodes. */
+    static const size_t default_max_nodes = 1000000;
+
+    /** Maximum total number of legal moves of all colors for which
+        is_applicable() returns true. */
+    static const unsigned max_legal_moves = 40;
+
+    Solver();
+
+    ~Solver();
+
+    /** Check if the solver should be tried in a position.
+        Checks that the game variant is supported and that the total number
+        of legal moves of all colors is at most max_legal_moves. */
+    bool is_applicable(const Board& bd);
+
+    /** Solve a position.
+        @param bd The board
+        @param c The color to play
+        @param[out] mv A move with the best score. Null if the color has no
+        legal moves.
+        @param[out] score The score of the player of c at the end of the game
+        with optimal play, see Board::get_score_twoplayer()
+        @return @c false if the search was aborted because it exceeded the
+        maximum number of nodes or because of libboardgame_util::get_abort().
+        In this case, mv and score are not changed. */
+    bool solve(const Board& bd, Color c, Move& mv, ScoreType& score);
+
+    void set_max_nodes(size_t n) { m_max_nodes = n; }
+
+    size_t get_max_nodes() const { return m_max_nodes; }
+
+    /** Number of nodes searched in the last call of solve(). */
+    size_t get_nu_nodes() const { return m_nu_nodes; }
+
+private:
+    enum class Bound : uint8_t
+    {
+        none,
+
+        exact,
+
+        lower,
+
+        upper
+    };
+
+    /** Entry of the transposition table.
+        The value is stored relative to the score of the position, because
+        the score of a position can depend on the move history (bonus for
+        playing the 1-square piece last) but the remaining score change
+        until the end of the game does not. */
+    struct Entry
+    {
+        Zobrist::HashType hash;
+
+        ScoreType value;
+
+        Move mv;
+
+        Bound bound = Bound::none;
+    };
+
+    static const size_t tt_size = size_t(1) << 18;
+
+    size_t m_max_nodes = default_max_nodes;
+
+    size_t m_nu_nodes;
+
+    bool m_is_aborted;
+
+    /** Game variant of the entries in m_tt. */
+    libpentobi_base::Variant m_variant;
+
+    /** Best move at the root found by the last call of search(). */
+    Move m_best_move;
+
+    vector<Entry> m_tt;
+
+    unique_ptr<Board> m_bd;
+
+    /** Move list for each depth of the search. */
+    vector<unique_ptr<MoveList>> m_moves;
+
+    unique_ptr<MoveMarker> m_marker;
+
+    void gen_moves(unsigned depth, Move tt_move);
+
+    ScoreType search(unsigned depth, ScoreType alpha, ScoreType beta,
+                     unsigned nu_passes);
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace libpentobi_mcts
+
+#endif // LIBPENTOBI_MCTS_SOLVER_H
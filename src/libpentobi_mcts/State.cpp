@@ -10,6 +10,8 @@
 
 #include "State.h"
 
+#include "libboardgame_mcts/CompactNode.h"
+#include "libboardgame_mcts/Tree.h"
 #include "libboardgame_util/MathUtil.h"
 #include "libpentobi_base/ScoreUtil.h"
 #if LIBBOARDGAME_DEBUG
@@ -107,7 +109,6 @@ void State::add_starting_moves(Color c, const Board::PiecesLeftList& pieces,
         return;
     unsigned nu_moves = 0;
     auto& marker = m_marker[c];
-    auto& is_forbidden = m_bd.is_forbidden(c);
     float total_gamma = 0;
     bool is_gembloq = (m_bd.get_piece_set() == PieceSet::gembloq);
     for (Piece piece : pieces)
@@ -117,7 +118,7 @@ void State::add_starting_moves(Color c, const Board::PiecesLeftList& pieces,
             // (=quarter-square tringle) are legal.
             if (is_gembloq && ! m_bd.is_legal(c, mv))
                 continue;
-            if (check_forbidden<MAX_SIZE>(is_forbidden, mv, moves, nu_moves))
+            if (check_forbidden<MAX_SIZE>(c, mv, moves, nu_moves))
             {
                 LIBBOARDGAME_ASSERT(! marker[mv]);
                 marker.set(mv);
@@ -132,20 +133,32 @@ void State::add_starting_moves(Color c, const Board::PiecesLeftList& pieces,
 }
 
 template<unsigned MAX_SIZE>
-bool State::check_forbidden(const GridExt<bool>& is_forbidden, Move mv,
-                            MoveList& moves, unsigned& nu_moves)
+bool State::check_forbidden(Color c, Move mv, MoveList& moves,
+                            unsigned& nu_moves)
 {
-    auto p = get_move_info<MAX_SIZE>(mv).begin();
-    unsigned forbidden = is_forbidden[*p];
-    for (unsigned i = 1; i < MAX_SIZE; ++i)
-        // Logically, forbidden is a bool and the next line should be
-        //   forbidden = forbidden || is_forbidden[*(++p)]
-        // But this generates branches, which are bad for performance in this
-        // tight loop (unrolled by the compiler). So we use a bitwise OR, which
-        // works because C++ guarantees that true/false converts to 1/0.
-        forbidden |= static_cast<unsigned>(is_forbidden[*(++p)]);
-    if (forbidden != 0)
-        return false;
+    if (MAX_SIZE != 22) // GembloQ has no move masks
+    {
+        LIBBOARDGAME_ASSERT(m_move_mask_array);
+        if (m_bd.get_forbidden_bits(c).intersects(
+                    m_move_mask_array[mv.to_int()]))
+            return false;
+    }
+    else
+    {
+        auto& is_forbidden = m_bd.is_forbidden(c);
+        auto p = get_move_info<MAX_SIZE>(mv).begin();
+        unsigned forbidden = is_forbidden[*p];
+        for (unsigned i = 1; i < MAX_SIZE; ++i)
+            // Logically, forbidden is a bool and the next line should be
+            //   forbidden = forbidden || is_forbidden[*(++p)]
+            // But this generates branches, which are bad for performance in
+            // this tight loop (unrolled by the compiler). So we use a bitwise
+            // OR, which works because C++ guarantees that true/false converts
+            // to 1/0.
+            forbidden |= static_cast<unsigned>(is_forbidden[*(++p)]);
+        if (forbidden != 0)
+            return false;
+    }
     LIBBOARDGAME_ASSERT(nu_moves < MoveList::max_size);
     moves.get_unchecked(nu_moves) = mv;
     ++nu_moves;
@@ -354,7 +367,8 @@ Point State::find_best_starting_point(Color c) const
     return best;
 }
 
-bool State::gen_children(Tree::NodeExpander& expander, Float root_val)
+template<class E, typename F>
+bool State::gen_children(E& expander, F root_val)
 {
     if (m_nu_passes == m_nu_colors)
         return true;
@@ -393,43 +407,18 @@ bool State::gen_children(Tree::NodeExpander& expander, Float root_val)
     }
 }
 
+template<class P>
 bool State::gen_playout_move_full(PlayerMove<Move>& mv)
 {
     Color to_play = m_bd.get_to_play();
     while (true)
     {
         if (! m_is_move_list_initialized[to_play])
-        {
-            if (m_max_piece_size == 5)
-            {
-                if (m_is_callisto)
-                    init_moves_with_gamma<5, 16, true>(to_play);
-                else
-                    init_moves_with_gamma<5, 16, false>(to_play);
-            }
-            else if (m_max_piece_size == 6)
-                init_moves_with_gamma<6, 22, false>(to_play);
-            else if (m_max_piece_size == 7)
-                init_moves_with_gamma<7, 12, false>(to_play);
-            else
-                init_moves_with_gamma<22, 44, false>(to_play);
-        }
+            init_moves_with_gamma<P::max_size, P::max_adj_attach,
+                                  P::is_callisto>(to_play);
         else if (m_has_moves[to_play])
-        {
-            if (m_max_piece_size == 5)
-            {
-                if (m_is_callisto)
-                    update_moves<5, 16, true>(to_play);
-                else
-                    update_moves<5, 16, false>(to_play);
-            }
-            else if (m_max_piece_size == 6)
-                update_moves<6, 22, false>(to_play);
-            else if (m_max_piece_size == 7)
-                update_moves<7, 12, false>(to_play);
-            else
-                update_moves<22, 44, false>(to_play);
-        }
+            update_moves<P::max_size, P::max_adj_attach, P::is_callisto>(
+                        to_play);
         if ((m_has_moves[to_play] = ! m_moves[to_play].empty()))
             break;
         if (++m_nu_passes == m_nu_colors)
@@ -538,12 +527,8 @@ inline Float State::get_quality_bonus(Color c, Float result, Float score)
 inline Float State::get_quality_bonus_attach_twocolor()
 {
     LIBBOARDGAME_ASSERT(m_bd.get_nu_players() == 2);
-    int n = m_bd.get_attach_points(Color(0)).size()
-            - m_bd.get_attach_points(Color(1)).size();
-    for (Point p : m_bd.get_attach_points(Color(0)))
-        n -= m_bd.is_forbidden(p, Color(0));
-    for (Point p : m_bd.get_attach_points(Color(1)))
-        n += m_bd.is_forbidden(p, Color(1));
+    int n = static_cast<int>(m_bd.get_nu_free_attach_points(Color(0)))
+            - static_cast<int>(m_bd.get_nu_free_attach_points(Color(1)));
     Float attach = static_cast<Float>(n);
     m_stat_attach.add(attach);
     auto var = m_stat_attach.get_variance();
@@ -558,18 +543,10 @@ inline Float State::get_quality_bonus_attach_multicolor()
 {
     LIBBOARDGAME_ASSERT(m_bd.get_nu_players() == 2);
     LIBBOARDGAME_ASSERT(m_bd.get_nu_colors() == 4);
-    int n = m_bd.get_attach_points(Color(0)).size()
-            + m_bd.get_attach_points(Color(2)).size()
-            - m_bd.get_attach_points(Color(1)).size()
-            - m_bd.get_attach_points(Color(3)).size();
-    for (Point p : m_bd.get_attach_points(Color(0)))
-        n -= m_bd.is_forbidden(p, Color(0));
-    for (Point p : m_bd.get_attach_points(Color(2)))
-        n -= m_bd.is_forbidden(p, Color(2));
-    for (Point p : m_bd.get_attach_points(Color(1)))
-        n += m_bd.is_forbidden(p, Color(1));
-    for (Point p : m_bd.get_attach_points(Color(3)))
-        n += m_bd.is_forbidden(p, Color(3));
+    int n = static_cast<int>(m_bd.get_nu_free_attach_points(Color(0))
+                             + m_bd.get_nu_free_attach_points(Color(2)))
+            - static_cast<int>(m_bd.get_nu_free_attach_points(Color(1))
+                               + m_bd.get_nu_free_attach_points(Color(3)));
     Float attach = static_cast<Float>(n);
     m_stat_attach.add(attach);
     auto var = m_stat_attach.get_variance();
@@ -766,7 +743,7 @@ void State::init_moves_without_gamma(Color c)
                     for (Move mv : get_moves(c, piece, p, adj_status))
                         if (! marker[mv]
                                 && check_forbidden<MAX_SIZE>(
-                                    is_forbidden, mv, moves, nu_moves))
+                                    c, mv, moves, nu_moves))
                             marker.set(mv);
                 }
                 m_moves_added_at[c][p] = true;
@@ -785,26 +762,6 @@ void State::init_moves_without_gamma(Color c)
     }
 }
 
-void State::play_expanded_child(Move mv)
-{
-    if (log_simulations)
-        LIBBOARDGAME_LOG("Playing expanded child");
-    if (! mv.is_null())
-        play_playout(mv);
-    else
-    {
-        ++m_nu_passes;
-        m_bd.set_to_play(m_bd.get_to_play().get_next(m_nu_colors));
-        // Don't try to handle pass moves: a pass move either breaks symmetry
-        // or both players have passed and it's the end of the game and we need
-        // symmetry detection only as a heuristic (playouts and move value
-        // initialization)
-        m_is_symmetry_broken = true;
-        if (log_simulations)
-            LIBBOARDGAME_LOG(m_bd);
-    }
-}
-
 void State::start_search()
 {
     auto& bd = *m_shared_const.board;
@@ -820,6 +777,7 @@ void State::start_search()
     m_max_piece_size = m_bc->get_max_piece_size();
     m_move_info_array = m_bc->get_move_info_array();
     m_move_info_ext_array = m_bc->get_move_info_ext_array();
+    m_move_mask_array = m_bc->get_move_mask_array();
     m_check_terminate_early =
             (bd.get_nu_moves() < 10u * m_nu_colors
              && m_bd.get_nu_players() == 2);
@@ -955,4 +913,36 @@ void State::update_moves(Color c)
 
 //-----------------------------------------------------------------------------
 
+template bool State::gen_children(
+        libboardgame_mcts::Tree<libboardgame_mcts::SearchNode<
+            Move, SearchParamConst>>::NodeExpander& expander,
+        SearchParamConst::Float root_val);
+
+template bool State::gen_children(
+        libboardgame_mcts::Tree<libboardgame_mcts::SearchNode<
+            Move, SearchParamConstST>>::NodeExpander& expander,
+        SearchParamConstST::Float root_val);
+
+template bool State::gen_children(
+        libboardgame_mcts::Tree<libboardgame_mcts::SearchNode<
+            Move, SearchParamConstLong>>::NodeExpander& expander,
+        SearchParamConstLong::Float root_val);
+
+template bool State::gen_playout_move_full<StateParam<5, 16, false>>(
+        PlayerMove<Move>& mv);
+
+template bool State::gen_playout_move_full<StateParam<5, 16, true>>(
+        PlayerMove<Move>& mv);
+
+template bool State::gen_playout_move_full<StateParam<6, 22, false>>(
+        PlayerMove<Move>& mv);
+
+template bool State::gen_playout_move_full<StateParam<7, 12, false>>(
+        PlayerMove<Move>& mv);
+
+template bool State::gen_playout_move_full<StateParam<22, 44, false>>(
+        PlayerMove<Move>& mv);
+
+//-----------------------------------------------------------------------------
+
 } // namespace libpentobi_mcts
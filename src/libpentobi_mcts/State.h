@@ -11,7 +11,6 @@
 #include "PriorKnowledge.h"
 #include "SharedConst.h"
 #include "StateUtil.h"
-#include "libboardgame_mcts/LastGoodReply.h"
 #include "libboardgame_mcts/PlayerMove.h"
 #include "libboardgame_util/Log.h"
 #include "libboardgame_util/RandomGenerator.h"
@@ -19,7 +18,6 @@
 
 namespace libpentobi_mcts {
 
-using libboardgame_mcts::LastGoodReply;
 using libboardgame_mcts::PlayerInt;
 using libboardgame_mcts::PlayerMove;
 using libboardgame_util::RandomGenerator;
@@ -27,6 +25,7 @@ using libboardgame_util::Statistics;
 using libpentobi_base::BoardConst;
 using libpentobi_base::MoveInfo;
 using libpentobi_base::MoveInfoExt;
+using libpentobi_base::MoveMask;
 using libpentobi_base::Piece;
 using libpentobi_base::PieceInfo;
 using libpentobi_base::PieceSet;
@@ -34,6 +33,20 @@ using libpentobi_base::Variant;
 
 //-----------------------------------------------------------------------------
 
+/** Compile-time parameters of State for a board type and piece set.
+    @see State::with_param() */
+template<unsigned MAX_SIZE, unsigned MAX_ADJ_ATTACH, bool IS_CALLISTO>
+struct StateParam
+{
+    static const unsigned max_size = MAX_SIZE;
+
+    static const unsigned max_adj_attach = MAX_ADJ_ATTACH;
+
+    static const bool is_callisto = IS_CALLISTO;
+};
+
+//-----------------------------------------------------------------------------
+
 /** A state of a simulation.
     This class contains modifiable data used in a simulation. In multi-threaded
     search (not yet implemented), each thread uses its own instance of this
@@ -45,17 +58,6 @@ using libpentobi_base::Variant;
 class State
 {
 public:
-    typedef libboardgame_mcts::Node<Move, Float, SearchParamConst::multithread>
-        Node;
-
-    typedef libboardgame_mcts::Tree<Node> Tree;
-
-    typedef libboardgame_mcts::LastGoodReply<Move,
-                                             SearchParamConst::max_players,
-                                             SearchParamConst::lgr_hash_table_size,
-                                             SearchParamConst::multithread>
-        LastGoodReply;
-
     /** Constructor.
         @param initial_variant Game variant to initialize the internal
         board with (may avoid unnecessary BoardConst creation for game variant
@@ -65,35 +67,68 @@ public:
 
     State& operator=(const State&) = delete;
 
+    /** Call a function with the StateParam of the current game variant.
+        The search calls this once per search and passes the parameter to
+        the functions that play or generate moves, such that they are
+        compiled for each board type and piece set without branching on
+        the game variant in every move.
+        @pre start_search() was called */
+    template<class F>
+    void with_param(F f);
+
     /** Play a move in the in-tree phase of the search. */
-    void play_in_tree(Move mv);
+    template<class P>
+    void play_in_tree(Move mv, P param);
 
     /** Handle end of in-tree phase. */
     void finish_in_tree();
 
     /** Play a move right after expanding a node. */
-    void play_expanded_child(Move mv);
+    template<class P>
+    void play_expanded_child(Move mv, P param);
 
     /** Get current player to play. */
     PlayerInt get_player() const;
 
+    /** Get a hash of the current position for detecting transpositions in
+        the search tree. */
+    uint64_t get_hash() const;
+
     void start_search();
 
     void start_simulation(size_t n);
 
-    bool gen_children(Tree::NodeExpander& expander, Float root_val);
+    /** Generate the children of the current node.
+        @param expander The libboardgame_mcts::Tree::NodeExpander of the
+        search. Explicitly instantiated in State.cpp for the node types of
+        SearchParamConst, SearchParamConstST and SearchParamConstLong.
+        @param root_val */
+    template<class E, typename F>
+    bool gen_children(E& expander, F root_val);
 
     void start_playout() { }
 
     /** Generate a playout move.
+        @param lgr The libboardgame_mcts::LastGoodReply of the search
+        (depends on SearchParamConst::multithread)
+        @param last
+        @param second_last
+        @param[out] mv
+        @param param The StateParam from with_param()
         @return @c false if end of game was reached, and no move was
         generated. */
-    bool gen_playout_move(const LastGoodReply& lgr, Move last,
-                          Move second_last, PlayerMove<Move>& mv);
+    template<class L, class P>
+    bool gen_playout_move(const L& lgr, Move last, Move second_last,
+                          PlayerMove<Move>& mv, P param);
 
     void evaluate_playout(array<Float, 6>& result);
 
-    void play_playout(Move mv);
+    /** Evaluate the playout for a search with a different floating type. */
+    template<typename F>
+    void evaluate_playout(array<F, 6>& result);
+
+    template<class P>
+    void play_playout(Move mv, P param);
 
     /** Check if RAVE value for this move should not be updated. */
     bool skip_rave(Move mv) const;
@@ -107,7 +142,16 @@ public:
 private:
     static const bool log_simulations = false;
 
-    /** The cumulative gamma value of the moves in m_moves. */
+    /** The cumulative gamma value of the moves in m_moves.
+        The array is rebuilt in the same pass over the move list that
+        update_moves() needs anyway to check the legality and the local
+        feature of each move, so it costs one store per move and sampling is
+        a binary search. A structure with O(log n) updates (Fenwick tree,
+        alias table) does not pay off because the gamma of a move depends on
+        the local points, which change with every move: finding the moves
+        affected by the changed points through the precomputed move lists
+        visits about 10 times more moves than the whole move list has on
+        average. */
     array<float, MoveList::max_size> m_cumulative_gamma;
 
     Color::IntType m_nu_passes;
@@ -124,6 +168,9 @@ private:
 
     BoardConst::MoveInfoExtArray m_move_info_ext_array;
 
+    /** Caches m_bc->get_move_mask_array() */
+    const MoveMask* m_move_mask_array;
+
     /** Incrementally updated lists of legal moves for both colors.
         Only the move list for the color to play van be used in any given
         position, the other color is not updated immediately after a move. */
@@ -261,8 +308,8 @@ private:
     void init_moves_without_gamma(Color c);
 
     template<unsigned MAX_SIZE>
-    bool check_forbidden(const GridExt<bool>& is_forbidden, Move mv,
-                         MoveList& moves, unsigned& nu_moves);
+    bool check_forbidden(Color c, Move mv, MoveList& moves,
+                         unsigned& nu_moves);
 
     bool check_lgr(Move mv) const;
 
@@ -278,6 +325,7 @@ private:
                     const PlayoutFeatures& playout_features,
                     float& total_gamma);
 
+    template<class P>
     bool gen_playout_move_full(PlayerMove<Move>& mv);
 
     template<unsigned MAX_SIZE, unsigned MAX_ADJ_ATTACH, bool IS_CALLISTO>
@@ -343,6 +391,14 @@ inline void State::evaluate_playout(array<Float, 6>& result)
         evaluate_multiplayer(result);
 }
 
+template<typename F>
+inline void State::evaluate_playout(array<F, 6>& result)
+{
+    array<Float, 6> float_result;
+    evaluate_playout(float_result);
+    copy(float_result.begin(), float_result.end(), result.begin());
+}
+
 inline void State::finish_in_tree()
 {
     if (log_simulations)
@@ -351,9 +407,11 @@ inline void State::finish_in_tree()
         m_is_symmetry_broken = check_symmetry_broken(m_bd);
 }
 
-inline bool State::gen_playout_move(const LastGoodReply& lgr, Move last,
-                                    Move second_last, PlayerMove<Move>& mv)
+template<class L, class P>
+inline bool State::gen_playout_move(const L& lgr, Move last, Move second_last,
+                                    PlayerMove<Move>& mv, P param)
 {
+    LIBBOARDGAME_UNUSED(param);
     if (m_nu_passes == m_nu_colors)
         return false;
     if (! m_is_symmetry_broken
@@ -381,7 +439,7 @@ inline bool State::gen_playout_move(const LastGoodReply& lgr, Move last,
         mv = PlayerMove<Move>(player, lgr1);
         return true;
     }
-    return gen_playout_move_full(mv);
+    return gen_playout_move_full<P>(mv);
 }
 
 template<unsigned MAX_SIZE>
@@ -406,6 +464,13 @@ inline PrecompMoves::Range State::get_moves(Color c, Piece piece, Point p,
     return m_shared_const.precomp_moves[c].get_moves(piece, p, adj_status);
 }
 
+inline uint64_t State::get_hash() const
+{
+    // Include the number of consecutive passes, which determines if the game
+    // is over. This also ensures that the tree cannot contain cycles.
+    return m_bd.get_hash() ^ (m_nu_passes * 0x9e3779b97f4a7c15ULL);
+}
+
 inline PlayerInt State::get_player() const
 {
     unsigned player = m_bd.get_to_play().to_int();
@@ -420,33 +485,38 @@ inline bool State::has_moves(Color c, Piece piece, Point p,
     return m_shared_const.precomp_moves[c].has_moves(piece, p, adj_status);
 }
 
-inline void State::play_in_tree(Move mv)
+template<class P>
+void State::play_expanded_child(Move mv, P param)
 {
+    if (log_simulations)
+        LIBBOARDGAME_LOG("Playing expanded child");
+    if (! mv.is_null())
+        play_playout(mv, param);
+    else
+    {
+        ++m_nu_passes;
+        m_bd.set_to_play(m_bd.get_to_play().get_next(m_nu_colors));
+        // Don't try to handle pass moves: a pass move either breaks symmetry
+        // or both players have passed and it's the end of the game and we need
+        // symmetry detection only as a heuristic (playouts and move value
+        // initialization)
+        m_is_symmetry_broken = true;
+        if (log_simulations)
+            LIBBOARDGAME_LOG(m_bd);
+    }
+}
+
+template<class P>
+inline void State::play_in_tree(Move mv, P param)
+{
+    LIBBOARDGAME_UNUSED(param);
     Color to_play = m_bd.get_to_play();
     if (! mv.is_null())
     {
         LIBBOARDGAME_ASSERT(m_bd.is_legal(to_play, mv));
         m_nu_passes = 0;
-        if (m_max_piece_size == 5)
-        {
-            m_bd.play<5, 16>(to_play, mv);
-            update_playout_features<5, 16>(to_play, mv);
-        }
-        else if (m_max_piece_size == 6)
-        {
-            m_bd.play<6, 22>(to_play, mv);
-            update_playout_features<6, 22>(to_play, mv);
-        }
-        else if (m_max_piece_size == 7)
-        {
-            m_bd.play<7, 12>(to_play, mv);
-            update_playout_features<7, 12>(to_play, mv);
-        }
-        else
-        {
-            m_bd.play<22, 44>(to_play, mv);
-            update_playout_features<22, 44>(to_play, mv);
-        }
+        m_bd.play<P::max_size, P::max_adj_attach>(to_play, mv);
+        update_playout_features<P::max_size, P::max_adj_attach>(to_play, mv);
     }
     else
     {
@@ -457,38 +527,19 @@ inline void State::play_in_tree(Move mv)
         LIBBOARDGAME_LOG(m_bd);
 }
 
-inline void State::play_playout(Move mv)
+template<class P>
+inline void State::play_playout(Move mv, P param)
 {
+    LIBBOARDGAME_UNUSED(param);
     auto to_play = m_bd.get_to_play();
     LIBBOARDGAME_ASSERT(m_bd.is_legal(to_play, mv));
-    if (m_max_piece_size == 5)
-    {
-        m_bd.play<5, 16>(to_play, mv);
-        update_playout_features<5, 16>(to_play, mv);
-        if (! m_is_symmetry_broken)
-            update_symmetry_broken<5>(mv);
-    }
-    else if (m_max_piece_size == 6)
-    {
-        m_bd.play<6, 22>(to_play, mv);
-        update_playout_features<6, 22>(to_play, mv);
-        if (! m_is_symmetry_broken)
-            update_symmetry_broken<6>(mv);
-    }
-    else if (m_max_piece_size == 7)
-    {
-        m_bd.play<7, 12>(to_play, mv);
-        update_playout_features<7, 12>(to_play, mv);
-        // No game variant with piece size 7 uses m_is_symmetry_broken
+    m_bd.play<P::max_size, P::max_adj_attach>(to_play, mv);
+    update_playout_features<P::max_size, P::max_adj_attach>(to_play, mv);
+    if (P::max_size == 7)
+        // No game variant with piece size 7 (Nexos) uses m_is_symmetry_broken
         LIBBOARDGAME_ASSERT(m_is_symmetry_broken);
-    }
-    else
-    {
-        m_bd.play<22, 44>(to_play, mv);
-        update_playout_features<22, 44>(to_play, mv);
-        if (! m_is_symmetry_broken)
-            update_symmetry_broken<22>(mv);
-    }
+    else if (! m_is_symmetry_broken)
+        update_symmetry_broken<P::max_size>(mv);
     ++m_nu_new_moves[to_play];
     m_last_move[to_play] = mv;
     m_nu_passes = 0;
@@ -557,6 +608,24 @@ void State::update_symmetry_broken(Move mv)
     }
 }
 
+template<class F>
+inline void State::with_param(F f)
+{
+    if (m_max_piece_size == 5)
+    {
+        if (m_is_callisto)
+            f(StateParam<5, 16, true>());
+        else
+            f(StateParam<5, 16, false>());
+    }
+    else if (m_max_piece_size == 6)
+        f(StateParam<6, 22, false>());
+    else if (m_max_piece_size == 7)
+        f(StateParam<7, 12, false>());
+    else
+        f(StateParam<22, 44, false>());
+}
+
 //-----------------------------------------------------------------------------
 
 } // namespace libpentobi_mcts
@@ -19,8 +19,6 @@
 namespace libpentobi_mcts {
 namespace util {
 
-using libboardgame_mcts::Node;
-using libboardgame_mcts::Tree;
 using libboardgame_sgf::Writer;
 using libpentobi_base::boardutil::write_setup;
 using libpentobi_base::sgf_util::get_color_id;
@@ -29,9 +27,10 @@ using libpentobi_base::sgf_util::get_color_id;
 
 namespace {
 
+template<class S>
 void dump_tree_recurse(Writer& writer, Variant variant,
-                       const Search::Tree& tree, const Search::Node& node,
-                       Color to_play)
+                       const typename S::Tree& tree,
+                       const typename S::Node& node, Color to_play)
 {
     ostringstream comment;
     comment << "Visits: " << node.get_visit_count()
@@ -40,11 +39,11 @@ void dump_tree_recurse(Writer& writer, Variant variant,
     writer.write_property("C", comment.str());
     writer.end_node();
     Color next_to_play = to_play.get_next(get_nu_colors(variant));
-    vector<const Search::Node*> children;
+    vector<const typename S::Node*> children;
     children.reserve(node.get_nu_children());
     for (auto& i : tree.get_children(node))
         children.push_back(&i);
-    sort(children.begin(), children.end(), compare_node);
+    sort(children.begin(), children.end(), compare_node<typename S::Node>);
     for (const auto i : children)
     {
         writer.begin_tree();
@@ -57,7 +56,7 @@ void dump_tree_recurse(Writer& writer, Variant variant,
             if (! mv.is_null())
                 writer.write_property(id, board_const.to_string(mv, false));
         }
-        dump_tree_recurse(writer, variant, tree, *i, next_to_play);
+        dump_tree_recurse<S>(writer, variant, tree, *i, next_to_play);
         writer.end_tree();
     }
 }
@@ -66,16 +65,8 @@ void dump_tree_recurse(Writer& writer, Variant variant,
 
 //-----------------------------------------------------------------------------
 
-bool compare_node(const Search::Node* n1, const Search::Node* n2)
-{
-    Float count1 = n1->get_visit_count();
-    Float count2 = n2->get_visit_count();
-    if (count1 != count2)
-        return count1 > count2;
-    return n1->get_value() > n2->get_value();
-}
-
-void dump_tree(ostream& out, const Search& search)
+template<class S>
+void dump_tree(ostream& out, const S& search)
 {
     Variant variant;
     Setup setup;
@@ -87,10 +78,17 @@ void dump_tree(ostream& out, const Search& search)
     write_setup(writer, variant, setup);
     writer.write_property("PL", get_color_id(variant, setup.to_play));
     auto& tree = search.get_tree();
-    dump_tree_recurse(writer, variant, tree, tree.get_root(), setup.to_play);
+    dump_tree_recurse<S>(writer, variant, tree, tree.get_root(),
+                         setup.to_play);
     writer.end_tree();
 }
 
+template void dump_tree(ostream& out, const Search& search);
+
+template void dump_tree(ostream& out, const SearchST& search);
+
+template void dump_tree(ostream& out, const SearchLong& search);
+
 unsigned get_nu_threads()
 {
     unsigned nu_threads = thread::hardware_concurrency();
@@ -17,16 +17,30 @@ using namespace std;
 //-----------------------------------------------------------------------------
 
 /** Comparison function for sorting children of a node by count.
-    Prefers nodes with higher counts. Uses the node value as a tie breaker. */
-bool compare_node(const Search::Node* n1, const Search::Node* n2);
+    Prefers nodes with higher counts. Uses the node value as a tie breaker.
+    @tparam N The node type of Search, SearchST or SearchLong */
+template<class N>
+bool compare_node(const N* n1, const N* n2);
 
-/** Dump the search tree in SGF format. */
-void dump_tree(ostream& out, const Search& search);
+/** Dump the search tree in SGF format.
+    Explicitly instantiated for Search, SearchST and SearchLong. */
+template<class S>
+void dump_tree(ostream& out, const S& search);
 
 /** Suggest how many threads to use in the search depending on the current
     system. */
 unsigned get_nu_threads();
 
+template<class N>
+bool compare_node(const N* n1, const N* n2)
+{
+    auto count1 = n1->get_visit_count();
+    auto count2 = n2->get_visit_count();
+    if (count1 != count2)
+        return count1 > count2;
+    return n1->get_value() > n2->get_value();
+}
+
 //-----------------------------------------------------------------------------
 
 } // namespace util
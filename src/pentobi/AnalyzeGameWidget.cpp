@@ -184,12 +184,12 @@ QSize AnalyzeGameWidget::sizeHint() const
     return QSize(geo.width() / 2, geo.height() / 3);
 }
 
-void AnalyzeGameWidget::start(const Game& game, Search& search,
+void AnalyzeGameWidget::start(const Game& game, Player& player,
                               size_t nuSimulations)
 {
     m_isInitialized = true;
     m_game = &game;
-    m_search = &search;
+    m_player = &player;
     m_nuSimulations = nuSimulations;
     initSize();
     if (! m_progressDialog)
@@ -223,7 +223,7 @@ void AnalyzeGameWidget::threadFunction()
                                       Qt::BlockingQueuedConnection,
                                       Q_ARG(int, progress));
         };
-    m_analyzeGame.run(*m_game, *m_search, m_nuSimulations, progressCallback);
+    m_analyzeGame.run(*m_game, *m_player, m_nuSimulations, progressCallback);
     QMetaObject::invokeMethod(m_progressDialog, "hide", Qt::QueuedConnection);
     m_isRunning = false;
     emit finished();
@@ -25,7 +25,7 @@ using libpentobi_base::ColorMove;
 using libpentobi_base::Game;
 using libpentobi_base::Variant;
 using libpentobi_mcts::AnalyzeGame;
-using libpentobi_mcts::Search;
+using libpentobi_mcts::Player;
 
 //-----------------------------------------------------------------------------
 
@@ -46,12 +46,12 @@ public:
     /** Start an analysis.
         This function will return after the analysis has started but the
         window will be protected by a modal cancelable progress dialog.
-        Don't modify the game or use the search from a different thread until
+        Don't modify the game or use the player from a different thread until
         the signal finished() was emitted. This will walk through every game
-        position in the main variation and use the search to evaluate
-        positions. During the analysis, the parent window is protected with a
-        modal progress dialog. */
-    void start(const Game& game, Search& search, size_t nuSimulations);
+        position in the main variation and use the search of the player to
+        evaluate positions. During the analysis, the parent window is
+        protected with a modal progress dialog. */
+    void start(const Game& game, Player& player, size_t nuSimulations);
 
     /** Mark the current position.
         Will clear the current position if the target node is not in the
@@ -84,7 +84,7 @@ private:
 
     const Game* m_game;
 
-    Search* m_search;
+    Player* m_player;
 
     size_t m_nuSimulations;
 
@@ -199,9 +199,10 @@ MainWindow::MainWindow(QWidget* parent, Variant variant,
     initGame();
     m_player.reset(new Player(variant, maxLevel,
                               booksDir.toLocal8Bit().constData(), nuThreads));
-    m_player->get_search().set_callback(bind(&MainWindow::searchCallback,
-                                             this, placeholders::_1,
-                                             placeholders::_2));
+    m_player->with_search([this](auto& search) {
+        search.set_callback(bind(&MainWindow::searchCallback, this,
+                                 placeholders::_1, placeholders::_2));
+    });
     m_player->set_use_book(! noBook);
     createToolBar();
     connect(&m_genMoveWatcher, &QFutureWatcher<GenMoveResult>::finished,
@@ -358,7 +359,7 @@ void MainWindow::analyzeGame()
         nuSimulations = 96000;
     }
     m_analyzeGameWindow->analyzeGameWidget->start(
-                m_game, m_player->get_search(), nuSimulations);
+                m_game, *m_player, nuSimulations);
 }
 
 void MainWindow::analyzeGameFinished()
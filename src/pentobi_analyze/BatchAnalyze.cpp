@@ -0,0 +1,351 @@
+//-----------------------------------------------------------------------------
+/** @file pentobi_analyze/BatchAnalyze.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "BatchAnalyze.h"
+
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include "libboardgame_sgf/SgfIndex.h"
+#include "libboardgame_sgf/TreeReader.h"
+#include "libboardgame_util/Log.h"
+#include "libboardgame_util/StringUtil.h"
+#include "libpentobi_base/PentobiSgfUtil.h"
+#include "libpentobi_base/PentobiTreeWriter.h"
+#include "libpentobi_mcts/Player.h"
+
+using libboardgame_sgf::Reader;
+using libboardgame_sgf::SgfIndex;
+using libboardgame_sgf::TreeReader;
+using libboardgame_util::from_string;
+using libpentobi_base::BoardConst;
+using libpentobi_base::Game;
+using libpentobi_base::PentobiTreeWriter;
+using libpentobi_base::Variant;
+using libpentobi_base::sgf_util::get_color_id;
+using libpentobi_mcts::Player;
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+const string csv_header = "File,Game,Move,Color,Points,Value\n";
+
+/** Quote a CSV field if needed. */
+string get_csv_field(const string& s)
+{
+    if (s.find_first_of(",\"\n") == string::npos)
+        return s;
+    string result = "\"";
+    for (char c : s)
+    {
+        if (c == '"')
+            result += '"';
+        result += c;
+    }
+    result += '"';
+    return result;
+}
+
+/** Remove the content of a file after a given size. */
+void truncate_file(const string& file, uint64_t size)
+{
+    string content(static_cast<size_t>(size), '\0');
+    {
+        ifstream in(file, ios::binary);
+        if (! in.read(&content[0], static_cast<streamsize>(size)))
+            throw runtime_error("could not read " + file);
+    }
+    ofstream out(file, ios::binary | ios::trunc);
+    if (! out.write(content.data(), static_cast<streamsize>(size)))
+        throw runtime_error("could not write " + file);
+}
+
+void write_sgf(ostream& out, Game& game, const AnalyzeGame& analyze)
+{
+    auto& tree = game.get_tree();
+    unsigned i = 0;
+    for (auto node = &tree.get_root(); node != nullptr;
+         node = node->get_first_child_or_null())
+    {
+        if (i == analyze.get_nu_moves())
+            break;
+        if (tree.get_move(*node).is_null())
+            continue;
+        game.goto_node(*node);
+        auto comment = game.get_comment();
+        if (! comment.empty() && comment.back() != '\n')
+            comment += '\n';
+        ostringstream value;
+        value << fixed << setprecision(3) << analyze.get_value(i);
+        comment += "Value: " + value.str();
+        game.set_comment(comment);
+        ++i;
+    }
+    PentobiTreeWriter writer(out, tree);
+    writer.set_indent(-1);
+    writer.write();
+    out << '\n';
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+BatchAnalyze::BatchAnalyze(const string& output_file, Format format,
+                           size_t nu_simulations)
+    : m_output_file(output_file),
+      m_format(format),
+      m_nu_simulations(nu_simulations),
+      m_output_size(format == Format::csv ? csv_header.size() : 0)
+{
+    ifstream in(get_checkpoint_file());
+    string line;
+    while (getline(in, line))
+    {
+        // The last line was not completely written if the run was
+        // interrupted while writing it
+        if (in.eof())
+            break;
+        auto pos1 = line.find('\t');
+        auto pos2 = (pos1 == string::npos ?
+                         string::npos : line.find('\t', pos1 + 1));
+        size_t game_index;
+        uint64_t output_size;
+        if (pos2 == string::npos
+                || ! from_string(line.substr(0, pos1), game_index)
+                || ! from_string(line.substr(pos1 + 1, pos2 - pos1 - 1),
+                                 output_size))
+            throw runtime_error("invalid checkpoint file");
+        m_finished.insert(make_pair(line.substr(pos2 + 1), game_index));
+        m_output_size = output_size;
+        m_checkpoint_size += line.size() + 1;
+    }
+}
+
+BatchAnalyze::~BatchAnalyze() = default;
+
+void BatchAnalyze::add_file(const string& file)
+{
+    auto collection = make_unique<SgfCollection>();
+    try
+    {
+        collection->open(file);
+    }
+    catch (const Reader::ReadError& e)
+    {
+        throw runtime_error(e.what());
+    }
+    auto file_index = m_files.size();
+    for (size_t i = 0; i < collection->get_nu_games(); ++i)
+        if (m_finished.count(make_pair(file, i)) == 0)
+            m_jobs.push_back({ file_index, i });
+    m_files.push_back(file);
+    m_collections.push_back(move(collection));
+}
+
+string BatchAnalyze::get_checkpoint_file() const
+{
+    return m_output_file + ".checkpoint";
+}
+
+void BatchAnalyze::init_output()
+{
+    auto checkpoint_file = get_checkpoint_file();
+    if (! ifstream(checkpoint_file).fail())
+    {
+        LIBBOARDGAME_LOG("Continuing analysis, ", m_finished.size(),
+                         " games finished");
+        uint64_t size;
+        {
+            ifstream in(m_output_file, ios::binary | ios::ate);
+            if (! in)
+                throw runtime_error("could not read " + m_output_file);
+            size = static_cast<uint64_t>(in.tellg());
+        }
+        if (size < m_output_size)
+            throw runtime_error(m_output_file
+                                + " does not match the checkpoint file");
+        if (size > m_output_size)
+        {
+            LIBBOARDGAME_LOG("Removing unfinished results from ",
+                             m_output_file);
+            truncate_file(m_output_file, m_output_size);
+            if (m_format == Format::sgf)
+                truncate_index();
+        }
+        {
+            ifstream in(checkpoint_file, ios::binary | ios::ate);
+            if (static_cast<uint64_t>(in.tellg()) > m_checkpoint_size)
+                truncate_file(checkpoint_file, m_checkpoint_size);
+        }
+        m_out.open(m_output_file, ios::binary | ios::app);
+    }
+    else
+    {
+        remove(SgfIndex::get_index_file(m_output_file).c_str());
+        m_out.open(m_output_file, ios::binary);
+        if (m_format == Format::csv)
+            m_out << csv_header;
+        m_output_size = static_cast<uint64_t>(m_out.tellp());
+    }
+    if (! m_out)
+        throw runtime_error("could not write " + m_output_file);
+    m_checkpoint.open(checkpoint_file, ios::binary | ios::app);
+    if (! m_checkpoint)
+        throw runtime_error("could not write " + checkpoint_file);
+}
+
+/** Remove the index entries of games after the end of the output file. */
+void BatchAnalyze::truncate_index()
+{
+    auto index_file = SgfIndex::get_index_file(m_output_file);
+    SgfIndex index;
+    try
+    {
+        ifstream in(index_file);
+        if (in)
+            index.read(in);
+    }
+    catch (const runtime_error&)
+    {
+        // The index is created again when the output file is opened
+        index.clear();
+    }
+    vector<SgfIndex::Entry> entries;
+    for (size_t i = 0; i < index.size(); ++i)
+        if (index[i].offset + index[i].size <= m_output_size)
+            entries.push_back(index[i]);
+    remove(index_file.c_str());
+    if (! entries.empty() && ! SgfIndex::append(m_output_file, entries))
+        LIBBOARDGAME_LOG("WARNING: Could not write index of ", m_output_file);
+}
+
+void BatchAnalyze::run(unsigned nu_threads, size_t memory)
+{
+    init_output();
+    m_next_job = 0;
+    m_nu_finished_jobs = 0;
+    LIBBOARDGAME_LOG("Analyzing ", m_jobs.size(), " games");
+    nu_threads = static_cast<unsigned>(min(size_t(nu_threads), m_jobs.size()));
+    vector<thread> threads;
+    threads.reserve(nu_threads);
+    exception_ptr error;
+    for (unsigned i = 0; i < nu_threads; ++i)
+        threads.push_back(thread([&]()
+        {
+            try
+            {
+                run_worker(memory);
+            }
+            catch (...)
+            {
+                lock_guard<mutex> lock(m_mutex);
+                if (! error)
+                    error = current_exception();
+                // Let the other threads stop after their current game
+                m_next_job = m_jobs.size();
+            }
+        }));
+    for (auto& t : threads)
+        t.join();
+    if (error)
+        rethrow_exception(error);
+}
+
+void BatchAnalyze::run_worker(size_t memory)
+{
+    // The initial variant is irrelevant, the search adapts to the variant
+    // of each game
+    Player player(Variant::duo, Player::max_supported_level, "", 1, memory);
+    AnalyzeGame analyze;
+    TreeReader reader;
+    reader.set_read_only_main_variation(true);
+    ostringstream result;
+    while (true)
+    {
+        auto i = m_next_job++;
+        if (i >= m_jobs.size())
+            break;
+        auto& job = m_jobs[i];
+        result.str("");
+        try
+        {
+            m_collections[job.file_index]->read(reader, job.game_index);
+            auto root = reader.get_tree_transfer_ownership();
+            Game game(Variant::duo);
+            game.init(root);
+            analyze.run(game, player, m_nu_simulations,
+                        [](unsigned, unsigned) { });
+            if (m_format == Format::csv)
+                write_csv(result, job, analyze);
+            else
+                write_sgf(result, game, analyze);
+        }
+        catch (const runtime_error& e)
+        {
+            LIBBOARDGAME_LOG("WARNING: Skipping game ", job.game_index,
+                             " of ", m_files[job.file_index], ": ", e.what());
+        }
+        write_result(job, result.str());
+    }
+}
+
+void BatchAnalyze::write_csv(ostream& out, const Job& job,
+                             const AnalyzeGame& analyze)
+{
+    auto variant = analyze.get_variant();
+    auto& bc = BoardConst::get(variant);
+    auto file = get_csv_field(m_files[job.file_index]);
+    out << fixed << setprecision(3);
+    for (unsigned i = 0; i < analyze.get_nu_moves(); ++i)
+    {
+        auto mv = analyze.get_move(i);
+        out << file << ',' << job.game_index << ',' << (i + 1) << ','
+            << get_color_id(variant, mv.color) << ','
+            << get_csv_field(bc.to_string(mv.move)) << ','
+            << analyze.get_value(i) << '\n';
+    }
+}
+
+void BatchAnalyze::write_result(const Job& job, const string& result)
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (! result.empty())
+    {
+        m_out << result << flush;
+        if (! m_out)
+            throw runtime_error("could not write " + m_output_file);
+        if (m_format == Format::sgf)
+        {
+            SgfIndex index;
+            index.update(result.data(), result.size());
+            auto entry = index[0];
+            entry.offset += m_output_size;
+            if (! SgfIndex::append(m_output_file, { entry }))
+                LIBBOARDGAME_LOG("WARNING: Could not write index of ",
+                                 m_output_file);
+        }
+        m_output_size += result.size();
+    }
+    // The checkpoint is written after the result, the next run removes
+    // results that are not recorded in the checkpoint file
+    m_checkpoint << job.game_index << '\t' << m_output_size << '\t'
+                 << m_files[job.file_index] << '\n' << flush;
+    if (! m_checkpoint)
+        throw runtime_error("could not write " + get_checkpoint_file());
+    ++m_nu_finished_jobs;
+    LIBBOARDGAME_LOG("Finished game ", job.game_index, " of ",
+                     m_files[job.file_index], " (", m_nu_finished_jobs, '/',
+                     m_jobs.size(), ')');
+}
+
+//-----------------------------------------------------------------------------
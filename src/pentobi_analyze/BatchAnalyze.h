@@ -0,0 +1,126 @@
+//-----------------------------------------------------------------------------
+/** @file pentobi_analyze/BatchAnalyze.h
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifndef PENTOBI_ANALYZE_BATCH_ANALYZE_H
+#define PENTOBI_ANALYZE_BATCH_ANALYZE_H
+
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include "libboardgame_sgf/SgfCollection.h"
+#include "libpentobi_mcts/AnalyzeGame.h"
+
+using namespace std;
+using libboardgame_sgf::SgfCollection;
+using libpentobi_mcts::AnalyzeGame;
+
+//-----------------------------------------------------------------------------
+
+/** Analyzes the games of a number of SGF files in parallel.
+    Each worker thread uses its own player with a single-threaded search and
+    runs AnalyzeGame on one game at a time. The board constants are shared
+    between the threads (see libpentobi_base::BoardConst::get()).
+
+    The results are appended to the output file when the analysis of a game
+    is finished. The output file is either a CSV file with one line per
+    analyzed move or an SGF file with the analyzed games, in which the value
+    of each move is appended to the comment of the move node. An SGF output
+    file also gets an index file (see libboardgame_sgf::SgfIndex).
+
+    The finished games are recorded in a checkpoint file (the output file with
+    appended ".checkpoint") after their result was written to the output
+    file. Each line of the checkpoint file contains the game index, the size
+    of the output file after writing the result and the file name of the
+    game. If the checkpoint file exists, the analysis continues an
+    interrupted run and skips the games already in the output file. Results
+    that were written to the output file but not recorded in the checkpoint
+    file are removed, such that games that were being analyzed when the run
+    was interrupted are analyzed again and appear only once in the output
+    file. */
+class BatchAnalyze
+{
+public:
+    enum class Format
+    {
+        csv,
+
+        sgf
+    };
+
+    BatchAnalyze(const string& output_file, Format format,
+                 size_t nu_simulations);
+
+    ~BatchAnalyze();
+
+    /** Add the games of an SGF file.
+        @throws runtime_error If the file cannot be read. */
+    void add_file(const string& file);
+
+    /** Run the analysis.
+        @param nu_threads The number of worker threads.
+        @param memory The memory for the search tree of each thread. */
+    void run(unsigned nu_threads, size_t memory);
+
+private:
+    struct Job
+    {
+        size_t file_index;
+
+        size_t game_index;
+    };
+
+    string m_output_file;
+
+    Format m_format;
+
+    size_t m_nu_simulations;
+
+    vector<string> m_files;
+
+    vector<unique_ptr<SgfCollection>> m_collections;
+
+    /** Games finished in earlier runs, identified by file and game index. */
+    set<pair<string, size_t>> m_finished;
+
+    vector<Job> m_jobs;
+
+    atomic<size_t> m_next_job;
+
+    /** Protects the output and checkpoint files. */
+    mutex m_mutex;
+
+    ofstream m_out;
+
+    ofstream m_checkpoint;
+
+    /** Current size of the output file.
+        Before init_output(), the size of the output file recorded in the
+        checkpoint file. */
+    uint64_t m_output_size;
+
+    /** Size of the completely written lines of the checkpoint file. */
+    uint64_t m_checkpoint_size = 0;
+
+    size_t m_nu_finished_jobs;
+
+    string get_checkpoint_file() const;
+
+    void init_output();
+
+    void run_worker(size_t memory);
+
+    void truncate_index();
+
+    void write_csv(ostream& out, const Job& job, const AnalyzeGame& analyze);
+
+    void write_result(const Job& job, const string& result);
+};
+
+//-----------------------------------------------------------------------------
+
+#endif // PENTOBI_ANALYZE_BATCH_ANALYZE_H
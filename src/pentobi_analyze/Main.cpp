@@ -0,0 +1,132 @@
+//-----------------------------------------------------------------------------
+/** @file pentobi_analyze/Main.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "BatchAnalyze.h"
+#include "libboardgame_sys/Directory.h"
+#include "libboardgame_sys/Memory.h"
+#include "libboardgame_util/Log.h"
+#include "libboardgame_util/Options.h"
+#include "libpentobi_mcts/Util.h"
+
+using namespace std;
+using libboardgame_sys::is_directory;
+using libboardgame_sys::list_directory;
+using libboardgame_util::Options;
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+/** Add a file or the SGF files in a directory. */
+void add_path(BatchAnalyze& analyze, const string& path)
+{
+    if (! is_directory(path))
+    {
+        analyze.add_file(path);
+        return;
+    }
+    vector<string> names;
+    if (! list_directory(path, names))
+        throw runtime_error("could not read directory " + path);
+    const string extension = ".blksgf";
+    for (auto& name : names)
+        if (name.size() > extension.size()
+                && name.compare(name.size() - extension.size(),
+                                extension.size(), extension) == 0)
+            analyze.add_file(path + "/" + name);
+}
+
+/** Get the default memory for the search tree of each thread. */
+size_t get_memory(unsigned nu_threads)
+{
+    size_t available = libboardgame_sys::get_memory();
+    if (available == 0)
+        available = 512000000;
+    // Don't use more than a third of the memory, and not more than a single
+    // player would use by default
+    return min(available / 3 / nu_threads, size_t(2000000000));
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        vector<string> specs = {
+            "format:",
+            "help|h",
+            "memory:",
+            "output|o:",
+            "quiet|q",
+            "simulations|s:",
+            "threads:"
+        };
+        Options opt(argc, argv, specs);
+        if (opt.contains("help"))
+        {
+            cout <<
+                "Usage: pentobi-analyze [options] files/directories\n"
+                "--format          output format (csv, sgf)\n"
+                "--help,-h         print help message and exit\n"
+                "--memory          search tree memory per thread in MB\n"
+                "--output,-o       output file\n"
+                "--quiet,-q        do not print logging messages\n"
+                "--simulations,-s  number of simulations per position\n"
+                "--threads         number of games analyzed in parallel\n";
+            return 0;
+        }
+        auto format_string = opt.get("format", "csv");
+        BatchAnalyze::Format format;
+        if (format_string == "csv")
+            format = BatchAnalyze::Format::csv;
+        else if (format_string == "sgf")
+            format = BatchAnalyze::Format::sgf;
+        else
+            throw runtime_error("invalid format " + format_string);
+        auto output = opt.get("output", format == BatchAnalyze::Format::csv ?
+                                  "analysis.csv" : "analysis.blksgf");
+        auto nu_simulations = opt.get<size_t>("simulations", 24000);
+        if (nu_simulations == 0)
+            throw runtime_error("Number of simulations must be greater zero.");
+        auto threads = opt.get<unsigned>(
+                    "threads", libpentobi_mcts::util::get_nu_threads());
+        if (threads == 0)
+            throw runtime_error("Number of threads must be greater zero.");
+        size_t memory;
+        if (opt.contains("memory"))
+        {
+            memory = opt.get<size_t>("memory") * 1000000;
+            if (memory == 0)
+                throw runtime_error("Memory must be greater zero.");
+        }
+        else
+            memory = get_memory(threads);
+        if (opt.contains("quiet"))
+            libboardgame_util::disable_logging();
+        auto& args = opt.get_args();
+        if (args.empty())
+            throw runtime_error("Need files or directories to analyze");
+        BatchAnalyze analyze(output, format, nu_simulations);
+        for (auto& path : args)
+            add_path(analyze, path);
+        analyze.run(threads, memory);
+    }
+    catch (const exception& e)
+    {
+        LIBBOARDGAME_LOG("Error: ", e.what());
+        return 1;
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,51 @@
+//-----------------------------------------------------------------------------
+/** @file pentobi_compile_book/Main.cpp
+    Converts an opening book in SGF format into a compiled book file.
+    Used for creating the compiled books from the books in src/books at
+    build time (see libpentobi_base::Book).
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <fstream>
+#include <iostream>
+#include "libpentobi_base/Book.h"
+
+using namespace std;
+using libpentobi_base::Book;
+using libpentobi_base::Variant;
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        if (argc != 3)
+            throw runtime_error(
+                    "Usage: pentobi-compile-book in.blksgf out.blkbook");
+        ifstream in(argv[1]);
+        if (! in)
+            throw runtime_error(string("Error opening ") + argv[1]);
+        // The variant is replaced by the variant of the book file
+        Book book(Variant::duo);
+        book.load(in);
+        ofstream out(argv[2], ios::binary);
+        book.write_compiled(out);
+        out.close();
+        if (! out)
+            throw runtime_error(string("Error writing ") + argv[2]);
+        return 0;
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << '\n';
+        return 1;
+    }
+}
+
+//-----------------------------------------------------------------------------
@@ -10,58 +10,135 @@
 
 #include "Engine.h"
 
+#include <cstdio>
 #include <fstream>
+#include "libboardgame_sgf/SgfIndex.h"
 #include "libboardgame_sgf/Writer.h"
+#include "libboardgame_util/Abort.h"
+#include "libboardgame_util/WallTimeSource.h"
+#include "libpentobi_base/BoardUtil.h"
 #include "libpentobi_mcts/Util.h"
 
 namespace pentobi_gtp {
 
 using libboardgame_gtp::Failure;
+using libboardgame_sgf::SgfIndex;
 using libboardgame_sgf::Writer;
-using libpentobi_base::Board;
+using libboardgame_util::clear_abort;
+using libboardgame_util::set_abort;
+using libboardgame_util::WallTimeSource;
+using libpentobi_base::boardutil::get_result_property;
 using libpentobi_base::sgf_util::get_color_id;
+using libpentobi_base::Move;
 using libpentobi_mcts::Float;
 
 //-----------------------------------------------------------------------------
 
 Engine::Engine(Variant variant, unsigned level, bool use_book,
-               const string& books_dir, unsigned nu_threads)
+               const string& books_dir, unsigned nu_threads, size_t memory,
+               bool long_analysis)
     : libpentobi_base::Engine(variant)
 {
-    create_player(variant, level, books_dir, nu_threads);
+    create_player(variant, level, books_dir, nu_threads, memory,
+                  long_analysis);
     get_mcts_player().set_use_book(use_book);
+    add("benchmark", &Engine::cmd_benchmark);
+    add("g", &Engine::cmd_g);
+    add("genmove", &Engine::cmd_genmove);
     add("get_value", &Engine::cmd_get_value);
     add("name", &Engine::cmd_name);
+    add("p", &Engine::cmd_p);
     add("param", &Engine::cmd_param);
+    add("play", &Engine::cmd_play);
     add("move_values", &Engine::cmd_move_values);
     add("save_tree", &Engine::cmd_save_tree);
     add("selfplay", &Engine::cmd_selfplay);
     add("version", &Engine::cmd_version);
 }
 
-Engine::~Engine() = default;
+Engine::~Engine()
+{
+    stop_ponder();
+}
+
+template<class S>
+void Engine::benchmark(S& search, unsigned nu_searches, size_t nu_simulations,
+                       Response& response)
+{
+    auto& bd = get_board();
+    auto c = bd.get_effective_to_play();
+    if (! bd.has_moves(c))
+        throw Failure("no legal moves");
+    auto reuse_subtree = search.get_reuse_subtree();
+    auto reuse_tree = search.get_reuse_tree();
+    search.set_reuse_subtree(false);
+    search.set_reuse_tree(false);
+    WallTimeSource time_source;
+    double time = 0;
+    size_t simulations = 0;
+    Move mv;
+    for (unsigned i = 0; i < nu_searches; ++i)
+    {
+        auto start = time_source();
+        search.search(mv, bd, c,
+                      static_cast<typename S::Float>(nu_simulations),
+                      nu_simulations, 0, time_source);
+        time += time_source() - start;
+        simulations += search.get_nu_simulations();
+    }
+    search.set_reuse_subtree(reuse_subtree);
+    search.set_reuse_tree(reuse_tree);
+    response << "Threads: " << search.get_nu_threads()
+             << ", Bound: " << (search.get_cpus().empty() ? "no" : "yes")
+             << ", Sim: " << simulations
+             << ", Tm: " << fixed << setprecision(2) << time
+             << ", Sim/s: " << setprecision(0)
+             << static_cast<double>(simulations) / time;
+}
+
+/** Measure the speed of the search in the current position.
+    Arguments: number of searches (default 3), number of simulations per
+    search (default 100000). The searches start with an empty tree and always
+    run the full number of simulations. Useful for comparing the scaling with
+    the number of threads and with or without binding threads to CPUs. */
+void Engine::cmd_benchmark(const Arguments& args, Response& response)
+{
+    args.check_size_less_equal(2);
+    unsigned nu_searches = 3;
+    if (args.get_size() > 0)
+        nu_searches = args.parse_min<unsigned>(0, 1);
+    size_t nu_simulations = 100000;
+    if (args.get_size() > 1)
+        nu_simulations = args.parse_min<size_t>(1, 1);
+    get_mcts_player().with_search([&](auto& search) {
+        this->benchmark(search, nu_searches, nu_simulations, response);
+    });
+}
+
+void Engine::cmd_g(Response& response)
+{
+    libpentobi_base::Engine::cmd_g(response);
+    start_ponder();
+}
+
+void Engine::cmd_genmove(const Arguments& args, Response& response)
+{
+    libpentobi_base::Engine::cmd_genmove(args, response);
+    start_ponder();
+}
 
 void Engine::cmd_get_value(Response& response)
 {
-    response << get_search().get_tree().get_root().get_value();
+    get_mcts_player().with_search([&](auto& search) {
+        response << search.get_tree().get_root().get_value();
+    });
 }
 
 void Engine::cmd_move_values(Response& response)
 {
-    auto& search = get_search();
-    auto& tree = search.get_tree();
-    auto& bd = get_board();
-    vector<const Search::Node*> children;
-    children.reserve(tree.get_root().get_nu_children());
-    for (auto& i : tree.get_root_children())
-        children.push_back(&i);
-    sort(children.begin(), children.end(), libpentobi_mcts::util::compare_node);
-    response << fixed;
-    for (auto node : children)
-        response << setprecision(0) << node->get_visit_count() << ' '
-                 << setprecision(1) << node->get_value_count() << ' '
-                 << setprecision(3) << node->get_value() << ' '
-                 << bd.to_string(node->get_move(), true) << '\n';
+    get_mcts_player().with_search([&](auto& search) {
+        this->move_values(search, response);
+    });
 }
 
 void Engine::cmd_name(Response& response)
@@ -69,70 +146,187 @@ void Engine::cmd_name(Response& response)
     response.set("Pentobi");
 }
 
+void Engine::cmd_p(const Arguments& args)
+{
+    libpentobi_base::Engine::cmd_p(args);
+    if (m_is_ponder_interrupted)
+        start_ponder();
+}
+
+void Engine::cmd_play(const Arguments& args)
+{
+    libpentobi_base::Engine::cmd_play(args);
+    if (m_is_ponder_interrupted)
+        start_ponder();
+}
+
 void Engine::cmd_save_tree(const Arguments& args)
 {
-    auto& search = get_search();
-    if (! search.get_last_history().is_valid())
-        throw Failure("no search tree");
-    ofstream out(args.get());
-    libpentobi_mcts::util::dump_tree(out, search);
+    get_mcts_player().with_search([&](auto& search) {
+        if (! search.get_last_history().is_valid())
+            throw Failure("no search tree");
+        ofstream out(args.get());
+        libpentobi_mcts::util::dump_tree(out, search);
+    });
 }
 
 /** Let the engine play a number of games against itself.
     This is more efficient than using twogtp if selfplay games are needed
     because it has lower memory requirements (only one engine needed), process
     switches between the engines are avoided and parts of the search tree can
-    be reused between moves of different players. */
+    be reused between moves of different players.
+    The games are written to a single file, which gets an index file (see
+    libboardgame_sgf::SgfIndex) that is updated after each game. */
 void Engine::cmd_selfplay(const Arguments& args)
 {
     args.check_size(2);
     auto nu_games = args.parse<int>(0);
-    ofstream out(args.get(1));
+    auto file = args.get(1);
+    ofstream out(file);
+    remove(SgfIndex::get_index_file(file).c_str());
     auto variant = get_board().get_variant();
     auto variant_str = to_string(variant);
     Board bd(variant);
     auto& player = get_mcts_player();
     ostringstream s;
+    uint64_t offset = 0;
     for (int i = 0; i < nu_games; ++i)
     {
+        bd.init();
+        while (! bd.is_game_over())
+        {
+            auto c = bd.get_effective_to_play();
+            auto mv = player.genmove(bd, c);
+            bd.play(c, mv);
+        }
         s.str("");
         Writer writer(s);
         writer.set_indent(-1);
-        bd.init();
         writer.begin_tree();
         writer.begin_node();
         writer.write_property("GM", variant_str);
+        if (bd.get_nu_players() == 2)
+            writer.write_property("RE", get_result_property(bd));
         writer.end_node();
-        while (! bd.is_game_over())
+        for (unsigned j = 0; j < bd.get_nu_moves(); ++j)
         {
-            auto c = bd.get_effective_to_play();
-            auto mv = player.genmove(bd, c);
-            bd.play(c, mv);
+            auto mv = bd.get_move(j);
             writer.begin_node();
-            writer.write_property(get_color_id(variant, c),
-                                  bd.to_string(mv, false));
+            writer.write_property(get_color_id(variant, mv.color),
+                                  bd.to_string(mv.move, false));
             writer.end_node();
         }
         writer.end_tree();
-        out << s.str() << '\n';
+        auto game = s.str();
+        out << game << '\n' << flush;
+        SgfIndex index;
+        index.update(game.data(), game.size());
+        auto entry = index[0];
+        entry.offset = offset;
+        if (! SgfIndex::append(file, { entry }))
+            throw Failure("could not write " + SgfIndex::get_index_file(file));
+        offset += game.size() + 1;
     }
 }
 
 void Engine::cmd_param(const Arguments& args, Response& response)
+{
+    get_mcts_player().with_search([&](auto& search) {
+        this->param(search, args, response);
+    });
+}
+
+void Engine::cmd_version(Response& response)
+{
+    string version;
+#ifdef VERSION
+    version = VERSION;
+#else
+    version = "UNKNOWN";
+#endif
+    // By convention, the version string of unreleased versions contains the
+    // string UNKNOWN (appended to the last released version). In this case, or
+    // if VERSION was undefined, we append the build date.
+    if (version.find("UNKNOWN") != string::npos)
+    {
+        version.append(" (");
+        version.append(__DATE__);
+        version.append(")");
+    }
+#if LIBBOARDGAME_DEBUG
+    version.append(" (dbg)");
+#endif
+    response.set(version);
+}
+
+void Engine::create_player(Variant variant, unsigned level,
+                           const string& books_dir, unsigned nu_threads,
+                           size_t memory, bool long_analysis)
+{
+    auto max_level = level;
+    m_player.reset(new Player(variant, max_level, books_dir, nu_threads,
+                              memory, long_analysis));
+    get_mcts_player().set_level(level);
+    set_player(*m_player);
+}
+
+Player& Engine::get_mcts_player()
+{
+    try
+    {
+        return dynamic_cast<Player&>(*m_player);
+    }
+    catch (const bad_cast&)
+    {
+        throw Failure("current player is not mcts player");
+    }
+}
+
+template<class S>
+void Engine::move_values(const S& search, Response& response)
+{
+    typedef typename S::Node Node;
+    auto& tree = search.get_tree();
+    auto& bd = get_board();
+    vector<const Node*> children;
+    children.reserve(tree.get_root().get_nu_children());
+    for (auto& i : tree.get_root_children())
+        children.push_back(&i);
+    sort(children.begin(), children.end(),
+         libpentobi_mcts::util::compare_node<Node>);
+    response << fixed;
+    for (auto node : children)
+        response << setprecision(0) << node->get_visit_count() << ' '
+                 << setprecision(1) << node->get_value_count() << ' '
+                 << setprecision(3) << node->get_value() << ' '
+                 << bd.to_string(node->get_move(), true) << '\n';
+}
+
+void Engine::on_handle_cmd_begin()
+{
+    m_is_ponder_interrupted = stop_ponder();
+    libpentobi_base::Engine::on_handle_cmd_begin();
+}
+
+template<class S>
+void Engine::param(S& s, const Arguments& args, Response& response)
 {
     auto& p = get_mcts_player();
-    auto& s = get_search();
     if (args.get_size() == 0)
         response
             << "avoid_symmetric_draw " << s.get_avoid_symmetric_draw() << '\n'
             << "auto_param " << s.get_auto_param() << '\n'
             << "exploration_constant " << s.get_exploration_constant() << '\n'
             << "fixed_simulations " << p.get_fixed_simulations() << '\n'
+            << "huge_pages " << s.get_use_huge_pages() << '\n'
+            << "ponder " << m_ponder << '\n'
             << "rave_child_max " << s.get_rave_child_max() << '\n'
             << "rave_parent_max " << s.get_rave_parent_max() << '\n'
             << "rave_weight " << s.get_rave_weight() << '\n'
             << "reuse_subtree " << s.get_reuse_subtree() << '\n'
-            << "use_book " << p.get_use_book() << '\n';
+            << "transpositions " << s.get_use_transpositions() << '\n'
+            << "use_book " << p.get_use_book() << '\n'
+            << "use_solver " << p.get_use_solver() << '\n';
     else
     {
         args.check_size(2);
@@ -145,6 +339,10 @@ void Engine::cmd_param(const Arguments& args, Response& response)
             s.set_exploration_constant(args.parse<Float>(1));
         else if (name == "fixed_simulations")
             p.set_fixed_simulations(args.parse<Float>(1));
+        else if (name == "huge_pages")
+            s.set_use_huge_pages(args.parse<bool>(1));
+        else if (name == "ponder")
+            set_ponder(args.parse<bool>(1));
         else if (name == "rave_child_max")
             s.set_rave_child_max(args.parse<Float>(1));
         else if (name == "rave_parent_max")
@@ -153,8 +351,12 @@ void Engine::cmd_param(const Arguments& args, Response& response)
             s.set_rave_weight(args.parse<Float>(1));
         else if (name == "reuse_subtree")
             s.set_reuse_subtree(args.parse<bool>(1));
+        else if (name == "transpositions")
+            s.set_use_transpositions(args.parse<bool>(1));
         else if (name == "use_book")
             p.set_use_book(args.parse<bool>(1));
+        else if (name == "use_solver")
+            p.set_use_solver(args.parse<bool>(1));
         else
         {
             ostringstream msg;
@@ -164,53 +366,43 @@ void Engine::cmd_param(const Arguments& args, Response& response)
     }
 }
 
-void Engine::cmd_version(Response& response)
+void Engine::set_ponder(bool enable)
 {
-    string version;
-#ifdef VERSION
-    version = VERSION;
-#else
-    version = "UNKNOWN";
-#endif
-    // By convention, the version string of unreleased versions contains the
-    // string UNKNOWN (appended to the last released version). In this case, or
-    // if VERSION was undefined, we append the build date.
-    if (version.find("UNKNOWN") != string::npos)
-    {
-        version.append(" (");
-        version.append(__DATE__);
-        version.append(")");
-    }
-#if LIBBOARDGAME_DEBUG
-    version.append(" (dbg)");
-#endif
-    response.set(version);
+    m_ponder = enable;
+    // Pondering in the position after an opponent move is only useful if
+    // the tree can be reused by a following genmove in the same position
+    get_mcts_player().with_search([&](auto& search) {
+        search.set_reuse_tree(enable);
+    });
 }
 
-void Engine::create_player(Variant variant, unsigned level,
-                           const string& books_dir, unsigned nu_threads)
+void Engine::start_ponder()
 {
-    auto max_level = level;
-    m_player.reset(new Player(variant, max_level, books_dir, nu_threads));
-    get_mcts_player().set_level(level);
-    set_player(*m_player);
-}
-
-Player& Engine::get_mcts_player()
-{
-    try
-    {
-        return dynamic_cast<Player&>(*m_player);
-    }
-    catch (const bad_cast&)
-    {
-        throw Failure("current player is not mcts player");
-    }
+    if (! m_ponder)
+        return;
+    auto& bd = get_board();
+    if (bd.is_game_over())
+        return;
+    if (! m_ponder_bd)
+        m_ponder_bd = make_unique<Board>(bd.get_variant());
+    m_ponder_bd->copy_from(bd);
+    auto to_play = bd.get_effective_to_play();
+    auto& player = get_mcts_player();
+    m_ponder_thread = thread([this, &player, to_play] {
+        player.ponder(*m_ponder_bd, to_play);
+    });
 }
 
-Search& Engine::get_search()
+/** Stop pondering.
+    @return @c true if pondering was running. */
+bool Engine::stop_ponder()
 {
-    return get_mcts_player().get_search();
+    if (! m_ponder_thread.joinable())
+        return false;
+    set_abort();
+    m_ponder_thread.join();
+    clear_abort();
+    return true;
 }
 
 void Engine::use_cpu_time(bool enable)
@@ -7,6 +7,7 @@
 #ifndef PENTOBI_GTP_ENGINE_H
 #define PENTOBI_GTP_ENGINE_H
 
+#include <thread>
 #include "libpentobi_base/Engine.h"
 #include "libpentobi_mcts/Player.h"
 
@@ -15,10 +16,10 @@ namespace pentobi_gtp {
 using namespace std;
 using libboardgame_gtp::Arguments;
 using libboardgame_gtp::Response;
+using libpentobi_base::Board;
 using libpentobi_base::PlayerBase;
 using libpentobi_base::Variant;
 using libpentobi_mcts::Player;
-using libpentobi_mcts::Search;
 
 //-----------------------------------------------------------------------------
 
@@ -26,16 +27,24 @@ class Engine
     : public libpentobi_base::Engine
 {
 public:
+    /** Constructor.
+        See Player::Player() for the meaning of the parameters. */
     Engine(Variant variant, unsigned level = 5,
            bool use_book = true, const string& books_dir = "",
-           unsigned nu_threads = 0);
+           unsigned nu_threads = 0, size_t memory = 0,
+           bool long_analysis = false);
 
     ~Engine();
 
+    void cmd_benchmark(const Arguments&, Response&);
     void cmd_param(const Arguments&, Response&);
+    void cmd_g(Response&);
+    void cmd_genmove(const Arguments&, Response&);
     void cmd_get_value(Response&);
     void cmd_move_values(Response&);
     void cmd_name(Response&);
+    void cmd_p(const Arguments&);
+    void cmd_play(const Arguments&);
     void cmd_selfplay(const Arguments&);
     void cmd_save_tree(const Arguments&);
     void cmd_version(Response&);
@@ -45,13 +54,47 @@ public:
     /** @see Player::use_cpu_time() */
     void use_cpu_time(bool enable);
 
+    /** Enable pondering.
+        If enabled, the engine searches in the background after a move
+        generation command until the next command is received. If the next
+        command is a play command, the search continues in the new position
+        and reuses the matching part of the search tree. Pondering is
+        disabled by default. */
+    void set_ponder(bool enable);
+
+protected:
+    void on_handle_cmd_begin() override;
+
 private:
+    bool m_ponder = false;
+
+    /** Was pondering stopped by the current command? */
+    bool m_is_ponder_interrupted = false;
+
     unique_ptr<PlayerBase> m_player;
 
+    /** Copy of the board used by the ponder thread. */
+    unique_ptr<Board> m_ponder_bd;
+
+    thread m_ponder_thread;
+
+    template<class S>
+    void benchmark(S& search, unsigned nu_searches, size_t nu_simulations,
+                   Response& response);
+
     void create_player(Variant variant, unsigned level,
-                       const string& books_dir, unsigned nu_threads);
+                       const string& books_dir, unsigned nu_threads,
+                       size_t memory, bool long_analysis);
+
+    template<class S>
+    void move_values(const S& search, Response& response);
+
+    template<class S>
+    void param(S& s, const Arguments& args, Response& response);
+
+    void start_ponder();
 
-    Search& get_search();
+    bool stop_ponder();
 };
 
 //-----------------------------------------------------------------------------
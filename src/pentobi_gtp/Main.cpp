@@ -10,16 +10,21 @@
 
 #include <fstream>
 #include "Engine.h"
+#include "libboardgame_sys/CpuAffinity.h"
 #include "libboardgame_util/Log.h"
 #include "libboardgame_util/Options.h"
 #include "libboardgame_util/RandomGenerator.h"
+#include "libboardgame_util/StringUtil.h"
 
 using namespace std;
 using libboardgame_gtp::Failure;
 using libboardgame_util::Options;
 using libboardgame_util::RandomGenerator;
+using libboardgame_util::from_string;
+using libboardgame_util::split;
 using libpentobi_base::parse_variant_id;
 using libpentobi_base::Board;
+using libpentobi_base::BoardConst;
 using libpentobi_base::Variant;
 using libpentobi_mcts::Player;
 
@@ -53,14 +58,20 @@ int main(int argc, char** argv)
     {
         vector<string> specs = {
             "book:",
+            "cache-dir:",
             "config|c:",
             "color",
+            "cpus:",
             "cputime",
             "game|g:",
             "help|h",
             "level|l:",
+            "long-analysis",
+            "memory:",
             "nobook",
             "noresign",
+            "pin-threads",
+            "ponder",
             "quiet|q",
             "seed|r:",
             "showboard",
@@ -73,18 +84,24 @@ int main(int argc, char** argv)
             cout <<
                 "Usage: pentobi_gtp [options] [input files]\n"
                 "--book       load an external book file\n"
+                "--cache-dir  cache move tables in a directory\n"
                 "--config,-c  set GTP config file\n"
                 "--color      colorize text output of boards\n"
+                "--cpus       bind threads to a comma-separated list of CPUs\n"
                 "--cputime    use CPU time\n"
                 "--game,-g    game variant (classic, classic_2, classic_3,\n"
                 "             duo, trigon, trigon_2, trigon_3, junior)\n"
                 "--help,-h    print help message and exit\n"
                 "--level,-l   set playing strength level\n"
+                "--long-analysis allow more than 2^24 simulations per search\n"
+                "--memory     maximum memory for the search tree in MB\n"
                 "--seed,-r    set random seed\n"
                 "--showboard  automatically write board to stderr after\n"
                 "             changes\n"
                 "--nobook     disable opening book\n"
                 "--noresign   disable resign\n"
+                "--pin-threads bind threads to the available CPUs\n"
+                "--ponder     search during the opponent's time\n"
                 "--quiet,-q   do not print logging messages\n"
                 "--threads    number of threads in the search\n"
                 "--version,-v print version and exit\n";
@@ -112,6 +129,8 @@ int main(int argc, char** argv)
         if (opt.contains("seed"))
             RandomGenerator::set_global_seed(
                         opt.get<RandomGenerator::ResultType>("seed"));
+        if (opt.contains("cache-dir"))
+            BoardConst::set_cache_dir(opt.get("cache-dir"));
         string variant_string = opt.get("game", "classic");
         Variant variant;
         if (! parse_variant_id(variant_string, variant))
@@ -119,11 +138,39 @@ int main(int argc, char** argv)
         auto level = opt.get<unsigned>("level", 4);
         if (level < 1 || level > Player::max_supported_level)
             throw runtime_error("invalid level");
+        size_t memory = 0;
+        if (opt.contains("memory"))
+        {
+            memory = opt.get<size_t>("memory") * 1000000;
+            if (memory == 0)
+                throw runtime_error("Memory must be greater zero.");
+        }
+        vector<unsigned> cpus;
+        if (opt.contains("cpus"))
+            for (auto& s : split(opt.get("cpus"), ','))
+            {
+                unsigned cpu;
+                if (! from_string(s, cpu))
+                    throw runtime_error("invalid CPU " + s);
+                cpus.push_back(cpu);
+            }
+        else if (opt.contains("pin-threads"))
+        {
+            cpus = libboardgame_sys::get_available_cpus();
+            if (cpus.empty())
+                LIBBOARDGAME_LOG("Could not determine the available CPUs");
+        }
         auto use_book = (! opt.contains("nobook"));
         string books_dir = application_dir_path;
+        auto long_analysis = opt.contains("long-analysis");
         pentobi_gtp::Engine engine(variant, level, use_book, books_dir,
-                                   threads);
+                                   threads, memory, long_analysis);
         engine.set_resign(! opt.contains("noresign"));
+        engine.get_mcts_player().with_search([&](auto& search) {
+            search.set_cpus(cpus);
+        });
+        if (opt.contains("ponder"))
+            engine.set_ponder(true);
         if (opt.contains("showboard"))
             engine.set_show_board(true);
         if (opt.contains("cputime"))
@@ -46,7 +46,7 @@ AnalyzeGameModel::~AnalyzeGameModel()
     cancel();
 }
 
-void AnalyzeGameModel::asyncRun(const Game* game, Search* search)
+void AnalyzeGameModel::asyncRun(const Game* game, Player* player)
 {
     size_t nuSimulations = 3000;
     auto progressCallback =
@@ -58,7 +58,7 @@ void AnalyzeGameModel::asyncRun(const Game* game, Search* search)
             QMetaObject::invokeMethod(this, "updateElements",
                                       Qt::BlockingQueuedConnection);
         };
-    m_analyzeGame.run(*game, *search, nuSimulations, progressCallback);
+    m_analyzeGame.run(*game, *player, nuSimulations, progressCallback);
 }
 
 void AnalyzeGameModel::autoSave(GameModel* gameModel)
@@ -239,7 +239,7 @@ void AnalyzeGameModel::start(GameModel* gameModel, PlayerModel* playerModel)
     clear_abort();
     auto future = QtConcurrent::run(this, &AnalyzeGameModel::asyncRun,
                                     &gameModel->getGame(),
-                                    &playerModel->getSearch());
+                                    &playerModel->getPlayer());
     m_watcher.setFuture(future);
     setIsRunning(true);
 }
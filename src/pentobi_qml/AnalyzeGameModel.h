@@ -14,11 +14,10 @@
 class GameModel;
 class PlayerModel;
 namespace libpentobi_base { class Game; }
-namespace libpentobi_mcts { class Search; }
 
 using libpentobi_base::Game;
 using libpentobi_mcts::AnalyzeGame;
-using libpentobi_mcts::Search;
+using libpentobi_mcts::Player;
 
 //-----------------------------------------------------------------------------
 
@@ -101,7 +100,7 @@ private:
     Q_INVOKABLE void updateElements();
 
 
-    void asyncRun(const Game* game, Search* search);
+    void asyncRun(const Game* game, Player* player);
 
     void setIsRunning(bool isRunning);
 
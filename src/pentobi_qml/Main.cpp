@@ -10,7 +10,9 @@
 
 #include <QApplication>
 #include <QCommandLineParser>
+#include <QDir>
 #include <QMessageBox>
+#include <QStandardPaths>
 #include <QTranslator>
 #include <QtQml>
 #include <QtWebView/QtWebView>
@@ -22,11 +24,22 @@
 #include "libboardgame_util/Log.h"
 
 using libboardgame_util::RandomGenerator;
+using libpentobi_base::BoardConst;
 
 //-----------------------------------------------------------------------------
 
 namespace {
 
+/** Use the user cache directory for the move tables, creating them at
+    startup of the game variant takes a noticeable time on slow devices. */
+void initBoardConstCache()
+{
+    auto dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (! dir.isEmpty() && QDir().mkpath(dir))
+        BoardConst::set_cache_dir(QDir::toNativeSeparators(dir)
+                                  .toLocal8Bit().constData());
+}
+
 #ifdef Q_OS_ANDROID
 void initAndroid()
 {
@@ -92,6 +105,7 @@ int main(int argc, char *argv[])
         if (! parser.isSet(optionVerbose))
             libboardgame_util::disable_logging();
 #endif
+        initBoardConstCache();
         if (parser.isSet(optionNoBook))
             PlayerModel::noBook = true;
         if (parser.isSet(optionNoDelay))
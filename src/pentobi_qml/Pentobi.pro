@@ -8,6 +8,11 @@ DEFINES += QT_DEPRECATED_WARNINGS
 DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x050900
 DEFINES += VERSION=\"\\\"13.UNKNOWN\\\"\"
 DEFINES += PENTOBI_LOW_RESOURCES
+unix {
+    DEFINES += HAVE_SYS_MMAN_H=1
+    DEFINES += HAVE_SCHED_H=1
+    DEFINES += HAVE_UNISTD_H=1
+}
 android {
     QMAKE_CXXFLAGS_RELEASE += -DLIBBOARDGAME_DISABLE_LOG
 }
@@ -42,6 +47,7 @@ SOURCES += \
     ../libboardgame_util/Log.cpp \
     ../libboardgame_util/RandomGenerator.cpp \
     ../libboardgame_util/StringUtil.cpp \
+    ../libboardgame_util/ThreadPool.cpp \
     ../libboardgame_util/TimeIntervalChecker.cpp \
     ../libboardgame_util/Timer.cpp \
     ../libboardgame_util/TimeSource.cpp \
@@ -54,8 +60,11 @@ SOURCES += \
     ../libboardgame_sgf/TreeReader.cpp \
     ../libboardgame_sgf/TreeWriter.cpp \
     ../libboardgame_sgf/Writer.cpp \
+    ../libboardgame_sys/CpuAffinity.cpp \
     ../libboardgame_sys/CpuTime.cpp \
+    ../libboardgame_sys/MappedFile.cpp \
     ../libboardgame_sys/Memory.cpp \
+    ../libboardgame_sys/Process.cpp \
     ../libpentobi_base/Board.cpp \
     ../libpentobi_base/BoardConst.cpp \
     ../libpentobi_base/BoardUpdater.cpp \
@@ -82,6 +91,7 @@ SOURCES += \
     ../libpentobi_base/TrigonGeometry.cpp \
     ../libpentobi_base/TrigonTransform.cpp \
     ../libpentobi_base/Variant.cpp \
+    ../libpentobi_base/Zobrist.cpp \
     ../libpentobi_base/PlayerBase.cpp \
     ../libpentobi_base/PentobiTree.cpp \
     ../libpentobi_mcts/AnalyzeGame.cpp \
@@ -91,6 +101,7 @@ SOURCES += \
     ../libpentobi_mcts/PriorKnowledge.cpp \
     ../libpentobi_mcts/Search.cpp \
     ../libpentobi_mcts/SharedConst.cpp \
+    ../libpentobi_mcts/Solver.cpp \
     ../libpentobi_mcts/State.cpp \
     ../libpentobi_mcts/Util.cpp \
     ../libpentobi_mcts/StateUtil.cpp
@@ -127,10 +138,12 @@ HEADERS += \
     ../libboardgame_base/StringRep.h \
     ../libboardgame_base/Transform.h \
     ../libboardgame_mcts/Atomic.h \
+    ../libboardgame_mcts/CompactNode.h \
     ../libboardgame_mcts/LastGoodReply.h \
     ../libboardgame_mcts/Node.h \
     ../libboardgame_mcts/PlayerMove.h \
     ../libboardgame_mcts/SearchBase.h \
+    ../libboardgame_mcts/SelectChild.h \
     ../libboardgame_mcts/Tree.h \
     ../libboardgame_mcts/TreeUtil.h \
     ../libboardgame_util/Abort.h \
@@ -142,10 +155,13 @@ HEADERS += \
     ../libboardgame_util/IntervalChecker.h \
     ../libboardgame_util/Log.h \
     ../libboardgame_util/MathUtil.h \
+    ../libboardgame_util/MemoryPool.h \
     ../libboardgame_util/Options.h \
     ../libboardgame_util/RandomGenerator.h \
     ../libboardgame_util/Statistics.h \
     ../libboardgame_util/StringUtil.h \
+    ../libboardgame_util/StringView.h \
+    ../libboardgame_util/ThreadPool.h \
     ../libboardgame_util/TimeIntervalChecker.h \
     ../libboardgame_util/Timer.h \
     ../libboardgame_util/TimeSource.h \
@@ -159,8 +175,12 @@ HEADERS += \
     ../libboardgame_sgf/TreeReader.h \
     ../libboardgame_sgf/Writer.h \
     ../libboardgame_sys/Compiler.h \
+    ../libboardgame_sys/CpuAffinity.h \
     ../libboardgame_sys/CpuTime.h \
+    ../libboardgame_sys/MappedFile.h \
     ../libboardgame_sys/Memory.h \
+    ../libboardgame_sys/Process.h \
+    ../libpentobi_base/Bitboard.h \
     ../libpentobi_base/Board.h \
     ../libpentobi_base/BoardConst.h \
     ../libpentobi_base/BoardUpdater.h \
@@ -203,6 +223,7 @@ HEADERS += \
     ../libpentobi_base/TrigonGeometry.h \
     ../libpentobi_base/TrigonTransform.h \
     ../libpentobi_base/Variant.h \
+    ../libpentobi_base/Zobrist.h \
     ../libpentobi_mcts/AnalyzeGame.h \
     ../libpentobi_mcts/Float.h \
     ../libpentobi_mcts/History.h \
@@ -212,6 +233,7 @@ HEADERS += \
     ../libpentobi_mcts/Search.h \
     ../libpentobi_mcts/SearchParamConst.h \
     ../libpentobi_mcts/SharedConst.h \
+    ../libpentobi_mcts/Solver.h \
     ../libpentobi_mcts/State.h \
     ../libpentobi_mcts/StateUtil.h \
     ../libpentobi_mcts/Util.h
@@ -18,7 +18,6 @@ using libpentobi_base::Color;
 using libpentobi_base::Move;
 using libpentobi_base::Variant;
 using libpentobi_mcts::Player;
-using libpentobi_mcts::Search;
 
 //-----------------------------------------------------------------------------
 
@@ -76,7 +75,7 @@ public:
 
     bool isGenMoveRunning() const { return m_isGenMoveRunning; }
 
-    Search& getSearch() { return m_player.get_search(); }
+    Player& getPlayer() { return m_player; }
 
 signals:
     void gameVariantChanged();
@@ -10,24 +10,57 @@
 
 #include "Analyze.h"
 
+#include <algorithm>
 #include <fstream>
 #include <map>
-#include <regex>
+#include "libboardgame_sgf/SgfCollection.h"
 #include "libboardgame_util/FmtSaver.h"
 #include "libboardgame_util/Statistics.h"
 #include "libboardgame_util/StringUtil.h"
 
+using libboardgame_sgf::Reader;
+using libboardgame_sgf::SgfCollection;
 using libboardgame_util::from_string;
 using libboardgame_util::split;
 using libboardgame_util::trim;
 using libboardgame_util::FmtSaver;
 using libboardgame_util::Statistics;
 using libboardgame_util::StatisticsExt;
+using libboardgame_util::StringView;
 
 //-----------------------------------------------------------------------------
 
 namespace {
 
+/** Reader that gets the game name of a twogtp game, the game number. */
+class GameNameReader
+    : public Reader
+{
+public:
+    string name;
+
+    GameNameReader()
+    {
+        set_read_only_main_variation(true);
+    }
+
+    void on_begin_node(bool is_root) override
+    {
+        m_is_root = is_root;
+        if (is_root)
+            name.clear();
+    }
+
+    void on_property(StringView id, const vector<StringView>& values) override
+    {
+        if (m_is_root && id == "GN")
+            name = values[0].to_string();
+    }
+
+private:
+    bool m_is_root;
+};
+
 void write_result(const Statistics<>& stat)
 {
     FmtSaver saver(cout);
@@ -137,36 +170,22 @@ void analyze(const string& file)
 
 void splitsgf(const string& file)
 {
-    ifstream in(file);
-    string filename;
-    string buffer;
-    regex pattern("GN\\[(\\d+)\\]");
-    string line;
-    while (getline(in, line))
+    SgfCollection collection;
+    collection.open(file);
+    GameNameReader reader;
+    for (size_t i = 0; i < collection.get_nu_games(); ++i)
     {
-        if (trim(line) == "(")
-        {
-            if (! filename.empty())
-            {
-                ofstream out(filename);
-                out << buffer;
-            }
-            buffer.clear();
-        }
-        else
-        {
-            smatch match;
-            regex_search(line, match, pattern);
-            if (! match.empty())
-                filename = string(match[1]) + ".blksgf";
-        }
-        buffer.append(line);
-        buffer.append("\n");
-    }
-    if (! filename.empty())
-    {
-        ofstream out(filename);
-        out << buffer;
+        collection.read(reader, i);
+        // The game name is used as the file name. Accept only game numbers
+        // as written by twogtp, such that a game name cannot contain a path.
+        if (reader.name.empty()
+                || ! all_of(reader.name.begin(), reader.name.end(),
+                            [](char c) { return c >= '0' && c <= '9'; }))
+            continue;
+        ofstream out(reader.name + ".blksgf");
+        auto game = collection.get_game(i);
+        out.write(game.data(), static_cast<streamsize>(game.size()));
+        out << '\n';
     }
 }
 
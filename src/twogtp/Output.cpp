@@ -16,6 +16,7 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/file.h>
+#include "libboardgame_util/Log.h"
 #include "libboardgame_util/StringUtil.h"
 
 using libboardgame_util::from_string;
@@ -88,6 +89,12 @@ void Output::add_result(unsigned n, float result, const Board& bd,
              << cpu_white << '\t'
              << nu_fast_open;
         m_games.insert(make_pair(n, line.str()));
+        SgfIndex index;
+        index.update(sgf.data(), sgf.size());
+        LIBBOARDGAME_ASSERT(index.size() == 1);
+        auto entry = index[0];
+        entry.offset += static_cast<uint64_t>(m_sgf_buffer.tellp());
+        m_index_entries.push_back(entry);
         m_sgf_buffer << sgf;
         if (m_create_tree)
             m_output_tree.add_game(bd, player_black, result, is_real_move);
@@ -132,9 +139,32 @@ void Output::save()
             out << i.second << '\n';
     }
     {
-        ofstream out(m_prefix + ".blksgf", ios::app);
-        out << m_sgf_buffer.str();
-        m_sgf_buffer.str("");
+        auto file = m_prefix + ".blksgf";
+        uint64_t offset = 0;
+        {
+            ifstream in(file, ios::binary | ios::ate);
+            if (in)
+                offset = static_cast<uint64_t>(in.tellg());
+        }
+        {
+            ofstream out(file, ios::app);
+            out << m_sgf_buffer.str();
+            m_sgf_buffer.str("");
+        }
+        // If the SGF file was written without an index, it will be indexed
+        // by the first reader of the file (see SgfCollection)
+        auto index_file = SgfIndex::get_index_file(file);
+        if (offset == 0)
+            remove(index_file.c_str());
+        if (! m_index_entries.empty()
+                && (offset == 0 || ! ifstream(index_file).fail()))
+        {
+            for (auto& entry : m_index_entries)
+                entry.offset += offset;
+            if (! SgfIndex::append(file, m_index_entries))
+                LIBBOARDGAME_LOG("WARNING: Could not write ", index_file);
+        }
+        m_index_entries.clear();
     }
     if (m_create_tree)
         m_output_tree.save(m_prefix + "-tree.blksgf");
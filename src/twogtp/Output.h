@@ -11,9 +11,11 @@
 #include <map>
 #include <mutex>
 #include "OutputTree.h"
+#include "libboardgame_sgf/SgfIndex.h"
 #include "libboardgame_util/Timer.h"
 #include "libboardgame_util/WallTimeSource.h"
 
+using libboardgame_sgf::SgfIndex;
 using libboardgame_util::Timer;
 using libboardgame_util::WallTimeSource;
 
@@ -58,6 +60,10 @@ private:
 
     ostringstream m_sgf_buffer;
 
+    /** Index entries of the games in m_sgf_buffer.
+        The offsets are relative to the start of the buffer. */
+    vector<SgfIndex::Entry> m_index_entries;
+
     WallTimeSource m_time_source;
 
     Timer m_timer;
@@ -13,10 +13,12 @@
 #include "libboardgame_sgf/Writer.h"
 #include "libboardgame_util/Log.h"
 #include "libboardgame_util/StringUtil.h"
+#include "libpentobi_base/BoardUtil.h"
 #include "libpentobi_base/ScoreUtil.h"
 
 using libboardgame_sgf::Writer;
 using libboardgame_util::trim;
+using libpentobi_base::boardutil::get_result_property;
 using libpentobi_base::get_multiplayer_result;
 using libpentobi_base::Move;
 using libpentobi_base::PieceSet;
@@ -97,14 +99,6 @@ void TwoGtp::play_game(unsigned game_number)
     unsigned nu_players = m_bd.get_nu_players();
     unsigned player_black = game_number % nu_players;
     bool resign = false;
-    ostringstream sgf_string;
-    Writer sgf(sgf_string);
-    sgf.set_indent(-1);
-    sgf.begin_tree();
-    sgf.begin_node();
-    sgf.write_property("GM", to_string(m_variant));
-    sgf.write_property("GN", game_number);
-    sgf.end_node();
     array<bool, Board::max_moves> is_real_move;
     unsigned player;
     while (! m_bd.is_game_over())
@@ -137,10 +131,6 @@ void TwoGtp::play_game(unsigned game_number)
             }
             mv = m_bd.from_string(response);
         }
-        sgf.begin_node();
-        sgf.write_property(string(1, static_cast<char>(toupper(color[0]))),
-                           m_bd.to_string(mv));
-        sgf.end_node();
         if (mv.is_null() || ! m_bd.is_legal(to_play, mv))
             throw runtime_error("invalid move: " + m_bd.to_string(mv));
         m_bd.play(to_play, mv);
@@ -149,14 +139,39 @@ void TwoGtp::play_game(unsigned game_number)
     cpu_black = send_cputime(m_black) - cpu_black;
     cpu_white = send_cputime(m_white) - cpu_white;
     float result;
+    string result_property;
     if (resign)
     {
         if (nu_players > 2)
             throw runtime_error("resign only allowed in two-player variants");
         result = (player == player_black ? 0 : 1);
+        result_property = (player == 0 ? "W+R" : "B+R");
     }
     else
+    {
         result = get_result(player_black);
+        if (nu_players == 2)
+            result_property = get_result_property(m_bd);
+    }
+    ostringstream sgf_string;
+    Writer sgf(sgf_string);
+    sgf.set_indent(-1);
+    sgf.begin_tree();
+    sgf.begin_node();
+    sgf.write_property("GM", to_string(m_variant));
+    sgf.write_property("GN", game_number);
+    if (! result_property.empty())
+        sgf.write_property("RE", result_property);
+    sgf.end_node();
+    for (unsigned i = 0; i < m_bd.get_nu_moves(); ++i)
+    {
+        auto mv = m_bd.get_move(i);
+        auto& color = m_colors[mv.color.to_int()];
+        sgf.begin_node();
+        sgf.write_property(string(1, static_cast<char>(toupper(color[0]))),
+                           m_bd.to_string(mv.move));
+        sgf.end_node();
+    }
     sgf.end_tree();
     sgf_string << '\n';
     m_output.add_result(game_number, result, m_bd, player_black, cpu_black,
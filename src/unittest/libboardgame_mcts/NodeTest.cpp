@@ -8,7 +8,7 @@
 #include <config.h>
 #endif
 
-#include "libboardgame_mcts/Node.h"
+#include "libboardgame_mcts/CompactNode.h"
 
 #include "libboardgame_test/Test.h"
 
@@ -38,4 +38,50 @@ LIBBOARDGAME_TEST_CASE(libboardgame_mcts_node_add_value_remove_loss)
     LIBBOARDGAME_CHECK_CLOSE(node.get_value(), 3.5, 1e-4);
 }
 
+LIBBOARDGAME_TEST_CASE(libboardgame_mcts_compact_node_add_value)
+{
+    libboardgame_mcts::CompactNode<int, float, true> node;
+    node.init(0, 0.5, 0);
+    node.add_value(1);
+    LIBBOARDGAME_CHECK_CLOSE_EPS(node.get_value(), 1., 1e-4);
+    node.add_value(0);
+    LIBBOARDGAME_CHECK_CLOSE_EPS(node.get_value(), 0.5, 1e-4);
+    node.add_value_remove_loss(1);
+    LIBBOARDGAME_CHECK_CLOSE_EPS(node.get_value(), 1., 1e-4);
+    node.add_value(0.25, 2);
+    LIBBOARDGAME_CHECK_CLOSE_EPS(node.get_value(), 0.625, 1e-4);
+    LIBBOARDGAME_CHECK_EQUAL(node.get_value_count(), 4.f);
+    LIBBOARDGAME_CHECK_EQUAL(node.get_visit_count(), 4.f);
+}
+
+/** Check that values outside the supported interval are clamped. */
+LIBBOARDGAME_TEST_CASE(libboardgame_mcts_compact_node_clamp)
+{
+    typedef libboardgame_mcts::CompactNode<int, float, true> Node;
+    Node node;
+    node.init(0, 5, 1);
+    LIBBOARDGAME_CHECK_EQUAL(node.get_value(), Node::value_max);
+    node.init(0, -5, 1);
+    LIBBOARDGAME_CHECK_EQUAL(node.get_value(), Node::value_min);
+}
+
+/** Check that updates smaller than the quantization step are not lost.
+    Without stochastic rounding, the value would stay at its initial value
+    because each update changes the mean by less than half a step. */
+LIBBOARDGAME_TEST_CASE(libboardgame_mcts_compact_node_small_updates)
+{
+    libboardgame_mcts::CompactNode<int, float, true> node;
+    node.init(0, 0, 100000);
+    for (int i = 0; i < 100000; ++i)
+        node.add_value(1);
+    LIBBOARDGAME_CHECK_CLOSE_EPS(node.get_value(), 0.5, 0.002);
+}
+
+LIBBOARDGAME_TEST_CASE(libboardgame_mcts_compact_node_size)
+{
+    LIBBOARDGAME_CHECK(
+                sizeof(libboardgame_mcts::CompactNode<int, float, true>)
+                < sizeof(libboardgame_mcts::Node<int, float, true>));
+}
+
 //-----------------------------------------------------------------------------
@@ -0,0 +1,91 @@
+//-----------------------------------------------------------------------------
+/** @file unittest/libboardgame_mcts/SelectChildTest.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "libboardgame_mcts/SelectChild.h"
+
+#include <memory>
+#include "libboardgame_mcts/Node.h"
+#include "libboardgame_test/Test.h"
+#include "libboardgame_util/RandomGenerator.h"
+
+using namespace std;
+using libboardgame_mcts::select_child;
+using libboardgame_mcts::select_child_scalar;
+using libboardgame_mcts::select_child_simd;
+using libboardgame_util::RandomGenerator;
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+typedef libboardgame_mcts::Node<int, float, true> Node;
+
+typedef libboardgame_mcts::Node<int, double, true> DoubleNode;
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+/** Check that the SIMD selection returns the same child as the scalar
+    selection for all numbers of children up to a few vector widths. */
+LIBBOARDGAME_TEST_CASE(libboardgame_mcts_select_child_simd)
+{
+    RandomGenerator random;
+    random.set_seed(1);
+    const unsigned max_children = 40;
+    unique_ptr<Node[]> nodes(new Node[max_children]);
+    for (int k = 0; k < 100; ++k)
+        for (unsigned n = 1; n <= max_children; ++n)
+        {
+            for (unsigned i = 0; i < n; ++i)
+                nodes[i].init(0, random.generate_float(0, 1),
+                              random.generate_float(3, 1000));
+            auto bias_factor = random.generate_float(0, 100);
+            LIBBOARDGAME_CHECK(
+                        select_child_simd(nodes.get(), nodes.get() + n,
+                                          bias_factor, bias_factor / 3)
+                        == select_child_scalar(nodes.get(), nodes.get() + n,
+                                               bias_factor));
+        }
+}
+
+/** Check that the first child is returned if several children have the
+    highest value. */
+LIBBOARDGAME_TEST_CASE(libboardgame_mcts_select_child_simd_tie)
+{
+    const unsigned nu_children = 21;
+    unique_ptr<Node[]> nodes(new Node[nu_children]);
+    for (unsigned i = 0; i < nu_children; ++i)
+        nodes[i].init(0, 0.5, 10);
+    nodes[13].init(0, 0.7, 10);
+    nodes[19].init(0, 0.7, 10);
+    auto begin = nodes.get();
+    auto end = nodes.get() + nu_children;
+    LIBBOARDGAME_CHECK(select_child_simd(begin, end, 1.f, 0.1f) == begin + 13);
+    nodes[5].init(0, 0.7, 10);
+    LIBBOARDGAME_CHECK(select_child_simd(begin, end, 1.f, 0.1f) == begin + 5);
+    nodes[20].init(0, 0.9, 10);
+    LIBBOARDGAME_CHECK(select_child_simd(begin, end, 1.f, 0.1f) == begin + 20);
+}
+
+/** Check that the selection with double values uses select_child(). */
+LIBBOARDGAME_TEST_CASE(libboardgame_mcts_select_child_simd_double)
+{
+    const unsigned nu_children = 40;
+    unique_ptr<DoubleNode[]> nodes(new DoubleNode[nu_children]);
+    for (unsigned i = 0; i < nu_children; ++i)
+        nodes[i].init(0, 0.01 * i, 5 + i);
+    auto begin = nodes.get();
+    auto end = nodes.get() + nu_children;
+    LIBBOARDGAME_CHECK(select_child_simd(begin, end, 2., 0.4)
+                       == select_child(begin, end, 2., 0.4));
+}
+
+//-----------------------------------------------------------------------------
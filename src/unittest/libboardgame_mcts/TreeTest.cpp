@@ -0,0 +1,84 @@
+//-----------------------------------------------------------------------------
+/** @file unittest/libboardgame_mcts/TreeTest.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "libboardgame_mcts/Tree.h"
+
+#include "libboardgame_test/Test.h"
+
+using namespace std;
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+typedef libboardgame_mcts::Node<int, float, true> Node;
+
+typedef libboardgame_mcts::Tree<Node> Tree;
+
+void expand(Tree& tree, unsigned thread_id, const Node& node,
+            unsigned short nu_children)
+{
+    Tree::NodeExpander expander(thread_id, tree, 0);
+    LIBBOARDGAME_CHECK(expander.check_capacity(nu_children));
+    for (unsigned short i = 0; i < nu_children; ++i)
+        expander.add_child(i, 0.5, 0);
+    expander.link_children(tree, node);
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+/** Test that children linked in a pruned subtree by a thread that was still
+    inside the subtree are reclaimed with the subtree. */
+LIBBOARDGAME_TEST_CASE(libboardgame_mcts_tree_prune_concurrent_expand)
+{
+    Tree tree(1000 * sizeof(Node), 2);
+    expand(tree, 0, tree.get_root(), 2);
+    auto& child = *tree.get_root_children().begin();
+    expand(tree, 0, child, 2);
+    auto& grand_child = *tree.get_children(child).begin();
+    LIBBOARDGAME_CHECK_EQUAL(tree.get_nu_nodes(), 5u);
+    tree.enter(0);
+    tree.enter(1);
+    size_t nu_nodes;
+    LIBBOARDGAME_CHECK(tree.prune(1, nu_nodes));
+    LIBBOARDGAME_CHECK_EQUAL(nu_nodes, 2u);
+    // Thread 1 is still in its simulation and expands a node in the pruned
+    // subtree
+    LIBBOARDGAME_CHECK(! child.has_children());
+    expand(tree, 1, grand_child, 3);
+    tree.leave(1);
+    tree.enter(0);
+    LIBBOARDGAME_CHECK(! tree.prune(1, nu_nodes));
+    LIBBOARDGAME_CHECK_EQUAL(tree.get_nu_nodes(), 3u);
+}
+
+/** Test that the tree is usable after switching the storage between huge
+    pages and normal pages. */
+LIBBOARDGAME_TEST_CASE(libboardgame_mcts_tree_set_huge_pages)
+{
+    Tree tree(1000 * sizeof(Node), 2);
+    expand(tree, 0, tree.get_root(), 2);
+    tree.set_huge_pages(true);
+    LIBBOARDGAME_CHECK(tree.get_huge_pages());
+    LIBBOARDGAME_CHECK_EQUAL(tree.get_nu_nodes(), 1u);
+    expand(tree, 0, tree.get_root(), 400);
+    expand(tree, 1, *tree.get_root_children().begin(), 400);
+    LIBBOARDGAME_CHECK_EQUAL(tree.get_nu_nodes(), 801u);
+    tree.set_huge_pages(false);
+    LIBBOARDGAME_CHECK(! tree.get_huge_pages());
+    LIBBOARDGAME_CHECK_EQUAL(tree.get_nu_nodes(), 1u);
+    expand(tree, 0, tree.get_root(), 400);
+    expand(tree, 1, *tree.get_root_children().begin(), 400);
+    LIBBOARDGAME_CHECK_EQUAL(tree.get_nu_nodes(), 801u);
+}
+
+//-----------------------------------------------------------------------------
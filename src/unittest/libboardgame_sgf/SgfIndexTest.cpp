@@ -0,0 +1,86 @@
+//-----------------------------------------------------------------------------
+/** @file unittest/libboardgame_sgf/SgfIndexTest.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <sstream>
+#include "libboardgame_sgf/Reader.h"
+#include "libboardgame_sgf/SgfIndex.h"
+#include "libboardgame_test/Test.h"
+
+using namespace std;
+using namespace libboardgame_sgf;
+
+//-----------------------------------------------------------------------------
+
+LIBBOARDGAME_TEST_CASE(sgf_index_update)
+{
+    string sgf =
+        "(;GM[Blokus Duo]RE[B+3];B[a1];W[b2](;B[c3])(;B[d4];W[e5]))\n"
+        "\n"
+        "(;GM[Blokus Duo]C[RE[W+1\\]];B[a1])\n";
+    SgfIndex index;
+    LIBBOARDGAME_CHECK(index.update(sgf.data(), sgf.size()));
+    LIBBOARDGAME_CHECK_EQUAL(index.size(), 2u);
+    LIBBOARDGAME_CHECK_EQUAL(index[0].offset, 0u);
+    LIBBOARDGAME_CHECK_EQUAL(index[0].size, 58u);
+    LIBBOARDGAME_CHECK_EQUAL(index[0].length, 3u);
+    LIBBOARDGAME_CHECK_EQUAL(index[0].result, "B+3");
+    LIBBOARDGAME_CHECK_EQUAL(index[1].offset, 60u);
+    LIBBOARDGAME_CHECK_EQUAL(sgf.substr(60, index[1].size),
+                             "(;GM[Blokus Duo]C[RE[W+1\\]];B[a1])");
+    LIBBOARDGAME_CHECK_EQUAL(index[1].length, 1u);
+    LIBBOARDGAME_CHECK_EQUAL(index[1].result, "");
+    LIBBOARDGAME_CHECK(! index.update(sgf.data(), sgf.size()));
+
+    // Appended game is indexed without changing the existing entries
+    sgf += "(;GM[Blokus Duo]RE[0])";
+    LIBBOARDGAME_CHECK(index.update(sgf.data(), sgf.size()));
+    LIBBOARDGAME_CHECK_EQUAL(index.size(), 3u);
+    LIBBOARDGAME_CHECK_EQUAL(index[2].offset, 95u);
+    LIBBOARDGAME_CHECK_EQUAL(index[2].length, 0u);
+    LIBBOARDGAME_CHECK_EQUAL(index[2].result, "0");
+
+    // Index that does not match the data is created from scratch
+    sgf.insert(59, "(;GM[Blokus Duo])");
+    LIBBOARDGAME_CHECK(index.update(sgf.data(), sgf.size()));
+    LIBBOARDGAME_CHECK_EQUAL(index.size(), 4u);
+    LIBBOARDGAME_CHECK_EQUAL(index[1].offset, 59u);
+    LIBBOARDGAME_CHECK_EQUAL(index[1].size, 17u);
+
+    sgf += " x";
+    LIBBOARDGAME_CHECK_THROW(index.update(sgf.data(), sgf.size()),
+                             Reader::ReadError);
+}
+
+LIBBOARDGAME_TEST_CASE(sgf_index_read_write)
+{
+    string sgf = "(;RE[B+R];B[a1])\n(;;B[a1];W[b2])\n";
+    SgfIndex index;
+    index.update(sgf.data(), sgf.size());
+    ostringstream out;
+    index.write(out);
+    LIBBOARDGAME_CHECK_EQUAL(out.str(),
+                             "# Offset\tSize\tLength\tResult\n"
+                             "0\t16\t1\tB+R\n"
+                             "17\t15\t2\t\n");
+    istringstream in(out.str());
+    SgfIndex index2;
+    index2.read(in);
+    LIBBOARDGAME_CHECK_EQUAL(index2.size(), 2u);
+    LIBBOARDGAME_CHECK_EQUAL(index2[1].offset, 17u);
+    LIBBOARDGAME_CHECK_EQUAL(index2[1].size, 15u);
+    LIBBOARDGAME_CHECK_EQUAL(index2[1].length, 2u);
+    LIBBOARDGAME_CHECK_EQUAL(index2[1].result, "");
+    LIBBOARDGAME_CHECK(! index2.update(sgf.data(), sgf.size()));
+    istringstream invalid("0\tx\t1\n");
+    LIBBOARDGAME_CHECK_THROW(index2.read(invalid), runtime_error);
+    LIBBOARDGAME_CHECK_EQUAL(index2.size(), 0u);
+}
+
+//-----------------------------------------------------------------------------
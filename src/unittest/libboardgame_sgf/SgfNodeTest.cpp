@@ -25,6 +25,37 @@ LIBBOARDGAME_TEST_CASE(sgf_node_create_new_child)
     LIBBOARDGAME_CHECK_EQUAL(&child.get_parent(), parent.get());
 }
 
+/** Test that deleting a very deep tree does not overflow the stack. */
+LIBBOARDGAME_TEST_CASE(sgf_node_delete_deep_tree)
+{
+    auto root = make_unique<SgfNode>();
+    auto node = root.get();
+    for (unsigned i = 0; i < 1000000; ++i)
+    {
+        node = &node->create_new_child();
+        if (i % 10 == 0)
+            node->create_new_child().create_new_child();
+    }
+    root.reset();
+}
+
+/** Test that properties with the same identifier share the identifier. */
+LIBBOARDGAME_TEST_CASE(sgf_node_property_id)
+{
+    auto node1 = make_unique<SgfNode>();
+    auto node2 = make_unique<SgfNode>();
+    node1->set_property(string("B"), "a1");
+    node2->set_property(string("B"), "b2");
+    node2->set_property("C", "foo");
+    auto& p1 = node1->get_properties().front();
+    auto& p2 = node2->get_properties().front();
+    LIBBOARDGAME_CHECK_EQUAL(p1.id, "B");
+    LIBBOARDGAME_CHECK_EQUAL(&p1.id, &p2.id);
+    LIBBOARDGAME_CHECK(node2->move_property_to_front("C"));
+    LIBBOARDGAME_CHECK_EQUAL(node2->get_properties().front().id, "C");
+    LIBBOARDGAME_CHECK_EQUAL(node2->get_property("B"), "b2");
+}
+
 LIBBOARDGAME_TEST_CASE(sgf_node_remove_property)
 {
     string id = "B";
@@ -44,6 +44,74 @@ LIBBOARDGAME_TEST_CASE(sgf_tree_reader_basic_2)
     LIBBOARDGAME_CHECK_EQUAL(root.get_child(1).get_property("C"), "2.2");
 }
 
+/** Test values that need to be unescaped mixed with values that can be
+    referenced in the input. */
+LIBBOARDGAME_TEST_CASE(sgf_tree_reader_escape)
+{
+    istringstream in("(;AB[a\\]b][cc][d\\\\][e\r\nf]C[x\\\\y])");
+    TreeReader reader;
+    reader.read(in);
+    auto& root = reader.get_tree();
+    auto values = root.get_multi_property("AB");
+    LIBBOARDGAME_CHECK_EQUAL(values.size(), 4u);
+    LIBBOARDGAME_CHECK_EQUAL(values[0], "a]b");
+    LIBBOARDGAME_CHECK_EQUAL(values[1], "cc");
+    LIBBOARDGAME_CHECK_EQUAL(values[2], "d\\");
+    LIBBOARDGAME_CHECK_EQUAL(values[3], "e\nf");
+    LIBBOARDGAME_CHECK_EQUAL(root.get_property("C"), "x\\y");
+}
+
+/** Test reading multiple trees from memory and from a stream. */
+LIBBOARDGAME_TEST_CASE(sgf_tree_reader_multiple_trees)
+{
+    string s = "(;C[1])\n(;C[2])\n";
+    {
+        TreeReader reader;
+        const char* pos = s.data();
+        const char* end = pos + s.size();
+        LIBBOARDGAME_CHECK(reader.read(pos, end, false));
+        LIBBOARDGAME_CHECK_EQUAL(reader.get_tree().get_property("C"), "1");
+        LIBBOARDGAME_CHECK(! reader.read(pos, end, false));
+        LIBBOARDGAME_CHECK_EQUAL(reader.get_tree().get_property("C"), "2");
+        LIBBOARDGAME_CHECK(pos == end);
+    }
+    {
+        istringstream in(s);
+        TreeReader reader;
+        LIBBOARDGAME_CHECK(reader.read(in, false));
+        LIBBOARDGAME_CHECK_EQUAL(reader.get_tree().get_property("C"), "1");
+        // The stream is positioned at the next tree
+        LIBBOARDGAME_CHECK_EQUAL(in.peek(), '(');
+        LIBBOARDGAME_CHECK(! reader.read(in, false));
+        LIBBOARDGAME_CHECK_EQUAL(reader.get_tree().get_property("C"), "2");
+    }
+    {
+        // A new stream is read from its start even if a previous stream
+        // was not read to the end (the streams could have the same address)
+        TreeReader reader;
+        for (auto& c : { "1", "2" })
+        {
+            istringstream in(string("(;C[") + c + "])\n(;C[x])");
+            LIBBOARDGAME_CHECK(reader.read(in, false));
+            LIBBOARDGAME_CHECK_EQUAL(reader.get_tree().get_property("C"), c);
+        }
+    }
+    {
+        // Parentheses in property values
+        istringstream in("(;C[(\\])];B[a1](;C[)]))(;C[2])");
+        TreeReader reader;
+        LIBBOARDGAME_CHECK(reader.read(in, false));
+        LIBBOARDGAME_CHECK_EQUAL(reader.get_tree().get_property("C"), "(])");
+        LIBBOARDGAME_CHECK(! reader.read(in, false));
+        LIBBOARDGAME_CHECK_EQUAL(reader.get_tree().get_property("C"), "2");
+    }
+    {
+        istringstream in(s);
+        TreeReader reader;
+        LIBBOARDGAME_CHECK_THROW(reader.read(in), TreeReader::ReadError);
+    }
+}
+
 /** Test that a property value with a unicode character is preserved after
     reading and writing.
     In previous versions this was broken because of a bug in the replacement
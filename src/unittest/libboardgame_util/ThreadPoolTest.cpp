@@ -0,0 +1,88 @@
+//-----------------------------------------------------------------------------
+/** @file unittest/libboardgame_util/ThreadPoolTest.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "libboardgame_util/ThreadPool.h"
+#include "libboardgame_test/Test.h"
+
+using namespace std;
+using namespace libboardgame_util;
+
+//-----------------------------------------------------------------------------
+
+LIBBOARDGAME_TEST_CASE(util_thread_pool_basic)
+{
+    ThreadPool pool;
+    pool.reserve(3);
+    LIBBOARDGAME_CHECK_EQUAL(3u, pool.get_nu_workers());
+    atomic<unsigned> count(0);
+    ThreadPool::TaskGroup group;
+    for (unsigned i = 0; i < 100; ++i)
+        pool.submit(group, [&] { ++count; });
+    pool.wait(group);
+    LIBBOARDGAME_CHECK_EQUAL(100u, count.load());
+    // Submit again after the workers became idle
+    for (unsigned i = 0; i < 10; ++i)
+        pool.submit(group, [&] { ++count; });
+    pool.wait(group);
+    LIBBOARDGAME_CHECK_EQUAL(110u, count.load());
+}
+
+/** Check that reserve() does not create more than max_workers workers. */
+LIBBOARDGAME_TEST_CASE(util_thread_pool_reserve_max)
+{
+    ThreadPool pool;
+    unsigned max_workers = ThreadPool::max_workers;
+    pool.reserve(max_workers + 10);
+    LIBBOARDGAME_CHECK_EQUAL(max_workers, pool.get_nu_workers());
+    atomic<unsigned> count(0);
+    ThreadPool::TaskGroup group;
+    for (unsigned i = 0; i < max_workers + 10; ++i)
+        pool.submit(group, [&] { ++count; });
+    pool.wait(group);
+    LIBBOARDGAME_CHECK_EQUAL(max_workers + 10, count.load());
+}
+
+/** Check that wait() runs the queued tasks of its group if all workers are
+    busy with tasks of another group. */
+LIBBOARDGAME_TEST_CASE(util_thread_pool_wait_runs_tasks)
+{
+    ThreadPool pool;
+    pool.reserve(1);
+    atomic<bool> started(false);
+    atomic<bool> release(false);
+    ThreadPool::TaskGroup group1;
+    pool.submit(group1, [&] {
+        started = true;
+        while (! release)
+            this_thread::yield();
+    });
+    while (! started)
+        this_thread::yield();
+    ThreadPool::TaskGroup group2;
+    bool done = false;
+    pool.submit(group2, [&] { done = true; });
+    pool.wait(group2);
+    LIBBOARDGAME_CHECK(done);
+    release = true;
+    pool.wait(group1);
+}
+
+/** Check that reserve() never reduces the number of workers. */
+LIBBOARDGAME_TEST_CASE(util_thread_pool_reserve)
+{
+    ThreadPool pool;
+    LIBBOARDGAME_CHECK_EQUAL(0u, pool.get_nu_workers());
+    pool.reserve(2);
+    LIBBOARDGAME_CHECK_EQUAL(2u, pool.get_nu_workers());
+    pool.reserve(1);
+    LIBBOARDGAME_CHECK_EQUAL(2u, pool.get_nu_workers());
+}
+
+//-----------------------------------------------------------------------------
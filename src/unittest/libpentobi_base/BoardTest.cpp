@@ -11,10 +11,12 @@
 #include "libpentobi_base/Board.h"
 
 #include "libboardgame_test/Test.h"
+#include "libpentobi_base/BoardUtil.h"
 #include "libpentobi_base/MoveMarker.h"
 
 using namespace std;
 using namespace libpentobi_base;
+using libpentobi_base::boardutil::get_current_position_as_setup;
 
 //-----------------------------------------------------------------------------
 
@@ -127,6 +129,52 @@ LIBBOARDGAME_TEST_CASE(pentobi_base_board_classic_2)
     LIBBOARDGAME_CHECK_EQUAL(bd->get_nu_onboard_pieces(Color(3)), 3u);
 }
 
+/** Check that the bitboards are consistent with the forbidden status and
+    attach points of the points, also after restoring a snapshot.
+    Uses Trigon because the points of a move span up to 3 bitboard words. */
+LIBBOARDGAME_TEST_CASE(pentobi_base_board_forbidden_bits)
+{
+    auto bd = make_unique<Board>(Variant::trigon_2);
+    auto moves = make_unique<MoveList>();
+    auto marker = make_unique<MoveMarker>();
+    auto check = [&] {
+        for (Color c : bd->get_colors())
+        {
+            for (Point p : bd->get_geometry())
+                LIBBOARDGAME_CHECK_EQUAL(bd->get_forbidden_bits(c)[p],
+                                         bd->is_forbidden(p, c));
+            unsigned n = 0;
+            for (Point p : bd->get_attach_points(c))
+                if (! bd->is_forbidden(p, c))
+                    ++n;
+            LIBBOARDGAME_CHECK_EQUAL(bd->get_nu_free_attach_points(c), n);
+            for (Move::IntType i = 1; i < bd->get_board_const().get_range();
+                 ++i)
+            {
+                Move mv(i);
+                bool is_forbidden = false;
+                for (Point p : bd->get_move_points(mv))
+                    is_forbidden = is_forbidden || bd->is_forbidden(p, c);
+                LIBBOARDGAME_CHECK_EQUAL(bd->is_forbidden(c, mv),
+                                         is_forbidden);
+            }
+        }
+    };
+    for (unsigned i = 0; i < 12; ++i)
+    {
+        Color c = bd->get_to_play();
+        bd->gen_moves(c, *marker, *moves);
+        LIBBOARDGAME_CHECK(! moves->empty());
+        bd->play(c, (*moves)[moves->size() / 2]);
+        marker->clear(*moves);
+        if (i == 5)
+            bd->take_snapshot();
+    }
+    check();
+    bd->restore_snapshot();
+    check();
+}
+
 LIBBOARDGAME_TEST_CASE(pentobi_base_board_gen_moves_classic_initial)
 {
     auto bd = make_unique<Board>(Variant::classic);
@@ -162,4 +210,135 @@ LIBBOARDGAME_TEST_CASE(pentobi_base_board_get_place)
     LIBBOARDGAME_CHECK(! isPlaceShared);
 }
 
+/** Test that the hash does not depend on the move order and includes the
+    color to play and the placed pieces. */
+LIBBOARDGAME_TEST_CASE(pentobi_base_board_hash)
+{
+    auto bd1 = make_unique<Board>(Variant::classic_2);
+    play(*bd1, Color(0), "a20,b20,c20,d20,e20");
+    play(*bd1, Color(1), "q20,r20,s20,t20");
+    play(*bd1, Color(0), "f19,g19,h19,i19");
+    play(*bd1, Color(1), "o19,p19");
+    auto bd2 = make_unique<Board>(Variant::classic_2);
+    play(*bd2, Color(0), "f19,g19,h19,i19");
+    play(*bd2, Color(1), "o19,p19");
+    play(*bd2, Color(0), "a20,b20,c20,d20,e20");
+    play(*bd2, Color(1), "q20,r20,s20,t20");
+    LIBBOARDGAME_CHECK_EQUAL(bd1->get_hash(), bd2->get_hash());
+    bd2->set_to_play(Color(3));
+    LIBBOARDGAME_CHECK(bd1->get_hash() != bd2->get_hash());
+    bd2->set_to_play(bd1->get_to_play());
+    LIBBOARDGAME_CHECK_EQUAL(bd1->get_hash(), bd2->get_hash());
+
+    // Same position given as setup
+    Setup setup;
+    get_current_position_as_setup(*bd1, setup);
+    auto bd3 = make_unique<Board>(Variant::classic_2);
+    bd3->init(Variant::classic_2, &setup);
+    LIBBOARDGAME_CHECK_EQUAL(bd1->get_hash(), bd3->get_hash());
+
+    // Same points occupied by different pieces
+    play(*bd1, Color(2), "t1,s1,r1");
+    play(*bd2, Color(2), "t1");
+    play(*bd2, Color(2), "s1,r1");
+    LIBBOARDGAME_CHECK(bd1->get_hash() != bd2->get_hash());
+}
+
+/** Test that undo() restores the same state as playing the moves up to
+    that position on a new board. */
+LIBBOARDGAME_TEST_CASE(pentobi_base_board_undo)
+{
+    auto moves = make_unique<MoveList>();
+    auto marker = make_unique<MoveMarker>();
+    for (auto variant : { Variant::duo, Variant::classic_2, Variant::trigon_2,
+                          Variant::nexos_2, Variant::callisto_2,
+                          Variant::gembloq_2 })
+    {
+        auto bd = make_unique<Board>(variant);
+        auto expected = make_unique<Board>(variant);
+        auto check = [&] {
+            LIBBOARDGAME_CHECK_EQUAL(bd->get_hash(), expected->get_hash());
+            LIBBOARDGAME_CHECK(bd->get_to_play() == expected->get_to_play());
+            LIBBOARDGAME_CHECK_EQUAL(bd->get_nu_moves(),
+                                     expected->get_nu_moves());
+            LIBBOARDGAME_CHECK_EQUAL(bd->get_nu_onboard_pieces(),
+                                     expected->get_nu_onboard_pieces());
+            for (Point p : bd->get_geometry())
+                LIBBOARDGAME_CHECK(bd->get_point_state(p)
+                                   == expected->get_point_state(p));
+            for (Color c : bd->get_colors())
+            {
+                for (Point p : bd->get_geometry())
+                {
+                    LIBBOARDGAME_CHECK_EQUAL(bd->is_forbidden(p, c),
+                                             expected->is_forbidden(p, c));
+                    LIBBOARDGAME_CHECK_EQUAL(bd->get_forbidden_bits(c)[p],
+                                             expected->is_forbidden(p, c));
+                    LIBBOARDGAME_CHECK_EQUAL(bd->is_attach_point(p, c),
+                                             expected->is_attach_point(p, c));
+                }
+                LIBBOARDGAME_CHECK(bd->get_attach_points(c)
+                                   == expected->get_attach_points(c));
+                LIBBOARDGAME_CHECK_EQUAL(
+                            bd->get_nu_free_attach_points(c),
+                            expected->get_nu_free_attach_points(c));
+                LIBBOARDGAME_CHECK(bd->get_pieces_left(c)
+                                   == expected->get_pieces_left(c));
+                LIBBOARDGAME_CHECK_EQUAL(bd->get_nu_onboard_pieces(c),
+                                         expected->get_nu_onboard_pieces(c));
+                LIBBOARDGAME_CHECK_EQUAL(bd->get_points(c),
+                                         expected->get_points(c));
+            }
+        };
+        // Play until the end of the game to include the bonus for
+        // playing all pieces
+        vector<ColorMove> played;
+        unsigned nu_passes = 0;
+        while (nu_passes < bd->get_nu_colors())
+        {
+            Color c = bd->get_to_play();
+            bd->gen_moves(c, *marker, *moves);
+            marker->clear(*moves);
+            if (moves->empty())
+            {
+                ++nu_passes;
+                bd->set_to_play(bd->get_next(c));
+                continue;
+            }
+            nu_passes = 0;
+            Move mv = (*moves)[(7 * played.size()) % moves->size()];
+            bd->play_undoable(c, mv);
+            played.push_back(ColorMove(c, mv));
+        }
+        LIBBOARDGAME_CHECK_EQUAL(bd->get_nu_undoable(), played.size());
+        while (! played.empty())
+        {
+            bd->undo();
+            Color c = played.back().color;
+            played.pop_back();
+            expected->init();
+            for (auto& mv : played)
+                expected->play(mv);
+            expected->set_to_play(c);
+            check();
+        }
+    }
+}
+
+/** Test that play() discards the undo information of moves played before
+    with play_undoable(). */
+LIBBOARDGAME_TEST_CASE(pentobi_base_board_play_discards_undo)
+{
+    auto bd = make_unique<Board>(Variant::duo);
+    bd->play_undoable(Color(0), bd->from_string("e10,d11,e11,f11,e12"));
+    LIBBOARDGAME_CHECK_EQUAL(bd->get_nu_undoable(), 1u);
+    play(*bd, Color(1), "j5,i6,j6,k6,j7");
+    LIBBOARDGAME_CHECK_EQUAL(bd->get_nu_undoable(), 0u);
+    bd->play_undoable(Color(0), bd->from_string("g7,f8,g8,h8,f9"));
+    LIBBOARDGAME_CHECK_EQUAL(bd->get_nu_undoable(), 1u);
+    bd->undo();
+    LIBBOARDGAME_CHECK_EQUAL(bd->get_nu_moves(), 2u);
+    LIBBOARDGAME_CHECK(bd->get_to_play() == Color(0));
+}
+
 //-----------------------------------------------------------------------------
@@ -0,0 +1,96 @@
+//-----------------------------------------------------------------------------
+/** @file unittest/libpentobi_base/BookTest.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "libboardgame_test/Test.h"
+#include "libpentobi_base/BoardUtil.h"
+#include "libpentobi_base/Book.h"
+
+using namespace std;
+using namespace libpentobi_base;
+using libboardgame_base::PointTransfRot270Refl;
+using boardutil::get_transformed;
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+/** Duo book with one good reply and one move without annotation. */
+const char* book_duo =
+        "(;GM[Blokus Duo];B[f9,e10,f10,g10,f11]TE[1]"
+        "(;W[i4,h5,i5,j5,i6]TE[1])(;W[j4,j5,j6,j7,j8]))";
+
+void check_book_duo(Book& book)
+{
+    LIBBOARDGAME_CHECK(book.get_variant() == Variant::duo);
+    auto bd = make_unique<Board>(Variant::duo);
+    Color black(0);
+    Color white(1);
+    auto mv = bd->from_string("f9,e10,f10,g10,f11");
+    LIBBOARDGAME_CHECK(book.genmove(*bd, black) == mv);
+    LIBBOARDGAME_CHECK(book.genmove(*bd, white).is_null());
+    bd->play(black, mv);
+    LIBBOARDGAME_CHECK(book.genmove(*bd, white)
+                       == bd->from_string("i4,h5,i5,j5,i6"));
+    // Position that is a symmetric to a position in the book
+    PointTransfRot270Refl<Point> transform;
+    bd->init();
+    bd->play(black, get_transformed(*bd, mv, transform));
+    auto reply = bd->from_string("i4,h5,i5,j5,i6");
+    LIBBOARDGAME_CHECK(book.genmove(*bd, white)
+                       == get_transformed(*bd, reply, transform));
+    // Position not in the book
+    bd->play(white, bd->from_string("j4,j5,j6,j7,j8"));
+    LIBBOARDGAME_CHECK(book.genmove(*bd, black).is_null());
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+LIBBOARDGAME_TEST_CASE(pentobi_base_book_compiled)
+{
+    Book book(Variant::duo);
+    istringstream in(book_duo);
+    book.load(in);
+    ostringstream out;
+    book.write_compiled(out);
+    Book compiled_book(Variant::classic);
+    istringstream compiled_in(out.str());
+    compiled_book.load_compiled(compiled_in);
+    check_book_duo(compiled_book);
+}
+
+LIBBOARDGAME_TEST_CASE(pentobi_base_book_compiled_invalid)
+{
+    Book book(Variant::duo);
+    istringstream in(book_duo);
+    book.load(in);
+    ostringstream out;
+    book.write_compiled(out);
+    auto s = out.str();
+    Book compiled_book(Variant::duo);
+    istringstream compiled_in(s);
+    compiled_book.load_compiled(compiled_in);
+    istringstream truncated_in(s.substr(0, s.size() - 1));
+    LIBBOARDGAME_CHECK_THROW(compiled_book.load_compiled(truncated_in),
+                             runtime_error);
+    // The book is unchanged after a failed load
+    check_book_duo(compiled_book);
+}
+
+LIBBOARDGAME_TEST_CASE(pentobi_base_book_genmove)
+{
+    Book book(Variant::duo);
+    istringstream in(book_duo);
+    book.load(in);
+    check_book_duo(book);
+}
+
+//-----------------------------------------------------------------------------
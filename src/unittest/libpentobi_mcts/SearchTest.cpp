@@ -110,4 +110,26 @@ LIBBOARDGAME_TEST_CASE(pentobi_mcts_search_callisto_useless_one_piece)
     LIBBOARDGAME_CHECK(bd->get_move_piece(mv) == bd->get_one_piece());
 }
 
+/** Test that the search for long analysis can be used like the normal
+    search. */
+LIBBOARDGAME_TEST_CASE(pentobi_mcts_search_long)
+{
+    static_assert(is_same<SearchLong::Float, double>::value, "");
+    auto bd = make_unique<Board>(Variant::duo);
+    unsigned nu_threads = 1;
+    size_t memory = 1000000;
+    auto search = make_unique<SearchLong>(bd->get_variant(), nu_threads,
+                                          memory);
+    double max_count = 100;
+    size_t min_simulations = 100;
+    double max_time = 0;
+    CpuTimeSource time_source;
+    Move mv;
+    bool res = search->search(mv, *bd, Color(0), max_count, min_simulations,
+                              max_time, time_source);
+    LIBBOARDGAME_CHECK(res);
+    LIBBOARDGAME_CHECK(! mv.is_null());
+    LIBBOARDGAME_CHECK(search->get_tree().get_root().get_visit_count() >= 100);
+}
+
 //-----------------------------------------------------------------------------
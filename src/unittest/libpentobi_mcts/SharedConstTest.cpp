@@ -0,0 +1,107 @@
+//-----------------------------------------------------------------------------
+/** @file unittest/libpentobi_mcts/SharedConstTest.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "libpentobi_mcts/SharedConst.h"
+
+#include <algorithm>
+#include <vector>
+#include "libboardgame_test/Test.h"
+
+using namespace std;
+using namespace libpentobi_mcts;
+using libpentobi_base::MoveList;
+using libpentobi_base::Piece;
+using libpentobi_base::Variant;
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+void play_moves(Board& bd, unsigned nu_moves, unsigned& n)
+{
+    MoveMarker marker;
+    MoveList moves;
+    for (unsigned i = 0; i < nu_moves; ++i)
+    {
+        Color c = bd.get_to_play();
+        bd.gen_moves(c, marker, moves);
+        marker.clear(moves);
+        if (moves.empty())
+        {
+            bd.set_to_play(bd.get_next(c));
+            continue;
+        }
+        bd.play(c, moves[(7 * n++) % moves.size()]);
+    }
+}
+
+/** Check that the move lists used by State after a series of follow-up
+    initializations contain the same moves as after a new initialization. */
+void check_followup(Variant variant)
+{
+    auto bd = make_unique<Board>(variant);
+    Color to_play;
+    auto shared_const = make_unique<SharedConst>(to_play);
+    auto expected = make_unique<SharedConst>(to_play);
+    shared_const->board = bd.get();
+    expected->board = bd.get();
+    auto& bc = bd->get_board_const();
+    unsigned n = 0;
+    play_moves(*bd, 2 * bd->get_nu_colors(), n);
+    to_play = bd->get_to_play();
+    shared_const->init(false);
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        play_moves(*bd, bd->get_nu_colors(), n);
+        to_play = bd->get_to_play();
+        shared_const->init(true);
+        expected->init(false);
+        for (Color c : bd->get_colors())
+            for (Point p : *bd)
+            {
+                if (! bd->get_point_state(p).is_empty()
+                        || ! bc.has_adj_status_points(p)
+                        || bd->is_forbidden(p, c))
+                    continue;
+                auto adj_status = bd->get_adj_status(p, c);
+                for (Piece::IntType j = 0; j < bc.get_nu_pieces(); ++j)
+                {
+                    Piece piece(j);
+                    if (! bd->is_piece_left(c, piece))
+                        continue;
+                    auto range = shared_const->precomp_moves[c].get_moves(
+                                piece, p, adj_status);
+                    vector<Move> moves(range.begin(), range.end());
+                    range = expected->precomp_moves[c].get_moves(
+                                piece, p, adj_status);
+                    vector<Move> expected_moves(range.begin(), range.end());
+                    sort(moves.begin(), moves.end());
+                    sort(expected_moves.begin(), expected_moves.end());
+                    LIBBOARDGAME_CHECK(moves == expected_moves);
+                }
+            }
+    }
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+LIBBOARDGAME_TEST_CASE(pentobi_mcts_shared_const_followup)
+{
+    check_followup(Variant::duo);
+    check_followup(Variant::classic_2);
+    check_followup(Variant::trigon_2);
+    check_followup(Variant::nexos_2);
+    check_followup(Variant::callisto_2);
+    check_followup(Variant::gembloq_2);
+}
+
+//-----------------------------------------------------------------------------
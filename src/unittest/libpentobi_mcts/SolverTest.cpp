@@ -0,0 +1,154 @@
+//-----------------------------------------------------------------------------
+/** @file unittest/libpentobi_mcts/SolverTest.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "libpentobi_mcts/Solver.h"
+
+#include "libboardgame_test/Test.h"
+
+using namespace std;
+using namespace libpentobi_mcts;
+using libpentobi_base::Variant;
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+/** Number of legal moves of all colors. */
+unsigned count_moves(const Board& bd)
+{
+    MoveMarker marker;
+    MoveList moves;
+    unsigned n = 0;
+    for (Color c : bd.get_colors())
+    {
+        bd.gen_moves(c, marker, moves);
+        marker.clear(moves);
+        n += moves.size();
+    }
+    return n;
+}
+
+/** Minimax search without pruning for checking the solver. */
+ScoreType minimax(const Board& bd, unsigned nu_passes = 0)
+{
+    Color c = bd.get_to_play();
+    MoveMarker marker;
+    MoveList moves;
+    bd.gen_moves(c, marker, moves);
+    Color next = bd.get_next(c);
+    auto sign = (bd.is_same_player(c, next) ? 1 : -1);
+    auto child = make_unique<Board>(bd.get_variant());
+    if (moves.empty())
+    {
+        if (nu_passes + 1u == bd.get_nu_colors())
+            return bd.get_score_twoplayer(c);
+        child->copy_from(bd);
+        child->set_to_play(next);
+        return sign * minimax(*child, nu_passes + 1);
+    }
+    auto best = -numeric_limits<ScoreType>::max();
+    for (Move mv : moves)
+    {
+        child->copy_from(bd);
+        child->play(c, mv);
+        best = max(best, sign * minimax(*child));
+    }
+    return best;
+}
+
+/** Play a game until only a few legal moves are left.
+    The moves are chosen deterministically from the move lists. */
+void play_until_endgame(Board& bd, unsigned max_moves)
+{
+    MoveMarker marker;
+    MoveList moves;
+    unsigned n = 0;
+    while (count_moves(bd) > max_moves)
+    {
+        Color c = bd.get_to_play();
+        bd.gen_moves(c, marker, moves);
+        marker.clear(moves);
+        if (moves.empty())
+        {
+            bd.set_to_play(bd.get_next(c));
+            continue;
+        }
+        bd.play(c, moves[(7 * n++) % moves.size()]);
+    }
+}
+
+void check_solver(Variant variant, unsigned max_moves)
+{
+    auto bd = make_unique<Board>(variant);
+    play_until_endgame(*bd, max_moves);
+    Color c = bd->get_to_play();
+    Solver solver;
+    LIBBOARDGAME_CHECK(solver.is_applicable(*bd));
+    Move mv;
+    ScoreType score;
+    LIBBOARDGAME_CHECK(solver.solve(*bd, c, mv, score));
+    LIBBOARDGAME_CHECK_EQUAL(score, minimax(*bd));
+    if (! bd->has_moves(c))
+    {
+        LIBBOARDGAME_CHECK(mv.is_null());
+        return;
+    }
+    LIBBOARDGAME_CHECK(bd->is_legal(c, mv));
+    auto child = make_unique<Board>(variant);
+    child->copy_from(*bd);
+    child->play(c, mv);
+    auto value = minimax(*child);
+    if (! bd->is_same_player(c, child->get_to_play()))
+        value = -value;
+    LIBBOARDGAME_CHECK_EQUAL(score, value);
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+LIBBOARDGAME_TEST_CASE(pentobi_mcts_solver_classic_2)
+{
+    check_solver(Variant::classic_2, 12);
+}
+
+LIBBOARDGAME_TEST_CASE(pentobi_mcts_solver_duo)
+{
+    check_solver(Variant::duo, 12);
+}
+
+/** Check that the solver respects the node limit. */
+LIBBOARDGAME_TEST_CASE(pentobi_mcts_solver_max_nodes)
+{
+    auto bd = make_unique<Board>(Variant::duo);
+    play_until_endgame(*bd, 30);
+    Solver solver;
+    solver.set_max_nodes(10);
+    Move mv = Move::null();
+    ScoreType score;
+    LIBBOARDGAME_CHECK(! solver.solve(*bd, bd->get_to_play(), mv, score));
+    LIBBOARDGAME_CHECK(mv.is_null());
+    LIBBOARDGAME_CHECK(solver.get_nu_nodes() <= 11);
+}
+
+/** Check that the solver is not used in game variants with more than two
+    players or other piece sets. */
+LIBBOARDGAME_TEST_CASE(pentobi_mcts_solver_not_applicable)
+{
+    Solver solver;
+    auto bd = make_unique<Board>(Variant::classic);
+    play_until_endgame(*bd, 12);
+    LIBBOARDGAME_CHECK(! solver.is_applicable(*bd));
+    bd = make_unique<Board>(Variant::trigon_2);
+    play_until_endgame(*bd, 12);
+    LIBBOARDGAME_CHECK(! solver.is_applicable(*bd));
+}
+
+//-----------------------------------------------------------------------------
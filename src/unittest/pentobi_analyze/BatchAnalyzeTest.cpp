@@ -0,0 +1,171 @@
+//-----------------------------------------------------------------------------
+/** @file unittest/pentobi_analyze/BatchAnalyzeTest.cpp
+    @author Markus Enzenberger
+    @copyright GNU General Public License version 3 or later */
+//-----------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "pentobi_analyze/BatchAnalyze.h"
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include "libboardgame_sgf/SgfIndex.h"
+#include "libboardgame_test/Test.h"
+#include "libboardgame_util/StringUtil.h"
+
+using namespace std;
+using libboardgame_sgf::SgfIndex;
+using libboardgame_util::split;
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+const size_t nu_simulations = 50;
+
+const size_t memory = 20000000;
+
+/** Write a collection with four Duo games with two to four moves. */
+string write_games(const string& file)
+{
+    remove(file.c_str());
+    remove(SgfIndex::get_index_file(file).c_str());
+    ofstream out(file);
+    out << "(;GM[Blokus Duo];B[e10,d11,e11,f11,e12];W[j5,i6,j6,k6,j7]"
+           ";B[g7,f8,g8,h8,f9];W[i8,i9,j9,h10,i10])\n"
+           "(;GM[Blokus Duo];B[d9,c10,d10,e10,d11];W[j5,i6,j6,k6,j7]"
+           ";B[g7,g8,h8,f9,g9])\n"
+           "(;GM[Blokus Duo];B[e10,d11,e11,f11,e12];W[j5,i6,j6,k6,j7])\n"
+           "(;GM[Blokus Duo];B[d9,c10,d10,e10,d11];W[j5,i6,j6,k6,j7]"
+           ";B[g7,g8,h8,f9,g9];W[g5,h5,e6,f6,g6])\n";
+    return file;
+}
+
+void remove_output(const string& file)
+{
+    remove(file.c_str());
+    remove((file + ".checkpoint").c_str());
+    remove(SgfIndex::get_index_file(file).c_str());
+}
+
+vector<string> read_lines(const string& file)
+{
+    ifstream in(file);
+    vector<string> result;
+    string line;
+    while (getline(in, line))
+        result.push_back(line);
+    return result;
+}
+
+void write_lines(const string& file, const vector<string>& lines)
+{
+    ofstream out(file);
+    for (auto& line : lines)
+        out << line << '\n';
+}
+
+/** Count the CSV lines of each game. */
+map<string, unsigned> count_games(const vector<string>& lines)
+{
+    map<string, unsigned> result;
+    for (size_t i = 1; i < lines.size(); ++i)
+        ++result[split(lines[i], ',')[1]];
+    return result;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+/** Analyze a collection with two threads, then continue an interrupted
+    run. */
+LIBBOARDGAME_TEST_CASE(pentobi_analyze_batch_analyze_csv)
+{
+    auto games = write_games("unittest_batch_analyze.blksgf");
+    string output = "unittest_batch_analyze.csv";
+    remove_output(output);
+    {
+        BatchAnalyze analyze(output, BatchAnalyze::Format::csv,
+                             nu_simulations);
+        analyze.add_file(games);
+        analyze.run(2, memory);
+    }
+    auto lines = read_lines(output);
+    LIBBOARDGAME_CHECK_EQUAL(lines.size(), 14u);
+    LIBBOARDGAME_CHECK_EQUAL(lines[0], "File,Game,Move,Color,Points,Value");
+    auto counts = count_games(lines);
+    LIBBOARDGAME_CHECK_EQUAL(counts.size(), 4u);
+    LIBBOARDGAME_CHECK_EQUAL(counts["0"], 4u);
+    LIBBOARDGAME_CHECK_EQUAL(counts["1"], 3u);
+    LIBBOARDGAME_CHECK_EQUAL(counts["2"], 2u);
+    LIBBOARDGAME_CHECK_EQUAL(counts["3"], 4u);
+    LIBBOARDGAME_CHECK_EQUAL(read_lines(output + ".checkpoint").size(), 4u);
+
+    // Simulate a run that was interrupted after the results of the last two
+    // games were written but while recording the first of them in the
+    // checkpoint file
+    auto checkpoint = read_lines(output + ".checkpoint");
+    checkpoint.resize(2);
+    write_lines(output + ".checkpoint", checkpoint);
+    {
+        ofstream out(output + ".checkpoint", ios::app);
+        out << "3\t1";
+    }
+    {
+        BatchAnalyze analyze(output, BatchAnalyze::Format::csv,
+                             nu_simulations);
+        analyze.add_file(games);
+        analyze.run(2, memory);
+    }
+    lines = read_lines(output);
+    LIBBOARDGAME_CHECK_EQUAL(lines.size(), 14u);
+    LIBBOARDGAME_CHECK(count_games(lines) == counts);
+    LIBBOARDGAME_CHECK_EQUAL(read_lines(output + ".checkpoint").size(), 4u);
+
+    // Nothing left to do
+    {
+        BatchAnalyze analyze(output, BatchAnalyze::Format::csv,
+                             nu_simulations);
+        analyze.add_file(games);
+        analyze.run(2, memory);
+    }
+    LIBBOARDGAME_CHECK_EQUAL(read_lines(output).size(), 14u);
+    remove_output(output);
+    remove_output(games);
+}
+
+/** Analyze a collection with three threads and SGF output. */
+LIBBOARDGAME_TEST_CASE(pentobi_analyze_batch_analyze_sgf)
+{
+    auto games = write_games("unittest_batch_analyze_2.blksgf");
+    string output = "unittest_batch_analyze_2_out.blksgf";
+    remove_output(output);
+    {
+        BatchAnalyze analyze(output, BatchAnalyze::Format::sgf,
+                             nu_simulations);
+        analyze.add_file(games);
+        analyze.run(3, memory);
+    }
+    SgfCollection collection;
+    collection.open(output);
+    LIBBOARDGAME_CHECK_EQUAL(collection.get_nu_games(), 4u);
+    unsigned nu_moves = 0;
+    for (size_t i = 0; i < collection.get_nu_games(); ++i)
+        nu_moves += collection.get_entry(i).length;
+    LIBBOARDGAME_CHECK_EQUAL(nu_moves, 13u);
+    unsigned nu_values = 0;
+    for (auto& line : read_lines(output))
+        for (size_t pos = 0;
+             (pos = line.find("C[Value: ", pos)) != string::npos; ++pos)
+            ++nu_values;
+    LIBBOARDGAME_CHECK_EQUAL(nu_values, 13u);
+    remove_output(output);
+    remove_output(games);
+}
+
+//-----------------------------------------------------------------------------